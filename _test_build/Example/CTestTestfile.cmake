@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/Example
+# Build directory: /root/repo/_test_build/Example
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("_1_student_record")
+subdirs("_2_book_store")
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/Example/_1_student_record/StudentRecord.cpp" "Example/_1_student_record/CMakeFiles/StudentRecord.dir/StudentRecord.cpp.o" "gcc" "Example/_1_student_record/CMakeFiles/StudentRecord.dir/StudentRecord.cpp.o.d"
+  "/root/repo/Example/_1_student_record/main.cpp" "Example/_1_student_record/CMakeFiles/StudentRecord.dir/main.cpp.o" "gcc" "Example/_1_student_record/CMakeFiles/StudentRecord.dir/main.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_test_build/src/CMakeFiles/KMTableLib.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
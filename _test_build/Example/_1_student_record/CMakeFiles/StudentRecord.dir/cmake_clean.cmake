@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "/root/repo/Example/_1_student_record/StudentRecord"
+  "/root/repo/Example/_1_student_record/StudentRecord.pdb"
+  "CMakeFiles/StudentRecord.dir/StudentRecord.cpp.o"
+  "CMakeFiles/StudentRecord.dir/StudentRecord.cpp.o.d"
+  "CMakeFiles/StudentRecord.dir/main.cpp.o"
+  "CMakeFiles/StudentRecord.dir/main.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/StudentRecord.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
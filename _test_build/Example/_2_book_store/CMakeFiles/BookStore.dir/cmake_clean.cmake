@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/Example/_2_book_store/BookStore"
+  "/root/repo/Example/_2_book_store/BookStore.pdb"
+  "CMakeFiles/BookStore.dir/main.cpp.o"
+  "CMakeFiles/BookStore.dir/main.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BookStore.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,34 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/AbstractTable.cpp" "src/CMakeFiles/KMTableLib.dir/AbstractTable.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/AbstractTable.cpp.o.d"
+  "/root/repo/src/AbstractView.cpp" "src/CMakeFiles/KMTableLib.dir/AbstractView.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/AbstractView.cpp.o.d"
+  "/root/repo/src/BasicView.cpp" "src/CMakeFiles/KMTableLib.dir/BasicView.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/BasicView.cpp.o.d"
+  "/root/repo/src/Bytecode.cpp" "src/CMakeFiles/KMTableLib.dir/Bytecode.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/Bytecode.cpp.o.d"
+  "/root/repo/src/CSVWriter.cpp" "src/CMakeFiles/KMTableLib.dir/CSVWriter.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/CSVWriter.cpp.o.d"
+  "/root/repo/src/Core.cpp" "src/CMakeFiles/KMTableLib.dir/Core.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/Core.cpp.o.d"
+  "/root/repo/src/ErrorHandler.cpp" "src/CMakeFiles/KMTableLib.dir/ErrorHandler.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/ErrorHandler.cpp.o.d"
+  "/root/repo/src/FunctionStore.cpp" "src/CMakeFiles/KMTableLib.dir/FunctionStore.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/FunctionStore.cpp.o.d"
+  "/root/repo/src/LogMsg.cpp" "src/CMakeFiles/KMTableLib.dir/LogMsg.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/LogMsg.cpp.o.d"
+  "/root/repo/src/Parser2.cpp" "src/CMakeFiles/KMTableLib.dir/Parser2.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/Parser2.cpp.o.d"
+  "/root/repo/src/Printer.cpp" "src/CMakeFiles/KMTableLib.dir/Printer.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/Printer.cpp.o.d"
+  "/root/repo/src/Table.cpp" "src/CMakeFiles/KMTableLib.dir/Table.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/Table.cpp.o.d"
+  "/root/repo/src/TableIO.cpp" "src/CMakeFiles/KMTableLib.dir/TableIO.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/TableIO.cpp.o.d"
+  "/root/repo/src/ThreadPool.cpp" "src/CMakeFiles/KMTableLib.dir/ThreadPool.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/ThreadPool.cpp.o.d"
+  "/root/repo/src/Types.cpp" "src/CMakeFiles/KMTableLib.dir/Types.cpp.o" "gcc" "src/CMakeFiles/KMTableLib.dir/Types.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_test_build/src/functions/CMakeFiles/function.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
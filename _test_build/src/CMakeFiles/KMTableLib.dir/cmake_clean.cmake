@@ -0,0 +1,39 @@
+file(REMOVE_RECURSE
+  "../lib/libKMTableLib.pdb"
+  "../lib/libKMTableLib.so"
+  "CMakeFiles/KMTableLib.dir/AbstractTable.cpp.o"
+  "CMakeFiles/KMTableLib.dir/AbstractTable.cpp.o.d"
+  "CMakeFiles/KMTableLib.dir/AbstractView.cpp.o"
+  "CMakeFiles/KMTableLib.dir/AbstractView.cpp.o.d"
+  "CMakeFiles/KMTableLib.dir/BasicView.cpp.o"
+  "CMakeFiles/KMTableLib.dir/BasicView.cpp.o.d"
+  "CMakeFiles/KMTableLib.dir/Bytecode.cpp.o"
+  "CMakeFiles/KMTableLib.dir/Bytecode.cpp.o.d"
+  "CMakeFiles/KMTableLib.dir/CSVWriter.cpp.o"
+  "CMakeFiles/KMTableLib.dir/CSVWriter.cpp.o.d"
+  "CMakeFiles/KMTableLib.dir/Core.cpp.o"
+  "CMakeFiles/KMTableLib.dir/Core.cpp.o.d"
+  "CMakeFiles/KMTableLib.dir/ErrorHandler.cpp.o"
+  "CMakeFiles/KMTableLib.dir/ErrorHandler.cpp.o.d"
+  "CMakeFiles/KMTableLib.dir/FunctionStore.cpp.o"
+  "CMakeFiles/KMTableLib.dir/FunctionStore.cpp.o.d"
+  "CMakeFiles/KMTableLib.dir/LogMsg.cpp.o"
+  "CMakeFiles/KMTableLib.dir/LogMsg.cpp.o.d"
+  "CMakeFiles/KMTableLib.dir/Parser2.cpp.o"
+  "CMakeFiles/KMTableLib.dir/Parser2.cpp.o.d"
+  "CMakeFiles/KMTableLib.dir/Printer.cpp.o"
+  "CMakeFiles/KMTableLib.dir/Printer.cpp.o.d"
+  "CMakeFiles/KMTableLib.dir/Table.cpp.o"
+  "CMakeFiles/KMTableLib.dir/Table.cpp.o.d"
+  "CMakeFiles/KMTableLib.dir/TableIO.cpp.o"
+  "CMakeFiles/KMTableLib.dir/TableIO.cpp.o.d"
+  "CMakeFiles/KMTableLib.dir/ThreadPool.cpp.o"
+  "CMakeFiles/KMTableLib.dir/ThreadPool.cpp.o.d"
+  "CMakeFiles/KMTableLib.dir/Types.cpp.o"
+  "CMakeFiles/KMTableLib.dir/Types.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/KMTableLib.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
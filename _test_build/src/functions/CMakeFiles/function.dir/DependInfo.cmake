@@ -0,0 +1,25 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/functions/ArithmeticFunctions.cpp" "src/functions/CMakeFiles/function.dir/ArithmeticFunctions.cpp.o" "gcc" "src/functions/CMakeFiles/function.dir/ArithmeticFunctions.cpp.o.d"
+  "/root/repo/src/functions/ComparatorFunctions.cpp" "src/functions/CMakeFiles/function.dir/ComparatorFunctions.cpp.o" "gcc" "src/functions/CMakeFiles/function.dir/ComparatorFunctions.cpp.o.d"
+  "/root/repo/src/functions/DateFunctions.cpp" "src/functions/CMakeFiles/function.dir/DateFunctions.cpp.o" "gcc" "src/functions/CMakeFiles/function.dir/DateFunctions.cpp.o.d"
+  "/root/repo/src/functions/LogicalFunctions.cpp" "src/functions/CMakeFiles/function.dir/LogicalFunctions.cpp.o" "gcc" "src/functions/CMakeFiles/function.dir/LogicalFunctions.cpp.o.d"
+  "/root/repo/src/functions/NativeOps.cpp" "src/functions/CMakeFiles/function.dir/NativeOps.cpp.o" "gcc" "src/functions/CMakeFiles/function.dir/NativeOps.cpp.o.d"
+  "/root/repo/src/functions/StringFunctions.cpp" "src/functions/CMakeFiles/function.dir/StringFunctions.cpp.o" "gcc" "src/functions/CMakeFiles/function.dir/StringFunctions.cpp.o.d"
+  "/root/repo/src/functions/TypeFunctions.cpp" "src/functions/CMakeFiles/function.dir/TypeFunctions.cpp.o" "gcc" "src/functions/CMakeFiles/function.dir/TypeFunctions.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,23 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/function.dir/ArithmeticFunctions.cpp.o"
+  "CMakeFiles/function.dir/ArithmeticFunctions.cpp.o.d"
+  "CMakeFiles/function.dir/ComparatorFunctions.cpp.o"
+  "CMakeFiles/function.dir/ComparatorFunctions.cpp.o.d"
+  "CMakeFiles/function.dir/DateFunctions.cpp.o"
+  "CMakeFiles/function.dir/DateFunctions.cpp.o.d"
+  "CMakeFiles/function.dir/LogicalFunctions.cpp.o"
+  "CMakeFiles/function.dir/LogicalFunctions.cpp.o.d"
+  "CMakeFiles/function.dir/NativeOps.cpp.o"
+  "CMakeFiles/function.dir/NativeOps.cpp.o.d"
+  "CMakeFiles/function.dir/StringFunctions.cpp.o"
+  "CMakeFiles/function.dir/StringFunctions.cpp.o.d"
+  "CMakeFiles/function.dir/TypeFunctions.cpp.o"
+  "CMakeFiles/function.dir/TypeFunctions.cpp.o.d"
+  "libfunction.a"
+  "libfunction.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/function.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,29 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tests/main.cpp" "tests/CMakeFiles/test_table.dir/main.cpp.o" "gcc" "tests/CMakeFiles/test_table.dir/main.cpp.o.d"
+  "/root/repo/tests/test_helper.cpp" "tests/CMakeFiles/test_table.dir/test_helper.cpp.o" "gcc" "tests/CMakeFiles/test_table.dir/test_helper.cpp.o.d"
+  "/root/repo/tests/tst_basicview.cpp" "tests/CMakeFiles/test_table.dir/tst_basicview.cpp.o" "gcc" "tests/CMakeFiles/test_table.dir/tst_basicview.cpp.o.d"
+  "/root/repo/tests/tst_core.cpp" "tests/CMakeFiles/test_table.dir/tst_core.cpp.o" "gcc" "tests/CMakeFiles/test_table.dir/tst_core.cpp.o.d"
+  "/root/repo/tests/tst_csvwriter.cpp" "tests/CMakeFiles/test_table.dir/tst_csvwriter.cpp.o" "gcc" "tests/CMakeFiles/test_table.dir/tst_csvwriter.cpp.o.d"
+  "/root/repo/tests/tst_parser.cpp" "tests/CMakeFiles/test_table.dir/tst_parser.cpp.o" "gcc" "tests/CMakeFiles/test_table.dir/tst_parser.cpp.o.d"
+  "/root/repo/tests/tst_table.cpp" "tests/CMakeFiles/test_table.dir/tst_table.cpp.o" "gcc" "tests/CMakeFiles/test_table.dir/tst_table.cpp.o.d"
+  "/root/repo/tests/tst_tableio.cpp" "tests/CMakeFiles/test_table.dir/tst_tableio.cpp.o" "gcc" "tests/CMakeFiles/test_table.dir/tst_tableio.cpp.o.d"
+  "/usr/src/googletest/googlemock/src/gmock-all.cc" "tests/CMakeFiles/test_table.dir/usr/src/googletest/googlemock/src/gmock-all.cc.o" "gcc" "tests/CMakeFiles/test_table.dir/usr/src/googletest/googlemock/src/gmock-all.cc.o.d"
+  "/usr/src/googletest/googletest/src/gtest-all.cc" "tests/CMakeFiles/test_table.dir/usr/src/googletest/googletest/src/gtest-all.cc.o" "gcc" "tests/CMakeFiles/test_table.dir/usr/src/googletest/googletest/src/gtest-all.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_test_build/src/CMakeFiles/KMTableLib.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
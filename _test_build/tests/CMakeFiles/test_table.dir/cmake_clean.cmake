@@ -0,0 +1,29 @@
+file(REMOVE_RECURSE
+  "../bin/test_table"
+  "../bin/test_table.pdb"
+  "CMakeFiles/test_table.dir/main.cpp.o"
+  "CMakeFiles/test_table.dir/main.cpp.o.d"
+  "CMakeFiles/test_table.dir/test_helper.cpp.o"
+  "CMakeFiles/test_table.dir/test_helper.cpp.o.d"
+  "CMakeFiles/test_table.dir/tst_basicview.cpp.o"
+  "CMakeFiles/test_table.dir/tst_basicview.cpp.o.d"
+  "CMakeFiles/test_table.dir/tst_core.cpp.o"
+  "CMakeFiles/test_table.dir/tst_core.cpp.o.d"
+  "CMakeFiles/test_table.dir/tst_csvwriter.cpp.o"
+  "CMakeFiles/test_table.dir/tst_csvwriter.cpp.o.d"
+  "CMakeFiles/test_table.dir/tst_parser.cpp.o"
+  "CMakeFiles/test_table.dir/tst_parser.cpp.o.d"
+  "CMakeFiles/test_table.dir/tst_table.cpp.o"
+  "CMakeFiles/test_table.dir/tst_table.cpp.o.d"
+  "CMakeFiles/test_table.dir/tst_tableio.cpp.o"
+  "CMakeFiles/test_table.dir/tst_tableio.cpp.o.d"
+  "CMakeFiles/test_table.dir/usr/src/googletest/googlemock/src/gmock-all.cc.o"
+  "CMakeFiles/test_table.dir/usr/src/googletest/googlemock/src/gmock-all.cc.o.d"
+  "CMakeFiles/test_table.dir/usr/src/googletest/googletest/src/gtest-all.cc.o"
+  "CMakeFiles/test_table.dir/usr/src/googletest/googletest/src/gtest-all.cc.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_table.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
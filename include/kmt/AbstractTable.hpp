@@ -38,6 +38,31 @@ namespace km
         DESCENDING ///< descending order
     };
 
+    /**
+     * @brief NullOrder sets where null values are placed when a table or view is sorted.
+     *
+     * It doesn't depend on the sorting order, NullOrder::FIRST keeps nulls at the top in both ascending
+     * and descending order.
+     */
+    enum class NullOrder
+    {
+        FIRST, ///< nulls before all values
+        LAST   ///< nulls after all values
+    };
+
+    /**
+     * @brief SortKey is one column of a composite sort key with its own sorting order.
+     *
+     * @code {.cpp}
+     * view.sortBy({{"region"}, {"date", SortingOrder::DESCENDING}, {"id"}});
+     * @endcode
+     */
+    struct SortKey
+    {
+        std::string column_name;                              ///< name of the column
+        SortingOrder sorting_order = SortingOrder::ASCENDING; ///< order of this column
+    };
+
     using AbstractColumnPtr_ = AbstractColumn *;
     using ConstAbstractColumnPtr_ = const AbstractColumn *;
 
@@ -86,6 +111,18 @@ namespace km
          */
         SortingOrder getSortingOrder() const;
 
+        /**
+         * @brief Returns where nulls are placed while sorting. Default is NullOrder::FIRST.
+         */
+        NullOrder getNullOrder() const;
+
+        /**
+         * @brief Sets where nulls are placed while sorting.
+         *
+         * The default function just sets it, derived classes should sort themselves again if it is changed.
+         */
+        virtual void setNullOrder(NullOrder null_order);
+
         /**
          * @brief Returns all views that is installed on this current table.
          */
@@ -95,7 +132,7 @@ namespace km
          * @brief Get whether sorting is paused.
          * If previously pauseSorting() was called then it is true, false otherwise.
          */
-        bool isSortingPaused();
+        bool isSortingPaused() const;
 
         /**
          * @brief Hints derived classes to pause sorting.
@@ -117,7 +154,7 @@ namespace km
          * @brief Resumes sorting.
          *
          * If sorting was paused by calling pauseSorting() then calling this function will
-         * reset m_no_sorting to false and call the @b virtual sort() function.
+         * reset m_no_sorting to false and call the @b virtual sortPausedRows() function, which calls sort() by default.
          */
         void resumeSorting();
 
@@ -228,6 +265,80 @@ namespace km
          */
         virtual Variant getDataWC(IndexType row_index, IndexType column_index) const = 0;
 
+        /**
+         * @brief Returns whether data at [ @a row_index1 , @a column_index ] is less than data at [ @a row_index2 , @a column_index ].
+         *
+         * It is used for sorting the views. The default implementation compares the Variants returned by getDataWC(), derived
+         * classes should override it to compare the data directly without creating Variants.
+         *
+         * @warning Indices must be valid else it is undefined behaviour.
+         */
+        virtual bool isLess(IndexType row_index1, IndexType row_index2, IndexType column_index) const;
+
+        /**
+         * @brief Fills @a mask with the values of boolean column @a column_index , bit i is value of row i.
+         *
+         * It is used by parse::filter() to select the rows by a boolean column. The default implementation reads
+         * Variants returned by getDataWC(), derived classes should override it to copy the bits directly.
+         *
+         * @warning @a column_index must be valid and must be a DataType::BOOLEAN column else it is undefined behaviour.
+         */
+        virtual void getBooleanMask(IndexType column_index, BitVector &mask) const;
+
+        /**
+         * @brief Returns whether data at [ @a row_index , @a column_index ] is null.
+         *
+         * The default implementation returns false, i.e. table doesn't support nulls.
+         *
+         * @warning Indices must be valid else it is undefined behaviour.
+         */
+        virtual bool isNull(IndexType row_index, IndexType column_index) const;
+
+        /**
+         * @brief Fills @a mask with validity of column @a column_index , bit i is 0 if row i is null.
+         *
+         * If column doesn't have any null, it may return false without touching @a mask , so callers can skip
+         * null checks. Else it returns true. The default implementation calls isNull() for every row.
+         *
+         * @warning @a column_index must be valid else it is undefined behaviour.
+         */
+        virtual bool getValidityMask(IndexType column_index, BitVector &mask) const;
+
+        /**
+         * @brief Fills @a mask with the rows which may satisfy `data_of_column op data`, bit i is for row i.
+         *
+         * It is used by parse::filter() to skip the rows which can't satisfy a simple comparison like
+         * `isGreater($price, 1000)`. A set bit doesn't mean that the row satisfies it but a cleared bit means it
+         * doesn't. If nothing can be skipped, it may return false without touching @a mask , else it returns true.
+         * The default implementation returns false.
+         *
+         * @warning @a column_index must be valid and @a data must have type of the column else it is undefined behaviour.
+         */
+        virtual bool getCandidateMask(IndexType column_index, CompareOp op, const Variant &data, BitVector &mask) const;
+
+        /**
+         * @brief Writes radix key (see toRadixKey()) of column @a column_index of each row of @a row_indices to @a keys .
+         *
+         * It is used to sort big tables and views with radix sort. Keys compare like isLess() and key of a null is
+         * unspecified. It returns the number of bytes used by a key, 0 if the column doesn't support radix keys (strings)
+         * without touching @a keys . The default implementation returns 0.
+         *
+         * @warning @a column_index and @a row_indices must be valid else it is undefined behaviour.
+         */
+        virtual SizeType getRadixKeys(IndexType column_index, const std::vector<IndexType> &row_indices, std::vector<uint64_t> &keys) const;
+
+        /**
+         * @brief Returns the column which stores column @a column_index , @a indices is set to the physical index of
+         * each row in it.
+         *
+         * It is used by compiled formulas to read the data of a row directly as `column->getValue(indices[row])`. The
+         * returned column and @a indices are valid until the table is modified. If table can't give such access, it
+         * returns nullptr and data is read with getDataWC(). The default implementation returns nullptr.
+         *
+         * @warning @a column_index must be valid else it is undefined behaviour.
+         */
+        virtual const AbstractColumn *getPhysicalColumn(IndexType column_index, const std::vector<IndexType> *&indices) const;
+
         /**
          * @brief destructor.
          */
@@ -256,6 +367,25 @@ namespace km
          */
         bool shouldProcessEvent() const;
 
+        /**
+         * @brief Returns true if any event was not notified to dependent views since sorting was paused, because event
+         * processing was paused.
+         */
+        bool hasMissedEvent() const;
+
+        /**
+         * @brief Called by pauseSorting() when sorting gets paused. The default implementation doesn't do anything.
+         */
+        virtual void sortingPaused();
+
+        /**
+         * @brief Sorts the table when sorting is resumed, it is called by resumeSorting() after event processing is resumed.
+         *
+         * Derived classes can override it to sort only the rows inserted while sorting was paused. The default
+         * implementation calls sort().
+         */
+        virtual void sortPausedRows();
+
         /**
          * @brief Pauses event/signal processing (stops notifying dependent views about changes).
          */
@@ -309,6 +439,17 @@ namespace km
          */
         KM_SIGNAL void rowInsertionEvent(IndexType row_index);
 
+        /**
+         * @brief Notifies dependent views that many rows are inserted at once.
+         *
+         * It is the batched version of rowInsertionEvent(), e.g. called by km::Table::insertRows(). @a row_indices are
+         * the indices (in increasing order) of the new rows in the current table after the insertion.
+         *
+         * @note This must be called after all the rows are inserted. If @ref shouldProcessEvent() returns true
+         * then it will call @ref AbstractView::rowsInserted function.
+         */
+        KM_SIGNAL void rowsInsertionEvent(const std::vector<IndexType> &row_indices);
+
         /**
          * @brief Notifies dependent views that a row is dropped.
          *
@@ -320,6 +461,17 @@ namespace km
          */
         KM_SIGNAL void rowDropEvent(IndexType row_index);
 
+        /**
+         * @brief Notifies dependent views that many rows are dropped at once.
+         *
+         * It is the batched version of rowDropEvent(), e.g. called by km::Table::dropRows(). @a row_indices are the
+         * indices (in increasing order) of the dropped rows in the current table before they were dropped.
+         *
+         * @note This must be called after all the rows are dropped. If @ref shouldProcessEvent() returns true
+         * then it will call @ref AbstractView::rowsDropped function.
+         */
+        KM_SIGNAL void rowsDropEvent(const std::vector<IndexType> &row_indices);
+
         /**
          * @brief Notifies dependent views that the whole table is restructured.
          *
@@ -371,10 +523,12 @@ namespace km
         std::string m_name;           ///< name of the table/view.
         std::string m_decorated_name; ///< decorated name.
         SortingOrder m_sorder;        ///< sorting order of table/view.
+        NullOrder m_null_order;       ///< position of nulls while sorting.
 
     private:
         bool m_no_sorting;                             ///< sorting order of the table or view.
         bool m_process_event;                          ///< holds information if event processing is paused.
+        bool m_missed_event;                           ///< true if an event was dropped since sorting was paused.
         std::vector<AbstractView *> m_dependent_views; ///< Views that depends on this table/view
         IndexType m_key_column;                        ///< index of sorting column.
 
@@ -387,8 +541,10 @@ namespace km
         : m_name(table_name),
           m_decorated_name(decorated_name),
           m_sorder(sorting_order),
+          m_null_order(NullOrder::FIRST),
           m_no_sorting(false),
           m_process_event(true),
+          m_missed_event(false),
           m_key_column(0)
     {
         //
@@ -409,6 +565,16 @@ namespace km
         return m_sorder;
     }
 
+    inline NullOrder AbstractTable::getNullOrder() const
+    {
+        return m_null_order;
+    }
+
+    inline void AbstractTable::setNullOrder(NullOrder null_order)
+    {
+        m_null_order = null_order;
+    }
+
     inline const std::string &AbstractTable::getDecoratedName() const
     {
         return m_decorated_name;
@@ -427,6 +593,63 @@ namespace km
         return false;
     }
 
+    inline bool AbstractTable::isLess(IndexType row_index1, IndexType row_index2, IndexType column_index) const
+    {
+        return isLessComparatorFor(getColumnMetaData(column_index).data_type)(getDataWC(row_index1, column_index), getDataWC(row_index2, column_index));
+    }
+
+    inline void AbstractTable::getBooleanMask(IndexType column_index, BitVector &mask) const
+    {
+        const SizeType row_count = rowCount();
+        mask.clear();
+        mask.reserve(row_count);
+        for (IndexType row_index = 0; row_index < row_count; ++row_index)
+            mask.push_back(getDataWC(row_index, column_index).asBoolean());
+    }
+
+    inline bool AbstractTable::isNull([[maybe_unused]] IndexType row_index, [[maybe_unused]] IndexType column_index) const
+    {
+        return false;
+    }
+
+    inline bool AbstractTable::getValidityMask(IndexType column_index, BitVector &mask) const
+    {
+        const SizeType row_count = rowCount();
+        bool has_null = false;
+        for (IndexType row_index = 0; row_index < row_count; ++row_index)
+        {
+            if (isNull(row_index, column_index))
+            {
+                if (!has_null)
+                {
+                    mask.clear();
+                    mask.resize(row_count, true);
+                }
+                has_null = true;
+                mask.set(row_index, false);
+            }
+        }
+        return has_null;
+    }
+
+    inline bool AbstractTable::getCandidateMask([[maybe_unused]] IndexType column_index, [[maybe_unused]] CompareOp op,
+                                                [[maybe_unused]] const Variant &data, [[maybe_unused]] BitVector &mask) const
+    {
+        return false;
+    }
+
+    inline SizeType AbstractTable::getRadixKeys([[maybe_unused]] IndexType column_index, [[maybe_unused]] const std::vector<IndexType> &row_indices,
+                                                [[maybe_unused]] std::vector<uint64_t> &keys) const
+    {
+        return 0;
+    }
+
+    inline const AbstractColumn *AbstractTable::getPhysicalColumn([[maybe_unused]] IndexType column_index,
+                                                                  [[maybe_unused]] const std::vector<IndexType> *&indices) const
+    {
+        return nullptr;
+    }
+
     inline void AbstractTable::setDataWC([[maybe_unused]] IndexType row_index, [[maybe_unused]] IndexType column_index, [[maybe_unused]] const Variant &data)
     {
     }
@@ -436,13 +659,18 @@ namespace km
         return m_dependent_views;
     }
 
-    inline bool AbstractTable::isSortingPaused()
+    inline bool AbstractTable::isSortingPaused() const
     {
         return m_no_sorting;
     }
 
     inline void AbstractTable::pauseSorting()
     {
+        if (!isSortingPaused())
+        {
+            m_missed_event = false;
+            sortingPaused();
+        }
         pauseEventProcessing();
         m_no_sorting = true;
     }
@@ -452,11 +680,20 @@ namespace km
         if (isSortingPaused())
         {
             resumeEventProcessing();
-            sort();
+            sortPausedRows();
             m_no_sorting = false;
         }
     }
 
+    inline void AbstractTable::sortingPaused()
+    {
+    }
+
+    inline void AbstractTable::sortPausedRows()
+    {
+        sort();
+    }
+
     inline void AbstractTable::setDisplayName([[maybe_unused]] const std::string &display_name, [[maybe_unused]] IndexType column_index)
     {
         //
@@ -481,6 +718,11 @@ namespace km
         return m_process_event;
     }
 
+    inline bool AbstractTable::hasMissedEvent() const
+    {
+        return m_missed_event;
+    }
+
     inline void AbstractTable::pauseEventProcessing()
     {
         m_process_event = false;
@@ -503,7 +745,15 @@ namespace km
             m_dependent_views.erase(it);
     }
 
-    void createColumn(AbstractColumnPtr_ &column_ptr, const std::string &column_name, const std::string &display_name, DataType data_type);
+    /**
+     * @brief Creates a column for @a data_type and assigns it to @a column_ptr .
+     *
+     * @a storage selects the column class, if it is not supported for @a data_type then default Column\<Type_\>
+     * is created. If @a data_type is invalid then @a column_ptr is set to nullptr. Column of any storage allocates its
+     * data from @a resource .
+     */
+    void createColumn(AbstractColumnPtr_ &column_ptr, const std::string &column_name, const std::string &display_name, DataType data_type, ColumnStorage storage = ColumnStorage::DEFAULT,
+                      std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
     /**
      * @brief Returns whether @b column_name can be used for column name or not.
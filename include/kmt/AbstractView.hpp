@@ -126,6 +126,15 @@ namespace km
          */
         KM_SLOT virtual void rowInserted(IndexType row_index) = 0;
 
+        /**
+         * @brief Call back function called when many rows are inserted in the source table at once.
+         *
+         * @a row_indices are the indices (in increasing order) of the new rows relative to source table. The default
+         * implementation calls rowInserted() for each of them in that order, derived classes should override it to
+         * update themselves in one pass and notify nested views with a single rowsInsertionEvent().
+         */
+        KM_SLOT virtual void rowsInserted(const std::vector<IndexType> &row_indices);
+
         /**
          * @brief Call back function called when a row is dropped from the source table.
          *
@@ -136,6 +145,16 @@ namespace km
          */
         KM_SLOT virtual void rowDropped(IndexType row_index) = 0;
 
+        /**
+         * @brief Call back function called when many rows are dropped from the source table at once.
+         *
+         * @a row_indices are the indices (in increasing order) of the dropped rows relative to source table before
+         * dropping. The default implementation calls rowDropped() for each of them from the last to the first,
+         * derived classes should override it to update themselves in one pass and notify nested views with a single
+         * rowsDropEvent().
+         */
+        KM_SLOT virtual void rowsDropped(const std::vector<IndexType> &row_indices);
+
         /**
          * @brief Call back function called source table is resorted.
          *
@@ -10,6 +10,7 @@
 
 
 #include "AbstractView.hpp"
+#include "KeyEncoding.hpp"
 
 namespace km
 {
@@ -90,6 +91,13 @@ namespace km
         SizeType columnCount() const override;
         std::optional<Variant> getData(IndexType row_index, IndexType column_index) const override;
         Variant getDataWC(IndexType row_index, IndexType column_index) const override;
+        bool isLess(IndexType row_index1, IndexType row_index2, IndexType column_index) const override;
+        void getBooleanMask(IndexType column_index, BitVector &mask) const override;
+        bool isNull(IndexType row_index, IndexType column_index) const override;
+        bool getValidityMask(IndexType column_index, BitVector &mask) const override;
+        bool getCandidateMask(IndexType column_index, CompareOp op, const Variant &data, BitVector &mask) const override;
+        SizeType getRadixKeys(IndexType column_index, const std::vector<IndexType> &row_indices, std::vector<uint64_t> &keys) const override;
+        void setNullOrder(NullOrder null_order) override;
         std::string getDisplayName(IndexType column_index) const override;
         /**
          * @brief returns insertable position for @a data.
@@ -106,13 +114,31 @@ namespace km
         void sortBy(const std::string &column_name) override;
         void sortBy(const std::string &column_name, SortingOrder s_order) override;
         IndexType mapToLocal(IndexType src_row_index) override;
+
+        /**
+         * @brief Sorts the view by composite key @a keys , each column in its own order.
+         *
+         * First column of @a keys becomes the key column (see getKeyColumn()) and its order becomes the sorting order, rows
+         * with equal data are ordered by the next column and so on. Data of the key columns is encoded once per row (see
+         * appendKeyValue()) so that rows are compared with a memcmp. The keys are kept until the view is sorted by a single
+         * column again. If @a keys is empty, contains a column which is not in the view or contains a column twice then error
+         * message is written to logs and view is not changed.
+         */
+        void sortBy(const std::vector<SortKey> &keys);
+
+        /**
+         * @brief Returns the columns the view is sorted by, key column first.
+         */
+        std::vector<SortKey> getSortKeys() const;
         void refresh() override;
 
     protected:
         // All these  slot functions are implemented from AbstractView.
         KM_SLOT void dataUpdated(IndexType row_index, IndexType column_index, const Variant &old_data) override;
         KM_SLOT void rowInserted(IndexType row_index) override;
+        KM_SLOT void rowsInserted(const std::vector<IndexType> &row_indices) override;
         KM_SLOT void rowDropped(IndexType row_index) override;
+        KM_SLOT void rowsDropped(const std::vector<IndexType> &row_indices) override;
         KM_SLOT void sourceSorted() override;
         KM_SLOT void sourceReversed() override;
         KM_SLOT void columnTransformed(IndexType column_index) override;
@@ -121,11 +147,54 @@ namespace km
 
     private:
         void checkPreConditions(const std::string &view_name, AbstractTable *source_table, const std::string &formula);
-        IndexType mapToLocal(IndexType src_row_index, const Variant &old_data);
+
+        /**
+         * @brief Returns index of source row @a src_row_index in this view, INVALID_INDEX if it isn't in the view.
+         *
+         * The row is searched by its sort keys, if @a src_column_index is valid, @a data is used as its data (null if
+         * @a data is nullptr) like in keyOf().
+         */
+        IndexType mapToLocal(IndexType src_row_index, IndexType src_column_index, const Variant *data) const;
+
+        /**
+         * @brief Compares source rows @a src_row_index1 and @a src_row_index2 by the sort keys, returns negative, zero
+         * or positive like compareKeys().
+         *
+         * If @a src_column_index is valid, @a data is used as data of @a src_row_index2 in it (null if @a data is
+         * nullptr). Columns are compared in the source, so no key is encoded.
+         */
+        int compareRows(IndexType src_row_index1, IndexType src_row_index2, IndexType src_column_index, const Variant *data) const;
+
+        /**
+         * @brief Returns the encoded sort key of source row @a src_row_index .
+         *
+         * If @a src_column_index is valid, @a data is used as its data (null if @a data is nullptr) instead of the
+         * data of the source, like the data before an update.
+         */
+        std::string keyOf(IndexType src_row_index, IndexType src_column_index = INVALID_INDEX, const Variant *data = nullptr) const;
+
+        /**
+         * @brief Sorts the rows by the current sort keys and notifies the dependent views.
+         */
+        void sortRows();
+
+        /**
+         * @brief Returns whether source row @a src_row_index1 comes before @a src_row_index2 in this view.
+         *
+         * Rows are compared by the key column according to sorting order and null order, then by the secondary sort keys.
+         */
+        bool isRowBefore(IndexType src_row_index1, IndexType src_row_index2) const;
+
+        /**
+         * @brief returns insertable position for source row @a src_row_index , it is null aware version of
+         * insertablePosition().
+         */
+        IndexType insertablePositionOf(IndexType src_row_index) const;
 
     private:
         std::vector<IndexType> m_indices;
         std::vector<IndexType> m_selected_columns;
+        std::vector<std::pair<IndexType, SortingOrder>> m_secondary_keys; ///< sort keys after the key column
         parse::TokenContainer m_filtered_token;
         std::string m_exp;
     };
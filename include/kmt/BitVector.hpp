@@ -0,0 +1,242 @@
+/**
+ * @file BitVector.hpp
+ * @author Keshav Sahu
+ * @date May 1st 2022
+ * @brief This file contains BitVector class, a bit packed container of booleans.
+ */
+
+#ifndef KMTABLELIB_KMT_BITVECTOR_HPP
+#define KMTABLELIB_KMT_BITVECTOR_HPP
+
+#include <vector>
+#include <memory_resource>
+#include <cstdint>
+
+#include "Types.hpp"
+
+namespace km
+{
+    /**
+     * @brief BitVector stores booleans packed in 64 bit words.
+     *
+     * Unlike std::vector<bool> it exposes its words, so it can be counted and combined a word at a time.
+     * Bits after size() in the last word are always zero.
+     *
+     * @code {.cpp}
+     * BitVector a(100, true), b(100);
+     * b.set(5, true);
+     * a &= b;             // only bit 5 is set
+     * a.count() == 1;
+     * @endcode
+     */
+    class BitVector
+    {
+    public:
+        using WordType = uint64_t;
+        static constexpr SizeType k_word_bits = 64; ///< number of bits in a word
+
+        /**
+         * @brief Constructs BitVector with @a size bits, each set to @a value . Words are allocated from @a resource .
+         */
+        explicit BitVector(SizeType size = 0, bool value = false, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_words(resource), m_size(0) { resize(size, value); }
+
+        /**
+         * @brief Returns the memory resource which allocates the words.
+         */
+        std::pmr::memory_resource *getMemoryResource() const noexcept { return m_words.get_allocator().resource(); }
+
+        /**
+         * @brief Returns number of bits.
+         */
+        SizeType size() const noexcept { return m_size; }
+
+        /**
+         * @brief Returns true if there are no bits.
+         */
+        bool empty() const noexcept { return m_size == 0; }
+
+        /**
+         * @brief Returns the underlying words, bit i is stored in words()[i / 64] at position i % 64.
+         */
+        const std::pmr::vector<WordType> &words() const noexcept { return m_words; }
+
+        /**
+         * @brief Returns bit at @a index . @a index must be valid else it would be UB.
+         */
+        bool test(IndexType index) const noexcept
+        {
+            return (m_words[index / k_word_bits] >> (index % k_word_bits)) & 1U;
+        }
+
+        /**
+         * @brief Same as test().
+         */
+        bool operator[](IndexType index) const noexcept { return test(index); }
+
+        /**
+         * @brief Sets bit at @a index to @a value . @a index must be valid else it would be UB.
+         */
+        void set(IndexType index, bool value) noexcept
+        {
+            const WordType mask = WordType(1) << (index % k_word_bits);
+            if (value)
+                m_words[index / k_word_bits] |= mask;
+            else
+                m_words[index / k_word_bits] &= ~mask;
+        }
+
+        /**
+         * @brief Appends @a value at the end.
+         */
+        void push_back(bool value)
+        {
+            if (m_size % k_word_bits == 0)
+                m_words.push_back(0);
+            ++m_size;
+            set(m_size - 1, value);
+        }
+
+        /**
+         * @brief Removes last bit, if any.
+         */
+        void pop_back() noexcept
+        {
+            if (m_size == 0)
+                return;
+            set(m_size - 1, false);
+            --m_size;
+            if (m_size % k_word_bits == 0)
+                m_words.pop_back();
+        }
+
+        /**
+         * @brief Resizes to @a size bits, new bits are set to @a value .
+         */
+        void resize(SizeType size, bool value = false)
+        {
+            const SizeType old_size = m_size;
+            m_words.resize(wordsFor(size), 0);
+            m_size = size;
+            if (size > old_size && value)
+            {
+                for (IndexType i = old_size; i < size && i % k_word_bits; ++i)
+                    set(i, true);
+                for (IndexType w = wordsFor(old_size); w < m_words.size(); ++w)
+                    m_words[w] = ~WordType(0);
+            }
+            clearTail();
+        }
+
+        /**
+         * @brief Reserves memory for @a size bits.
+         */
+        void reserve(SizeType size) { m_words.reserve(wordsFor(size)); }
+
+        /**
+         * @brief Removes all bits.
+         */
+        void clear() noexcept
+        {
+            m_words.clear();
+            m_size = 0;
+        }
+
+        /**
+         * @brief Returns number of bits that are set.
+         */
+        SizeType count() const noexcept
+        {
+            SizeType total = 0;
+            for (WordType word : m_words)
+                total += popcount(word);
+            return total;
+        }
+
+        /**
+         * @brief Flips all bits.
+         */
+        BitVector &flip() noexcept
+        {
+            for (WordType &word : m_words)
+                word = ~word;
+            clearTail();
+            return *this;
+        }
+
+        /**
+         * @brief Sets each bit to (this[i] AND other[i]). Both must have the same size.
+         */
+        BitVector &operator&=(const BitVector &other) noexcept
+        {
+            for (IndexType w = 0, size = m_words.size(); w < size; ++w)
+                m_words[w] &= other.m_words[w];
+            return *this;
+        }
+
+        /**
+         * @brief Sets each bit to (this[i] OR other[i]). Both must have the same size.
+         */
+        BitVector &operator|=(const BitVector &other) noexcept
+        {
+            for (IndexType w = 0, size = m_words.size(); w < size; ++w)
+                m_words[w] |= other.m_words[w];
+            return *this;
+        }
+
+        /**
+         * @brief Calls @a fnc(index) for every bit that is set, in increasing order of index.
+         */
+        template <typename Fnc>
+        void forEachSetBit(Fnc fnc) const
+        {
+            for (IndexType w = 0, size = m_words.size(); w < size; ++w)
+            {
+                for (WordType word = m_words[w]; word; word &= word - 1)
+                    fnc(w * k_word_bits + countTrailingZeros(word));
+            }
+        }
+
+        bool operator==(const BitVector &other) const noexcept { return m_size == other.m_size && m_words == other.m_words; }
+        bool operator!=(const BitVector &other) const noexcept { return !(*this == other); }
+
+        /**
+         * @brief Returns number of set bits in @a word .
+         */
+        static SizeType popcount(WordType word) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_popcountll(word);
+#else
+            word = word - ((word >> 1) & 0x5555555555555555ULL);
+            word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+            word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            return (word * 0x0101010101010101ULL) >> 56;
+#endif
+        }
+
+    private:
+        static SizeType wordsFor(SizeType size) noexcept { return (size + k_word_bits - 1) / k_word_bits; }
+
+        // word must not be zero.
+        static SizeType countTrailingZeros(WordType word) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctzll(word);
+#else
+            return popcount((word & (~word + 1)) - 1);
+#endif
+        }
+
+        void clearTail() noexcept
+        {
+            if (m_size % k_word_bits)
+                m_words.back() &= (WordType(1) << (m_size % k_word_bits)) - 1;
+        }
+
+        std::pmr::vector<WordType> m_words;
+        SizeType m_size;
+    };
+}
+
+#endif // KMTABLELIB_KMT_BITVECTOR_HPP
@@ -0,0 +1,158 @@
+/**
+ * @file ChunkedVector.hpp
+ * @author Keshav Sahu
+ * @date May 1st 2022
+ * @brief This file contains ChunkedVector class, a vector stored in fixed size segments.
+ */
+
+#ifndef KMTABLELIB_KMT_CHUNKEDVECTOR_HPP
+#define KMTABLELIB_KMT_CHUNKEDVECTOR_HPP
+
+#include <vector>
+#include <memory_resource>
+#include <utility>
+#include <algorithm>
+
+#include "Types.hpp"
+
+namespace km
+{
+    /**
+     * @brief ChunkedVector stores elements in fixed size segments of 64K elements.
+     *
+     * Growing it only allocates new segments, existing elements are never copied or moved, so addresses
+     * of the elements are stable and there is no reallocation spike for big columns. Each segment is
+     * contiguous, so it can be scanned (or split among threads) one segment at a time.
+     *
+     * Segments are allocated from the memory resource passed to the constructor, it is also passed to the elements
+     * which use a polymorphic allocator (e.g. std::pmr::string).
+     *
+     * @note Elements after size() are kept default constructed.
+     */
+    template <typename Type_>
+    class ChunkedVector
+    {
+    public:
+        static constexpr SizeType k_segment_shift = 16;
+        static constexpr SizeType k_segment_size = SizeType(1) << k_segment_shift; ///< elements per segment
+
+        /**
+         * @brief Constructs an empty ChunkedVector whose segments are allocated from @a resource .
+         */
+        explicit ChunkedVector(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) : m_segments(resource), m_size(0) {}
+
+        /**
+         * @brief Returns the memory resource which allocates the segments.
+         */
+        std::pmr::memory_resource *getMemoryResource() const noexcept { return m_segments.get_allocator().resource(); }
+
+        /**
+         * @brief Returns number of elements.
+         */
+        SizeType size() const noexcept { return m_size; }
+
+        /**
+         * @brief Returns true if there are no elements.
+         */
+        bool empty() const noexcept { return m_size == 0; }
+
+        /**
+         * @brief Returns number of elements that can be stored without allocating a segment.
+         */
+        SizeType capacity() const noexcept { return m_segments.size() * k_segment_size; }
+
+        /**
+         * @brief Returns number of allocated segments.
+         */
+        SizeType segmentCount() const noexcept { return m_segments.size(); }
+
+        /**
+         * @brief Returns pointer to the first element of segment @a segment_index .
+         */
+        const Type_ *segment(IndexType segment_index) const noexcept { return m_segments[segment_index].data(); }
+
+        /**
+         * @brief Returns number of used elements in segment @a segment_index .
+         */
+        SizeType segmentSize(IndexType segment_index) const noexcept
+        {
+            const SizeType begin = segment_index * k_segment_size;
+            return m_size <= begin ? 0 : std::min(k_segment_size, m_size - begin);
+        }
+
+        Type_ &operator[](IndexType index) noexcept
+        {
+            return m_segments[index >> k_segment_shift][index & (k_segment_size - 1)];
+        }
+
+        const Type_ &operator[](IndexType index) const noexcept
+        {
+            return m_segments[index >> k_segment_shift][index & (k_segment_size - 1)];
+        }
+
+        /**
+         * @brief Appends @a value , allocates a new segment if the last one is full.
+         */
+        template <typename T>
+        void push_back(T &&value)
+        {
+            if (m_size == capacity())
+                m_segments.emplace_back(k_segment_size); // segment gets the resource of m_segments
+            (*this)[m_size] = std::forward<T>(value);
+            ++m_size;
+        }
+
+        /**
+         * @brief Removes the last element, if any.
+         */
+        void pop_back()
+        {
+            if (m_size == 0)
+                return;
+            (*this)[--m_size] = Type_();
+        }
+
+        /**
+         * @brief Allocates segments so that @a size elements can be stored.
+         */
+        void reserve(SizeType size)
+        {
+            while (capacity() < size)
+                m_segments.emplace_back(k_segment_size);
+        }
+
+        /**
+         * @brief Resizes to @a size elements, new elements are default constructed.
+         */
+        void resize(SizeType size)
+        {
+            reserve(size);
+            for (IndexType i = size; i < m_size; ++i)
+                (*this)[i] = Type_();
+            m_size = size;
+        }
+
+        /**
+         * @brief Removes all elements and frees the segments.
+         */
+        void clear() noexcept
+        {
+            m_segments.clear();
+            m_size = 0;
+        }
+
+        /**
+         * @brief Frees the segments which are not used by any element.
+         */
+        void shrink_to_fit()
+        {
+            m_segments.resize((m_size + k_segment_size - 1) >> k_segment_shift);
+        }
+
+    private:
+        std::pmr::vector<std::pmr::vector<Type_>> m_segments;
+        SizeType m_size;
+    };
+}
+
+#endif // KMTABLELIB_KMT_CHUNKEDVECTOR_HPP
@@ -9,15 +9,40 @@
 #define KMTABLELIB_KMT_COLUMN_HPP
 
 #include <string>
+#include <string_view>
+#include <cstring>
 #include <vector>
 #include <limits>
+#include <optional>
+#include <memory_resource>
+#include <cmath>
+#include <type_traits>
+#include <algorithm>
 
 #include "Core.hpp"
+#include "BitVector.hpp"
+#include "ChunkedVector.hpp"
+#include "ZoneMap.hpp"
+#include "RadixSort.hpp"
 
 namespace km
 {
     /**
-     * @brief ColumnMetaData is used to encapsulate column name, display name and data_type.
+     * @brief ColumnStorage selects how a column stores its data.
+     *
+     * It is an opt-in hint passed through @ref ColumnMetaData. If a storage is not supported for the
+     * data type of the column then DEFAULT is used.
+     */
+    enum class ColumnStorage : uint8_t
+    {
+        DEFAULT,   ///< one element per row in a std::vector (Column\<Type_\>).
+        DICTIONARY, ///< only for STRING, sorted dictionary of unique strings and one integer code per row (DictionaryColumn).
+        ARENA,      ///< only for STRING, all bytes in one contiguous buffer and an offset/length per row (ArenaStringColumn).
+        CHUNKED     ///< all types except BOOLEAN, fixed size segments of 64K rows with stable addresses (ChunkedColumn\<Type_\>).
+    };
+
+    /**
+     * @brief ColumnMetaData is used to encapsulate column name, display name, data_type and storage.
      *
      */
     struct ColumnMetaData
@@ -25,29 +50,33 @@ namespace km
         std::string column_name;            ///< column name/id used in formula
         std::string display_name;           ///< a description about column
         DataType data_type;                 ///< data type of the column
+        ColumnStorage storage;              ///< storage used by the column
 
         /**
          * @brief Constructor 
          */
-        ColumnMetaData(const std::string &c_name, DataType d_type) : column_name(c_name), data_type(d_type) {}
+        ColumnMetaData(const std::string &c_name, DataType d_type, ColumnStorage c_storage = ColumnStorage::DEFAULT) : column_name(c_name), data_type(d_type), storage(c_storage) {}
         /**
          * @brief Constructor
          */
-        ColumnMetaData(const std::string &c_name, const std::string &d_name, DataType d_type) : column_name(c_name), display_name(d_name), data_type(d_type) {}
+        ColumnMetaData(const std::string &c_name, const std::string &d_name, DataType d_type, ColumnStorage c_storage = ColumnStorage::DEFAULT) : column_name(c_name), display_name(d_name), data_type(d_type), storage(c_storage) {}
     };
 
     class AbstractColumn
     {
     protected:
         ColumnMetaData m_column_data; /// meta information of the column.
+        BitVector m_validity;         /// validity bitmap, bit is 0 for null. Empty until a null is set.
 
     public:
         /**
          * @brief Constructor.
          *
-         * Constructs column with given @a column_name , @a display_name and @a column_datatype. It doesn't validates for column name.
+         * Constructs column with given @a column_name , @a display_name , @a column_datatype and @a storage. It doesn't validates
+         * for column name. Validity bitmap is allocated from @a resource , derived columns allocate their data from it too.
          */
-        AbstractColumn(const std::string &column_name, const std::string &display_name, DataType column_datatype);
+        AbstractColumn(const std::string &column_name, const std::string &display_name, DataType column_datatype, ColumnStorage storage = ColumnStorage::DEFAULT,
+                       std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
         // disable copy and move constructors and assignments
         KM_DISABLE_COPY_MOVE(AbstractColumn)
@@ -77,6 +106,93 @@ namespace km
          */
         const ColumnMetaData &getMetaData() const noexcept;
 
+        /**
+         * @brief Returns true if data at @a index is null.
+         *
+         * A column has no validity bitmap until a null is set, indices not covered by the bitmap are not null.
+         */
+        bool isNull(IndexType index) const noexcept;
+
+        /**
+         * @brief Marks data at @a index as null if @a is_null is true, else as not null.
+         *
+         * Value stored at a null index is kept as it is and should be ignored.
+         */
+        void setNull(IndexType index, bool is_null = true);
+
+        /**
+         * @brief Returns true if column has a validity bitmap, i.e. a null was ever set.
+         *
+         * If it is false then no data is null and null checks can be skipped.
+         */
+        bool hasValidity() const noexcept;
+
+        /**
+         * @brief Returns the validity bitmap, bit i is 0 if data at index i is null.
+         *
+         * It may be smaller than the column, indices after its size are not null.
+         */
+        const BitVector &getValidity() const noexcept;
+
+        /**
+         * @brief Replaces the validity bitmap with @a validity , it is used to set nulls in bulk.
+         */
+        void setValidity(BitVector validity);
+
+        /**
+         * @brief Copies nulls of @a column at @a indices, null at indices[i] becomes null at i.
+         *
+         * It is the validity counterpart of getCompactedColumn().
+         */
+        void copyNulls(const AbstractColumn &column, const std::vector<IndexType> &indices);
+
+        /**
+         * @brief Returns data at @a index or std::nullopt if it is null.
+         */
+        std::optional<Variant> getNullableData(IndexType index) const;
+
+        /**
+         * @brief Sets @a data at @a index, or marks it null if @a data is std::nullopt.
+         *
+         * @throws type of @a data must match the type of column else it may throw std::bad_variant_access.
+         */
+        void setNullableData(const std::optional<Variant> &data, IndexType index);
+
+        /**
+         * @brief Returns number of nulls in block @a block_index of ZoneMapBase::k_block_size indices.
+         *
+         * It is counted from the words of the validity bitmap, so it is always up to date.
+         */
+        SizeType getBlockNullCount(IndexType block_index) const noexcept;
+
+        /**
+         * @brief Finds the blocks which may have data satisfying `data_at_index op data`.
+         *
+         * Bit i of @a blocks is set if block i (indices i * ZoneMapBase::k_block_size onwards) may have such data,
+         * a block which is entirely null is never set. It uses the zone map (per block min/max) of the column and
+         * comparisons are exact (epsilon is not used). Columns without zone map return false and don't touch
+         * @a blocks , which means every block may have such data.
+         *
+         * @throws type of @a data must match the type of column else it may throw std::bad_variant_access.
+         */
+        virtual bool getZoneCandidates(CompareOp op, const Variant &data, BitVector &blocks) const;
+
+        /**
+         * @brief Writes radix key (see toRadixKey()) of the data at each of @a indices to @a keys .
+         *
+         * Keys compare like isLess() and key of a null is unspecified. It returns the number of bytes used by a key,
+         * columns which don't support radix keys (strings) return 0 and don't touch @a keys .
+         */
+        virtual SizeType getRadixKeys(const std::vector<IndexType> &indices, std::vector<uint64_t> &keys) const;
+
+        /**
+         * @brief Returns the memory resource which allocates the data of the column.
+         *
+         * Every column (of any storage) allocates its data, including string characters and the validity bitmap, from
+         * the memory resource passed to its constructor.
+         */
+        std::pmr::memory_resource *getMemoryResource() const noexcept;
+
         /**
          * @brief Sets epsilon if column has type KFloat32 or KFloat64.
          *
@@ -99,6 +215,16 @@ namespace km
 
         virtual AbstractColumn *getSameTypeColumn(const std::string &column_name) const = 0;
 
+        /**
+         * @brief Creates compacted copy of the column.
+         *
+         * Creates a column of the same type (with same name and settings) which contains only the data at
+         * @a indices in the same order, so data at indices[i] is stored at index i. It is used to free the
+         * space of dropped rows. The default implementation copies the data through Variants, derived classes
+         * override it to copy the data directly.
+         */
+        virtual AbstractColumn *getCompactedColumn(const std::vector<IndexType> &indices) const;
+
         /**
          * @brief Resizes the column.
          * If @a size is bigger then current data, then temporary values will be added,
@@ -118,6 +244,35 @@ namespace km
          */
         virtual void setData(const Variant &v, IndexType index) = 0;
 
+        /**
+         * @brief Same as setData() but data of @a v may be moved (e.g. strings), so @a v should not be used after it.
+         *
+         * The default implementation calls setData().
+         */
+        virtual void setMovedData(Variant &&v, IndexType index);
+
+        /**
+         * @brief Moves data at @a from to @a to , data at @a from is unspecified afterwards. Null state is not moved.
+         *
+         * It is used to fill the space of a dropped row with the last row of the column. Both indices must be valid
+         * else it would be UB. The default implementation moves the data through a Variant.
+         */
+        virtual void moveData(IndexType from, IndexType to);
+
+        /**
+         * @brief Prepares the column for setData() from many threads at once, each thread at different indices.
+         *
+         * Returns false if the column doesn't support it (e.g. strings of DictionaryColumn share the dictionary), then
+         * setData() must be called from one thread. If it returns true then endConcurrentWrites() must be called after
+         * the writes, derived data like the zone map is rebuilt there. The default implementation returns false.
+         */
+        virtual bool beginConcurrentWrites();
+
+        /**
+         * @brief Ends the writes started by beginConcurrentWrites().
+         */
+        virtual void endConcurrentWrites();
+
         /**
          * @brief Returns data at index @a index
          *
@@ -130,6 +285,13 @@ namespace km
          */
         virtual void pushData(const Variant &v) = 0;
 
+        /**
+         * @brief Same as pushData() but data of @a v may be moved (e.g. strings), so @a v should not be used after it.
+         *
+         * The default implementation calls pushData().
+         */
+        virtual void pushMovedData(Variant &&v);
+
         /**
          * @brief Removes data from the end of column.
          */
@@ -188,18 +350,176 @@ namespace km
          */
         virtual bool isLessV(IndexType index1, const Variant &data) const = 0;
 
+        /**
+         * @brief Finds all positions in @a indices where data is equal to @a data.
+         *
+         * For every position k in @a indices, if data at index indices[k] is equal to @a data then k is
+         * appended to @a positions. The default implementation calls isEqualV() for every element, derived
+         * classes can override it to compare the data in bulk.
+         *
+         * @throws type of @a data must match the type of column else it may throw std::bad_variant_access.
+         */
+        virtual void findEqualV(const Variant &data, const std::vector<IndexType> &indices, std::vector<IndexType> &positions) const;
+
         /**
          * @brief destructor.
          */
         virtual ~AbstractColumn() = default;
+
+    protected:
+        /**
+         * @brief Clears the bits of @a blocks whose block is entirely null, @a size is size of the column.
+         */
+        void skipNullBlocks(BitVector &blocks, SizeType size) const noexcept;
     };
 
-    inline AbstractColumn::AbstractColumn(const std::string &column_name, const std::string &display_name, DataType column_datatype)
-        : m_column_data({column_name, (display_name.empty() ? column_name : display_name), column_datatype})
+    inline AbstractColumn::AbstractColumn(const std::string &column_name, const std::string &display_name, DataType column_datatype, ColumnStorage storage,
+                                          std::pmr::memory_resource *resource)
+        : m_column_data({column_name, (display_name.empty() ? column_name : display_name), column_datatype, storage}), m_validity(0, false, resource)
     {
         //
     }
 
+    inline void AbstractColumn::findEqualV(const Variant &data, const std::vector<IndexType> &indices, std::vector<IndexType> &positions) const
+    {
+        for (IndexType k = 0, size = indices.size(); k < size; ++k)
+        {
+            if (isEqualV(indices[k], data))
+                positions.push_back(k);
+        }
+    }
+
+    inline AbstractColumn *AbstractColumn::getCompactedColumn(const std::vector<IndexType> &indices) const
+    {
+        AbstractColumn *column = getSameTypeColumn(getName());
+        column->reserve(indices.size());
+        for (IndexType index : indices)
+            column->pushData(getData(index));
+        return column;
+    }
+
+    inline bool AbstractColumn::isNull(IndexType index) const noexcept
+    {
+        return index < m_validity.size() && !m_validity.test(index);
+    }
+
+    inline void AbstractColumn::setNull(IndexType index, bool is_null)
+    {
+        if (index < m_validity.size())
+            m_validity.set(index, !is_null);
+        else if (is_null)
+        {
+            m_validity.resize(index + 1, true);
+            m_validity.set(index, false);
+        }
+    }
+
+    inline bool AbstractColumn::hasValidity() const noexcept
+    {
+        return !m_validity.empty();
+    }
+
+    inline const BitVector &AbstractColumn::getValidity() const noexcept
+    {
+        return m_validity;
+    }
+
+    inline void AbstractColumn::setValidity(BitVector validity)
+    {
+        m_validity = std::move(validity);
+    }
+
+    inline void AbstractColumn::copyNulls(const AbstractColumn &column, const std::vector<IndexType> &indices)
+    {
+        m_validity.clear();
+        if (!column.hasValidity())
+            return;
+        m_validity.resize(indices.size(), true);
+        for (IndexType i = 0, size = indices.size(); i < size; ++i)
+        {
+            if (column.isNull(indices[i]))
+                m_validity.set(i, false);
+        }
+    }
+
+    inline std::optional<Variant> AbstractColumn::getNullableData(IndexType index) const
+    {
+        if (isNull(index))
+            return std::nullopt;
+        return getData(index);
+    }
+
+    inline void AbstractColumn::setNullableData(const std::optional<Variant> &data, IndexType index)
+    {
+        if (data)
+            setData(data.value(), index);
+        setNull(index, !data.has_value());
+    }
+
+    inline SizeType AbstractColumn::getBlockNullCount(IndexType block_index) const noexcept
+    {
+        constexpr SizeType words_per_block = ZoneMapBase::k_block_size / BitVector::k_word_bits;
+        const IndexType begin = block_index * ZoneMapBase::k_block_size;
+        if (begin >= m_validity.size())
+            return 0;
+        const IndexType end = std::min(begin + ZoneMapBase::k_block_size, m_validity.size());
+        SizeType valid_count = 0;
+        const auto &words = m_validity.words();
+        for (IndexType w = block_index * words_per_block, w_end = (end + BitVector::k_word_bits - 1) / BitVector::k_word_bits; w < w_end; ++w)
+            valid_count += BitVector::popcount(words[w]);
+        return (end - begin) - valid_count;
+    }
+
+    inline bool AbstractColumn::getZoneCandidates([[maybe_unused]] CompareOp op, [[maybe_unused]] const Variant &data, [[maybe_unused]] BitVector &blocks) const
+    {
+        return false;
+    }
+
+    inline void AbstractColumn::pushMovedData(Variant &&v)
+    {
+        pushData(v);
+    }
+
+    inline void AbstractColumn::setMovedData(Variant &&v, IndexType index)
+    {
+        setData(v, index);
+    }
+
+    inline void AbstractColumn::moveData(IndexType from, IndexType to)
+    {
+        setMovedData(getData(from), to);
+    }
+
+    inline bool AbstractColumn::beginConcurrentWrites()
+    {
+        return false;
+    }
+
+    inline void AbstractColumn::endConcurrentWrites()
+    {
+    }
+
+    inline SizeType AbstractColumn::getRadixKeys([[maybe_unused]] const std::vector<IndexType> &indices, [[maybe_unused]] std::vector<uint64_t> &keys) const
+    {
+        return 0;
+    }
+
+    inline std::pmr::memory_resource *AbstractColumn::getMemoryResource() const noexcept
+    {
+        return m_validity.getMemoryResource();
+    }
+
+    inline void AbstractColumn::skipNullBlocks(BitVector &blocks, SizeType size) const noexcept
+    {
+        if (!hasValidity())
+            return;
+        blocks.forEachSetBit([this, &blocks, size](IndexType block_index)
+                             {
+                                 const IndexType begin = block_index * ZoneMapBase::k_block_size;
+                                 if (getBlockNullCount(block_index) == std::min(ZoneMapBase::k_block_size, size - begin))
+                                     blocks.set(block_index, false); });
+    }
+
     inline const std::string &AbstractColumn::getName() const noexcept
     {
         return m_column_data.column_name;
@@ -285,6 +605,55 @@ namespace km
         return DataType::DATE_TIME;
     }
 
+    /**
+     * @brief ColumnSpan is a read only, non owning view over the contiguous storage of a column.
+     *
+     * It is returned by Column::getSpan() and refers to the data in the @b physical order of the column
+     * (the order in which rows were stored, not the sorted order of the table). It stays valid until the
+     * column is modified or destructed.
+     */
+    template <typename Type_>
+    class ColumnSpan
+    {
+    public:
+        using value_type = Type_;
+        using const_iterator = const Type_ *;
+
+        /**
+         * @brief Constructor
+         *
+         * Constructs span over @a size elements starting from @a data.
+         */
+        constexpr ColumnSpan(const Type_ *data = nullptr, SizeType size = 0) noexcept : m_data(data), m_size(size) {}
+
+        /**
+         * @brief Returns element at @a index , @a index must be less than size().
+         */
+        constexpr const Type_ &operator[](IndexType index) const noexcept { return m_data[index]; }
+
+        /**
+         * @brief Returns pointer to the first element.
+         */
+        constexpr const Type_ *data() const noexcept { return m_data; }
+
+        /**
+         * @brief Returns number of elements in the span.
+         */
+        constexpr SizeType size() const noexcept { return m_size; }
+
+        /**
+         * @brief Returns true if span has no element.
+         */
+        constexpr bool empty() const noexcept { return m_size == 0; }
+
+        constexpr const_iterator begin() const noexcept { return m_data; }
+        constexpr const_iterator end() const noexcept { return m_data + m_size; }
+
+    private:
+        const Type_ *m_data;
+        SizeType m_size;
+    };
+
     /**
      * @brief This class implements %AbstractColumn class for different
      * data types.
@@ -301,16 +670,24 @@ namespace km
          */
         static_assert(k_is_ktype<Type_>::value, "Type is not supported for column");
 
+        // zone map is kept only for arithmetic types, strings would be copied for every block.
+        static constexpr bool k_has_zone_map = std::is_arithmetic_v<Type_>;
+
     private:
-        std::vector<Type_> m_data_vec;
+        std::pmr::vector<Type_> m_data_vec;
+        ZoneMap<Type_> m_zone_map;
 
     public:
+        using const_reference = const Type_ &;
+
         /**
          * @brief Constructor
          * 
-         * Constructs Column with given @a column_name and @a display_name and type is auto detected.
+         * Constructs Column with given @a column_name and @a display_name and type is auto detected. Data is
+         * allocated from @a resource , it must outlive the column.
          */
-        Column(const std::string &column_name, const std::string &display_name) : AbstractColumn(column_name, display_name, dataTypeFor<Type_>()) {}
+        Column(const std::string &column_name, const std::string &display_name, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : AbstractColumn(column_name, display_name, dataTypeFor<Type_>(), ColumnStorage::DEFAULT, resource), m_data_vec(resource), m_zone_map(resource) {}
 
         KM_DISABLE_COPY_MOVE(Column)
 
@@ -321,14 +698,104 @@ namespace km
         void resize(SizeType size) override
         {
             m_data_vec.resize(size);
+            if constexpr (k_has_zone_map)
+                m_zone_map.rebuild(m_data_vec);
         }
         AbstractColumn *getSameTypeColumn(const std::string &column_name) const override
         {
-            return new Column<Type_>(column_name, getDisplayName());
+            return new Column<Type_>(column_name, getDisplayName(), getMemoryResource());
+        }
+        AbstractColumn *getCompactedColumn(const std::vector<IndexType> &indices) const override
+        {
+            auto column = new Column<Type_>(getName(), getDisplayName(), getMemoryResource());
+            column->m_data_vec.reserve(indices.size());
+            for (IndexType index : indices)
+                column->m_data_vec.push_back(m_data_vec[index]);
+            if constexpr (k_has_zone_map)
+                column->m_zone_map.rebuild(column->m_data_vec);
+            return column;
         }
         void setData(const Variant &data, IndexType index) override
         {
-            m_data_vec[index] = data.as<Type_>();
+            setValue(data.as<Type_>(), index);
+        }
+        void setMovedData(Variant &&data, IndexType index) override
+        {
+            setValue(data.moveAs<Type_>(), index);
+        }
+        void moveData(IndexType from, IndexType to) override
+        {
+            setValue(std::move(m_data_vec[from]), to);
+        }
+        bool beginConcurrentWrites() override
+        {
+            if constexpr (k_has_zone_map)
+                m_zone_map.suspend();
+            return true;
+        }
+        void endConcurrentWrites() override
+        {
+            if constexpr (k_has_zone_map)
+                m_zone_map.rebuild(m_data_vec);
+        }
+
+        /**
+         * @brief Sets @a value at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB.
+         */
+        void setValue(const Type_ &value, IndexType index)
+        {
+            m_data_vec[index] = value;
+            if constexpr (k_has_zone_map)
+                m_zone_map.update(index, m_data_vec[index]);
+        }
+
+        /**
+         * @brief Same as setValue() but @a value is moved.
+         */
+        void setValue(Type_ &&value, IndexType index)
+        {
+            m_data_vec[index] = std::move(value);
+            if constexpr (k_has_zone_map)
+                m_zone_map.update(index, m_data_vec[index]);
+        }
+
+        /**
+         * @brief Returns the zone map (per block min/max) of the column, it is empty for non arithmetic types.
+         */
+        const ZoneMap<Type_> &getZoneMap() const noexcept
+        {
+            return m_zone_map;
+        }
+        bool getZoneCandidates(CompareOp op, const Variant &data, BitVector &blocks) const override
+        {
+            if constexpr (k_has_zone_map)
+            {
+                m_zone_map.getCandidates(op, data.as<Type_>(), blocks);
+                skipNullBlocks(blocks, m_data_vec.size());
+                return true;
+            }
+            else
+                return false;
+        }
+
+        /**
+         * @brief Returns reference to the data at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB.
+         */
+        const_reference getValue(IndexType index) const noexcept
+        {
+            return m_data_vec[index];
+        }
+
+        /**
+         * @brief Returns a span over the underlying storage in physical order.
+         */
+        ColumnSpan<Type_> getSpan() const noexcept
+        {
+            return {m_data_vec.data(), m_data_vec.size()};
         }
 
         Variant getData(IndexType index) const noexcept override
@@ -337,16 +804,46 @@ namespace km
         }
         void pushData(const Variant &data) override
         {
-            m_data_vec.push_back(data.as<Type_>());
+            pushValue(data.as<Type_>());
+        }
+        void pushMovedData(Variant &&data) override
+        {
+            pushValue(data.moveAs<Type_>());
+        }
+
+        /**
+         * @brief Adds @a value at the end of column without creating a Variant.
+         */
+        void pushValue(const Type_ &value)
+        {
+            m_data_vec.push_back(value);
+            if constexpr (k_has_zone_map)
+                m_zone_map.push_back(m_data_vec.back());
+        }
+
+        /**
+         * @brief Same as pushValue() but @a value is moved.
+         */
+        void pushValue(Type_ &&value)
+        {
+            m_data_vec.push_back(std::move(value));
+            if constexpr (k_has_zone_map)
+                m_zone_map.push_back(m_data_vec.back());
         }
         void popData() override
         {
             if (!m_data_vec.empty())
+            {
                 m_data_vec.pop_back();
+                if constexpr (k_has_zone_map)
+                    m_zone_map.pop_back();
+            }
         }
         void createSpace() override
         {
             m_data_vec.emplace_back(Type_());
+            if constexpr (k_has_zone_map)
+                m_zone_map.push_back(m_data_vec.back());
         }
         bool isGreater(IndexType index1, IndexType index2) const noexcept override
         {
@@ -372,26 +869,47 @@ namespace km
         {
             return m_data_vec[index] < data.as<Type_>();
         }
+        SizeType getRadixKeys(const std::vector<IndexType> &indices, std::vector<uint64_t> &keys) const override
+        {
+            if constexpr (k_has_zone_map)
+            {
+                keys.resize(indices.size());
+                for (IndexType k = 0, size = indices.size(); k < size; ++k)
+                    keys[k] = toRadixKey(m_data_vec[indices[k]]);
+                return radixKeyBytes<Type_>();
+            }
+            else
+                return 0;
+        }
+        void findEqualV(const Variant &data, const std::vector<IndexType> &indices, std::vector<IndexType> &positions) const override
+        {
+            const Type_ &value = data.as<Type_>();
+            for (IndexType k = 0, size = indices.size(); k < size; ++k)
+            {
+                if (m_data_vec[indices[k]] == value)
+                    positions.push_back(k);
+            }
+        }
 
         ~Column() override = default;
     };
 
-    /// @cond "false" specialization for KFloat32, added support for epsilon
+    // specialization for KString, strings are std::pmr::string so their characters are allocated from the resource
+    // of the column too. So getValue() returns a view instead of reference to KString.
     template <>
-    class Column<KFloat32> final : public AbstractColumn
+    class Column<KString> final : public AbstractColumn
     {
     private:
-        std::vector<KFloat32> m_data_vec;
-        KFloat32 m_epsilon;
+        std::pmr::vector<std::pmr::string> m_data_vec; // strings get the resource of m_data_vec
 
     public:
-        Column(const std::string &column_name, const std::string &display_name) : AbstractColumn(column_name, display_name, dataTypeFor<KFloat32>()), m_epsilon(std::numeric_limits<KFloat32>::epsilon()) {}
+        using const_reference = std::string_view;
+
+        Column(const std::string &column_name, const std::string &display_name, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : AbstractColumn(column_name, display_name, dataTypeFor<KString>(), ColumnStorage::DEFAULT, resource), m_data_vec(resource) {}
+
+        KM_DISABLE_COPY_MOVE(Column)
 
-        KM_DISABLE_COPY_MOVE(Column);
-        void setEpsilon(const Variant &epsilon) override
-        {
-            m_epsilon = epsilon.asFloat32();
-        }
         void reserve(SizeType size) override
         {
             m_data_vec.reserve(size);
@@ -402,28 +920,239 @@ namespace km
         }
         AbstractColumn *getSameTypeColumn(const std::string &column_name) const override
         {
-            return new Column<KFloat32>(column_name, getDisplayName());
+            return new Column<KString>(column_name, getDisplayName(), getMemoryResource());
         }
-        void setData(const Variant &data, IndexType index) override
+        AbstractColumn *getCompactedColumn(const std::vector<IndexType> &indices) const override
         {
-            m_data_vec[index] = data.asFloat32();
+            auto column = new Column<KString>(getName(), getDisplayName(), getMemoryResource());
+            column->m_data_vec.reserve(indices.size());
+            for (IndexType index : indices)
+                column->m_data_vec.push_back(m_data_vec[index]);
+            return column;
         }
-        Variant getData(IndexType index) const noexcept override
+        void setData(const Variant &data, IndexType index) override
         {
-            return m_data_vec[index];
+            setValue(data.asString(), index);
         }
-        void pushData(const Variant &data) override
+        void moveData(IndexType from, IndexType to) override
         {
-            m_data_vec.push_back(data.asFloat32());
+            m_data_vec[to] = std::move(m_data_vec[from]);
         }
-        void popData() override
+        bool beginConcurrentWrites() override
+        {
+            // setData() allocates the characters, only the global heap can be used from many threads.
+            return getMemoryResource() == std::pmr::new_delete_resource();
+        }
+
+        /**
+         * @brief Sets @a value at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB.
+         */
+        void setValue(std::string_view value, IndexType index)
+        {
+            m_data_vec[index] = value;
+        }
+
+        /**
+         * @brief Returns view of the string at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB. The view is invalidated when data at @a index is changed.
+         */
+        const_reference getValue(IndexType index) const noexcept
+        {
+            return m_data_vec[index];
+        }
+        Variant getData(IndexType index) const noexcept override
+        {
+            return KString(m_data_vec[index]);
+        }
+        void pushData(const Variant &data) override
+        {
+            pushValue(data.asString());
+        }
+
+        /**
+         * @brief Adds @a value at the end of column without creating a Variant.
+         */
+        void pushValue(std::string_view value)
+        {
+            m_data_vec.emplace_back(value);
+        }
+        void popData() override
+        {
+            if (!m_data_vec.empty())
+                m_data_vec.pop_back();
+        }
+        void createSpace() override
+        {
+            m_data_vec.emplace_back();
+        }
+        bool isGreater(IndexType index1, IndexType index2) const noexcept override
+        {
+            return m_data_vec[index1] > m_data_vec[index2];
+        }
+        bool isEqual(IndexType index1, IndexType index2) const noexcept override
+        {
+            return m_data_vec[index1] == m_data_vec[index2];
+        }
+        bool isLess(IndexType index1, IndexType index2) const noexcept override
+        {
+            return m_data_vec[index1] < m_data_vec[index2];
+        }
+        bool isGreaterV(IndexType index, const Variant &data) const override
+        {
+            return getValue(index) > std::string_view(data.asString());
+        }
+        bool isEqualV(IndexType index, const Variant &data) const override
+        {
+            return getValue(index) == std::string_view(data.asString());
+        }
+        bool isLessV(IndexType index, const Variant &data) const override
+        {
+            return getValue(index) < std::string_view(data.asString());
+        }
+        void findEqualV(const Variant &data, const std::vector<IndexType> &indices, std::vector<IndexType> &positions) const override
+        {
+            const std::string_view value = data.asString();
+            for (IndexType k = 0, size = indices.size(); k < size; ++k)
+            {
+                if (getValue(indices[k]) == value)
+                    positions.push_back(k);
+            }
+        }
+
+        ~Column() override = default;
+    };
+
+    /// @cond "false" specialization for KFloat32, added support for epsilon
+    template <>
+    class Column<KFloat32> final : public AbstractColumn
+    {
+    private:
+        std::pmr::vector<KFloat32> m_data_vec;
+        ZoneMap<KFloat32> m_zone_map;
+        KFloat32 m_epsilon;
+
+    public:
+        using const_reference = const KFloat32 &;
+
+        Column(const std::string &column_name, const std::string &display_name, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : AbstractColumn(column_name, display_name, dataTypeFor<KFloat32>(), ColumnStorage::DEFAULT, resource), m_data_vec(resource), m_zone_map(resource), m_epsilon(std::numeric_limits<KFloat32>::epsilon()) {}
+
+        KM_DISABLE_COPY_MOVE(Column);
+        void setEpsilon(const Variant &epsilon) override
+        {
+            m_epsilon = epsilon.asFloat32();
+        }
+        void reserve(SizeType size) override
+        {
+            m_data_vec.reserve(size);
+        }
+        void resize(SizeType size) override
+        {
+            m_data_vec.resize(size);
+            m_zone_map.rebuild(m_data_vec);
+        }
+        AbstractColumn *getSameTypeColumn(const std::string &column_name) const override
+        {
+            return new Column<KFloat32>(column_name, getDisplayName(), getMemoryResource());
+        }
+        AbstractColumn *getCompactedColumn(const std::vector<IndexType> &indices) const override
+        {
+            auto column = new Column<KFloat32>(getName(), getDisplayName(), getMemoryResource());
+            column->m_epsilon = m_epsilon;
+            column->m_data_vec.reserve(indices.size());
+            for (IndexType index : indices)
+                column->m_data_vec.push_back(m_data_vec[index]);
+            column->m_zone_map.rebuild(column->m_data_vec);
+            return column;
+        }
+        void setData(const Variant &data, IndexType index) override
+        {
+            setValue(data.asFloat32(), index);
+        }
+        void moveData(IndexType from, IndexType to) override
+        {
+            setValue(m_data_vec[from], to);
+        }
+        bool beginConcurrentWrites() override
+        {
+            m_zone_map.suspend();
+            return true;
+        }
+        void endConcurrentWrites() override
+        {
+            m_zone_map.rebuild(m_data_vec);
+        }
+
+        /**
+         * @brief Sets @a value at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB.
+         */
+        void setValue(KFloat32 value, IndexType index)
+        {
+            m_data_vec[index] = value;
+            m_zone_map.update(index, value);
+        }
+        const ZoneMap<KFloat32> &getZoneMap() const noexcept
+        {
+            return m_zone_map;
+        }
+        bool getZoneCandidates(CompareOp op, const Variant &data, BitVector &blocks) const override
+        {
+            m_zone_map.getCandidates(op, data.asFloat32(), blocks);
+            skipNullBlocks(blocks, m_data_vec.size());
+            return true;
+        }
+        /**
+         * @brief Returns reference to the data at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB.
+         */
+        const KFloat32 &getValue(IndexType index) const noexcept
+        {
+            return m_data_vec[index];
+        }
+
+        /**
+         * @brief Returns a span over the underlying storage in physical order.
+         */
+        ColumnSpan<KFloat32> getSpan() const noexcept
+        {
+            return {m_data_vec.data(), m_data_vec.size()};
+        }
+
+        Variant getData(IndexType index) const noexcept override
+        {
+            return m_data_vec[index];
+        }
+        void pushData(const Variant &data) override
+        {
+            pushValue(data.asFloat32());
+        }
+
+        /**
+         * @brief Adds @a value at the end of column without creating a Variant.
+         */
+        void pushValue(KFloat32 value)
+        {
+            m_data_vec.push_back(value);
+            m_zone_map.push_back(value);
+        }
+        void popData() override
         {
             if (!m_data_vec.empty())
+            {
                 m_data_vec.pop_back();
+                m_zone_map.pop_back();
+            }
         }
         void createSpace() override
         {
             m_data_vec.emplace_back(KFloat32());
+            m_zone_map.push_back(m_data_vec.back());
         }
         bool isGreater(IndexType index1, IndexType index2) const noexcept override
         {
@@ -449,6 +1178,22 @@ namespace km
         {
             return m_data_vec[index] < data.asFloat32();
         }
+        SizeType getRadixKeys(const std::vector<IndexType> &indices, std::vector<uint64_t> &keys) const override
+        {
+            keys.resize(indices.size());
+            for (IndexType k = 0, size = indices.size(); k < size; ++k)
+                keys[k] = toRadixKey(m_data_vec[indices[k]]);
+            return radixKeyBytes<KFloat32>();
+        }
+        void findEqualV(const Variant &data, const std::vector<IndexType> &indices, std::vector<IndexType> &positions) const override
+        {
+            const auto value = data.asFloat32();
+            for (IndexType k = 0, size = indices.size(); k < size; ++k)
+            {
+                if (std::abs(m_data_vec[indices[k]] - value) < m_epsilon)
+                    positions.push_back(k);
+            }
+        }
         ~Column() override = default;
     };
 
@@ -457,11 +1202,15 @@ namespace km
     class Column<KFloat64> final : public AbstractColumn
     {
     private:
-        std::vector<KFloat64> m_data_vec;
+        std::pmr::vector<KFloat64> m_data_vec;
+        ZoneMap<KFloat64> m_zone_map;
         KFloat64 m_epsilon;
 
     public:
-        Column(const std::string &column_name, const std::string &display_name) : AbstractColumn(column_name, display_name, dataTypeFor<KFloat64>()), m_epsilon(std::numeric_limits<KFloat64>::epsilon()) {}
+        using const_reference = const KFloat64 &;
+
+        Column(const std::string &column_name, const std::string &display_name, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : AbstractColumn(column_name, display_name, dataTypeFor<KFloat64>(), ColumnStorage::DEFAULT, resource), m_data_vec(resource), m_zone_map(resource), m_epsilon(std::numeric_limits<KFloat64>::epsilon()) {}
 
         KM_DISABLE_COPY_MOVE(Column)
 
@@ -476,31 +1225,107 @@ namespace km
         void resize(SizeType size) override
         {
             m_data_vec.resize(size);
+            m_zone_map.rebuild(m_data_vec);
         }
         AbstractColumn *getSameTypeColumn(const std::string &column_name) const override
         {
-            return new Column<KFloat64>(column_name, getDisplayName());
+            return new Column<KFloat64>(column_name, getDisplayName(), getMemoryResource());
+        }
+        AbstractColumn *getCompactedColumn(const std::vector<IndexType> &indices) const override
+        {
+            auto column = new Column<KFloat64>(getName(), getDisplayName(), getMemoryResource());
+            column->m_epsilon = m_epsilon;
+            column->m_data_vec.reserve(indices.size());
+            for (IndexType index : indices)
+                column->m_data_vec.push_back(m_data_vec[index]);
+            column->m_zone_map.rebuild(column->m_data_vec);
+            return column;
         }
         void setData(const Variant &data, IndexType index) override
         {
-            m_data_vec[index] = data.asFloat64();
+            setValue(data.asFloat64(), index);
+        }
+        void moveData(IndexType from, IndexType to) override
+        {
+            setValue(m_data_vec[from], to);
+        }
+        bool beginConcurrentWrites() override
+        {
+            m_zone_map.suspend();
+            return true;
+        }
+        void endConcurrentWrites() override
+        {
+            m_zone_map.rebuild(m_data_vec);
+        }
+
+        /**
+         * @brief Sets @a value at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB.
+         */
+        void setValue(KFloat64 value, IndexType index)
+        {
+            m_data_vec[index] = value;
+            m_zone_map.update(index, value);
+        }
+        const ZoneMap<KFloat64> &getZoneMap() const noexcept
+        {
+            return m_zone_map;
+        }
+        bool getZoneCandidates(CompareOp op, const Variant &data, BitVector &blocks) const override
+        {
+            m_zone_map.getCandidates(op, data.asFloat64(), blocks);
+            skipNullBlocks(blocks, m_data_vec.size());
+            return true;
         }
+        /**
+         * @brief Returns reference to the data at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB.
+         */
+        const KFloat64 &getValue(IndexType index) const noexcept
+        {
+            return m_data_vec[index];
+        }
+
+        /**
+         * @brief Returns a span over the underlying storage in physical order.
+         */
+        ColumnSpan<KFloat64> getSpan() const noexcept
+        {
+            return {m_data_vec.data(), m_data_vec.size()};
+        }
+
         Variant getData(IndexType index) const noexcept override
         {
             return m_data_vec[index];
         }
         void pushData(const Variant &data) override
         {
-            m_data_vec.push_back(data.asFloat64());
+            pushValue(data.asFloat64());
+        }
+
+        /**
+         * @brief Adds @a value at the end of column without creating a Variant.
+         */
+        void pushValue(KFloat64 value)
+        {
+            m_data_vec.push_back(value);
+            m_zone_map.push_back(value);
         }
         void popData() override
         {
             if (!m_data_vec.empty())
+            {
                 m_data_vec.pop_back();
+                m_zone_map.pop_back();
+            }
         }
         void createSpace() override
         {
             m_data_vec.emplace_back(KFloat64());
+            m_zone_map.push_back(m_data_vec.back());
         }
         bool isGreater(IndexType index1, IndexType index2) const noexcept override
         {
@@ -526,8 +1351,1103 @@ namespace km
         {
             return m_data_vec[index] < data.asFloat64();
         }
+        SizeType getRadixKeys(const std::vector<IndexType> &indices, std::vector<uint64_t> &keys) const override
+        {
+            keys.resize(indices.size());
+            for (IndexType k = 0, size = indices.size(); k < size; ++k)
+                keys[k] = toRadixKey(m_data_vec[indices[k]]);
+            return radixKeyBytes<KFloat64>();
+        }
+        void findEqualV(const Variant &data, const std::vector<IndexType> &indices, std::vector<IndexType> &positions) const override
+        {
+            const auto value = data.asFloat64();
+            for (IndexType k = 0, size = indices.size(); k < size; ++k)
+            {
+                if (std::abs(m_data_vec[indices[k]] - value) < m_epsilon)
+                    positions.push_back(k);
+            }
+        }
         ~Column() override = default;
     };
-    ///@endcond
+
+    // specialization for KBoolean, data is bit packed in BitVector
+    template <>
+    class Column<KBoolean> final : public AbstractColumn
+    {
+    private:
+        BitVector m_bits;
+
+    public:
+        using const_reference = KBoolean;
+
+        Column(const std::string &column_name, const std::string &display_name, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : AbstractColumn(column_name, display_name, dataTypeFor<KBoolean>(), ColumnStorage::DEFAULT, resource), m_bits(0, false, resource) {}
+
+        KM_DISABLE_COPY_MOVE(Column)
+
+        /**
+         * @brief Returns the value at @a index without creating a Variant.
+         */
+        KBoolean getValue(IndexType index) const noexcept
+        {
+            return m_bits.test(index);
+        }
+
+        /**
+         * @brief Returns the underlying bits in physical order (including free rows).
+         */
+        const BitVector &getBits() const noexcept
+        {
+            return m_bits;
+        }
+
+        /**
+         * @brief Returns number of values that are "True" (including free rows).
+         */
+        SizeType count() const noexcept
+        {
+            return m_bits.count();
+        }
+
+        /**
+         * @brief Sets each value to (this AND @a other), a word at a time.
+         *
+         * @a other must have the same size, for columns of same table it means values of the same row.
+         */
+        void andWith(const Column<KBoolean> &other) noexcept
+        {
+            m_bits &= other.m_bits;
+        }
+
+        /**
+         * @brief Sets each value to (this OR @a other), a word at a time.
+         *
+         * @a other must have the same size, for columns of same table it means values of the same row.
+         */
+        void orWith(const Column<KBoolean> &other) noexcept
+        {
+            m_bits |= other.m_bits;
+        }
+
+        /**
+         * @brief Negates all values, a word at a time.
+         */
+        void flip() noexcept
+        {
+            m_bits.flip();
+        }
+
+        void reserve(SizeType size) override
+        {
+            m_bits.reserve(size);
+        }
+        void resize(SizeType size) override
+        {
+            m_bits.resize(size);
+        }
+        AbstractColumn *getSameTypeColumn(const std::string &column_name) const override
+        {
+            return new Column<KBoolean>(column_name, getDisplayName(), getMemoryResource());
+        }
+        AbstractColumn *getCompactedColumn(const std::vector<IndexType> &indices) const override
+        {
+            auto column = new Column<KBoolean>(getName(), getDisplayName(), getMemoryResource());
+            column->m_bits.resize(indices.size());
+            for (IndexType i = 0, size = indices.size(); i < size; ++i)
+                column->m_bits.set(i, m_bits.test(indices[i]));
+            return column;
+        }
+        void setData(const Variant &data, IndexType index) override
+        {
+            setValue(data.asBoolean(), index);
+        }
+        void moveData(IndexType from, IndexType to) override
+        {
+            m_bits.set(to, m_bits.test(from));
+        }
+
+        /**
+         * @brief Sets @a value at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB.
+         */
+        void setValue(KBoolean value, IndexType index)
+        {
+            m_bits.set(index, value);
+        }
+        Variant getData(IndexType index) const noexcept override
+        {
+            return KBoolean(m_bits.test(index));
+        }
+        void pushData(const Variant &data) override
+        {
+            pushValue(data.asBoolean());
+        }
+
+        /**
+         * @brief Adds @a value at the end of column without creating a Variant.
+         */
+        void pushValue(KBoolean value)
+        {
+            m_bits.push_back(value);
+        }
+        void popData() override
+        {
+            m_bits.pop_back();
+        }
+        void createSpace() override
+        {
+            m_bits.push_back(false);
+        }
+        bool isGreater(IndexType index1, IndexType index2) const noexcept override
+        {
+            return m_bits.test(index1) > m_bits.test(index2);
+        }
+        bool isEqual(IndexType index1, IndexType index2) const noexcept override
+        {
+            return m_bits.test(index1) == m_bits.test(index2);
+        }
+        bool isLess(IndexType index1, IndexType index2) const noexcept override
+        {
+            return m_bits.test(index1) < m_bits.test(index2);
+        }
+        bool isGreaterV(IndexType index, const Variant &data) const override
+        {
+            return m_bits.test(index) > data.asBoolean();
+        }
+        bool isEqualV(IndexType index, const Variant &data) const override
+        {
+            return m_bits.test(index) == data.asBoolean();
+        }
+        bool isLessV(IndexType index, const Variant &data) const override
+        {
+            return m_bits.test(index) < data.asBoolean();
+        }
+        SizeType getRadixKeys(const std::vector<IndexType> &indices, std::vector<uint64_t> &keys) const override
+        {
+            keys.resize(indices.size());
+            for (IndexType k = 0, size = indices.size(); k < size; ++k)
+                keys[k] = m_bits.test(indices[k]);
+            return 1;
+        }
+        void findEqualV(const Variant &data, const std::vector<IndexType> &indices, std::vector<IndexType> &positions) const override
+        {
+            const KBoolean value = data.asBoolean();
+            for (IndexType k = 0, size = indices.size(); k < size; ++k)
+            {
+                if (m_bits.test(indices[k]) == value)
+                    positions.push_back(k);
+            }
+        }
+        ~Column() override = default;
+    };
+
+    // base of Column<KDate> and Column<KDateTime>. Data is stored as Key_ integers (toDateKey()/toDateTimeKey()) and
+    // converted to Type_ only in getData/setData/getValue, so comparisons are integer comparisons. Keys are lossless,
+    // invalid dates are kept as they are.
+    template <typename Type_, typename Key_>
+    class DateColumn_ : public AbstractColumn
+    {
+    public:
+        using const_reference = Type_;
+
+        DateColumn_(const std::string &column_name, const std::string &display_name, std::pmr::memory_resource *resource)
+            : AbstractColumn(column_name, display_name, dataTypeFor<Type_>(), ColumnStorage::DEFAULT, resource), m_data_vec(resource), m_zone_map(resource) {}
+
+        KM_DISABLE_COPY_MOVE(DateColumn_)
+
+        /**
+         * @brief Converts @a data to key representation.
+         */
+        static Key_ toKey(const Type_ &data) noexcept
+        {
+            if constexpr (std::is_same_v<Type_, KDate>)
+                return toDateKey(data);
+            else
+                return toDateTimeKey(data);
+        }
+
+        /**
+         * @brief Converts key representation @a data to Type_.
+         */
+        static Type_ fromKey(Key_ data) noexcept
+        {
+            if constexpr (std::is_same_v<Type_, KDate>)
+                return fromDateKey(data);
+            else
+                return fromDateTimeKey(data);
+        }
+
+        /**
+         * @brief Returns the data at @a index , it is converted from the key representation.
+         */
+        Type_ getValue(IndexType index) const noexcept
+        {
+            return fromKey(m_data_vec[index]);
+        }
+
+        /**
+         * @brief Returns the data at @a index as key, see toDateKey() and toDateTimeKey().
+         */
+        Key_ getKeyValue(IndexType index) const noexcept
+        {
+            return m_data_vec[index];
+        }
+
+        /**
+         * @brief Returns a span over the key representation in physical order.
+         */
+        ColumnSpan<Key_> getKeySpan() const noexcept
+        {
+            return {m_data_vec.data(), m_data_vec.size()};
+        }
+
+        void reserve(SizeType size) override
+        {
+            m_data_vec.reserve(size);
+        }
+        void resize(SizeType size) override
+        {
+            m_data_vec.resize(size, toKey(Type_{}));
+            m_zone_map.rebuild(m_data_vec);
+        }
+        AbstractColumn *getSameTypeColumn(const std::string &column_name) const override
+        {
+            return new Column<Type_>(column_name, getDisplayName(), getMemoryResource());
+        }
+        AbstractColumn *getCompactedColumn(const std::vector<IndexType> &indices) const override
+        {
+            Column<Type_> *column = new Column<Type_>(getName(), getDisplayName(), getMemoryResource());
+            DateColumn_ *base = column;
+            base->m_data_vec.reserve(indices.size());
+            for (IndexType index : indices)
+                base->m_data_vec.push_back(m_data_vec[index]);
+            base->m_zone_map.rebuild(base->m_data_vec);
+            return column;
+        }
+        void setData(const Variant &data, IndexType index) override
+        {
+            setValue(data.as<Type_>(), index);
+        }
+        void moveData(IndexType from, IndexType to) override
+        {
+            m_data_vec[to] = m_data_vec[from];
+            m_zone_map.update(to, m_data_vec[to]);
+        }
+        bool beginConcurrentWrites() override
+        {
+            m_zone_map.suspend();
+            return true;
+        }
+        void endConcurrentWrites() override
+        {
+            m_zone_map.rebuild(m_data_vec);
+        }
+
+        /**
+         * @brief Sets @a value at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB.
+         */
+        void setValue(const Type_ &value, IndexType index)
+        {
+            m_data_vec[index] = toKey(value);
+            m_zone_map.update(index, m_data_vec[index]);
+        }
+
+        /**
+         * @brief Returns the zone map (per block min/max) of the key representation.
+         */
+        const ZoneMap<Key_> &getZoneMap() const noexcept
+        {
+            return m_zone_map;
+        }
+        bool getZoneCandidates(CompareOp op, const Variant &data, BitVector &blocks) const override
+        {
+            m_zone_map.getCandidates(op, toKey(data.as<Type_>()), blocks);
+            skipNullBlocks(blocks, m_data_vec.size());
+            return true;
+        }
+        Variant getData(IndexType index) const noexcept override
+        {
+            return fromKey(m_data_vec[index]);
+        }
+        void pushData(const Variant &data) override
+        {
+            pushValue(data.as<Type_>());
+        }
+
+        /**
+         * @brief Adds @a value at the end of column without creating a Variant.
+         */
+        void pushValue(const Type_ &value)
+        {
+            m_data_vec.push_back(toKey(value));
+            m_zone_map.push_back(m_data_vec.back());
+        }
+        void popData() override
+        {
+            if (!m_data_vec.empty())
+            {
+                m_data_vec.pop_back();
+                m_zone_map.pop_back();
+            }
+        }
+        void createSpace() override
+        {
+            m_data_vec.push_back(toKey(Type_{}));
+            m_zone_map.push_back(m_data_vec.back());
+        }
+        bool isGreater(IndexType index1, IndexType index2) const noexcept override
+        {
+            return m_data_vec[index1] > m_data_vec[index2];
+        }
+        bool isEqual(IndexType index1, IndexType index2) const noexcept override
+        {
+            return m_data_vec[index1] == m_data_vec[index2];
+        }
+        bool isLess(IndexType index1, IndexType index2) const noexcept override
+        {
+            return m_data_vec[index1] < m_data_vec[index2];
+        }
+        bool isGreaterV(IndexType index, const Variant &data) const override
+        {
+            return m_data_vec[index] > toKey(data.as<Type_>());
+        }
+        bool isEqualV(IndexType index, const Variant &data) const override
+        {
+            return m_data_vec[index] == toKey(data.as<Type_>());
+        }
+        bool isLessV(IndexType index, const Variant &data) const override
+        {
+            return m_data_vec[index] < toKey(data.as<Type_>());
+        }
+        SizeType getRadixKeys(const std::vector<IndexType> &indices, std::vector<uint64_t> &keys) const override
+        {
+            keys.resize(indices.size());
+            for (IndexType k = 0, size = indices.size(); k < size; ++k)
+                keys[k] = toRadixKey(m_data_vec[indices[k]]);
+            return radixKeyBytes<Key_>();
+        }
+        void findEqualV(const Variant &data, const std::vector<IndexType> &indices, std::vector<IndexType> &positions) const override
+        {
+            const Key_ value = toKey(data.as<Type_>());
+            for (IndexType k = 0, size = indices.size(); k < size; ++k)
+            {
+                if (m_data_vec[indices[k]] == value)
+                    positions.push_back(k);
+            }
+        }
+        ~DateColumn_() override = default;
+
+    private:
+        std::pmr::vector<Key_> m_data_vec;
+        ZoneMap<Key_> m_zone_map;
+    };
+
+    // specialization for KDate, stored as toDateKey().
+    template <>
+    class Column<KDate> final : public DateColumn_<KDate, KInt32>
+    {
+    public:
+        Column(const std::string &column_name, const std::string &display_name, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : DateColumn_(column_name, display_name, resource) {}
+        KM_DISABLE_COPY_MOVE(Column)
+        ~Column() override = default;
+    };
+
+    // specialization for KDateTime, stored as toDateTimeKey().
+    template <>
+    class Column<KDateTime> final : public DateColumn_<KDateTime, KInt64>
+    {
+    public:
+        Column(const std::string &column_name, const std::string &display_name, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : DateColumn_(column_name, display_name, resource) {}
+        KM_DISABLE_COPY_MOVE(Column)
+        ~Column() override = default;
+    };
+    ///@endcond
+
+    /**
+     * @brief DictionaryColumn is a dictionary encoded column for KString.
+     *
+     * It keeps every distinct string once in a dictionary and stores only an integer code per row, so it is
+     * useful for low cardinality data like status, region or category. Codes are given in the order strings are
+     * first seen, so existing codes never change. A separate rank table keeps the sorted position of each code,
+     * so isEqual() compares codes and isLess() and isGreater() compare ranks, all integers. A new string costs
+     * O(log D) to find plus O(D) to update the ranks, where D is the size of the dictionary, rows are not touched.
+     *
+     * It is created by passing ColumnStorage::DICTIONARY in @ref ColumnMetaData for a DataType::STRING column.
+     */
+    class DictionaryColumn final : public AbstractColumn
+    {
+    public:
+        using CodeType = uint32_t;
+
+        /**
+         * @brief Constructor
+         *
+         * Constructs an empty dictionary encoded string column with given @a column_name and @a display_name.
+         */
+        DictionaryColumn(const std::string &column_name, const std::string &display_name, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : AbstractColumn(column_name, display_name, DataType::STRING, ColumnStorage::DICTIONARY, resource), m_dictionary(resource), m_sorted(resource), m_ranks(resource), m_codes(resource) {}
+
+        KM_DISABLE_COPY_MOVE(DictionaryColumn)
+
+        /**
+         * @brief Returns view of the string at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB.
+         */
+        std::string_view getValue(IndexType index) const noexcept
+        {
+            return m_dictionary[m_codes[index]];
+        }
+
+        /**
+         * @brief Returns code of the string at @a index.
+         */
+        CodeType getCode(IndexType index) const noexcept
+        {
+            return m_codes[index];
+        }
+
+        /**
+         * @brief Returns rank of the string at @a index , i.e. its position in the sorted dictionary.
+         */
+        CodeType getRank(IndexType index) const noexcept
+        {
+            return m_ranks[m_codes[index]];
+        }
+
+        /**
+         * @brief Returns the dictionary, code of a string is its index in the dictionary.
+         */
+        const std::pmr::vector<std::pmr::string> &getDictionary() const noexcept
+        {
+            return m_dictionary;
+        }
+
+        /**
+         * @brief Returns code of @a str , or INVALID_INDEX if it is not in the dictionary.
+         */
+        IndexType findCode(std::string_view str) const noexcept
+        {
+            auto it = lowerBound(str);
+            return (it != m_sorted.end() && m_dictionary[*it] == str) ? static_cast<IndexType>(*it) : INVALID_INDEX;
+        }
+
+        void reserve(SizeType size) override
+        {
+            m_codes.reserve(size);
+        }
+        void resize(SizeType size) override
+        {
+            if (size > m_codes.size())
+                m_codes.resize(size, codeFor({}));
+            else
+                m_codes.resize(size);
+        }
+        AbstractColumn *getSameTypeColumn(const std::string &column_name) const override
+        {
+            return new DictionaryColumn(column_name, getDisplayName(), getMemoryResource());
+        }
+        AbstractColumn *getCompactedColumn(const std::vector<IndexType> &indices) const override
+        {
+            // drops the strings which are no longer used and renumbers the codes, kept strings keep their order.
+            constexpr CodeType unused = std::numeric_limits<CodeType>::max();
+            std::vector<CodeType> new_codes(m_dictionary.size(), unused);
+            for (IndexType index : indices)
+                new_codes[m_codes[index]] = 0;
+            auto column = new DictionaryColumn(getName(), getDisplayName(), getMemoryResource());
+            for (CodeType code = 0, size = m_dictionary.size(); code < size; ++code)
+            {
+                if (new_codes[code] != unused)
+                {
+                    new_codes[code] = column->m_dictionary.size();
+                    column->m_dictionary.push_back(m_dictionary[code]);
+                }
+            }
+            column->m_sorted.reserve(column->m_dictionary.size());
+            for (CodeType code : m_sorted)
+            {
+                if (new_codes[code] != unused)
+                    column->m_sorted.push_back(new_codes[code]);
+            }
+            column->m_ranks.resize(column->m_sorted.size());
+            for (CodeType rank = 0, size = column->m_sorted.size(); rank < size; ++rank)
+                column->m_ranks[column->m_sorted[rank]] = rank;
+            column->m_codes.reserve(indices.size());
+            for (IndexType index : indices)
+                column->m_codes.push_back(new_codes[m_codes[index]]);
+            return column;
+        }
+        void setData(const Variant &data, IndexType index) override
+        {
+            setValue(data.asString(), index);
+        }
+        void moveData(IndexType from, IndexType to) override
+        {
+            m_codes[to] = m_codes[from];
+        }
+
+        /**
+         * @brief Sets @a value at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB.
+         */
+        void setValue(std::string_view value, IndexType index)
+        {
+            const CodeType code = codeFor(value);
+            m_codes[index] = code;
+        }
+        Variant getData(IndexType index) const noexcept override
+        {
+            return KString(getValue(index));
+        }
+        void pushData(const Variant &data) override
+        {
+            pushValue(data.asString());
+        }
+
+        /**
+         * @brief Adds @a value at the end of column without creating a Variant.
+         */
+        void pushValue(std::string_view value)
+        {
+            const CodeType code = codeFor(value);
+            m_codes.push_back(code);
+        }
+        void popData() override
+        {
+            if (!m_codes.empty())
+                m_codes.pop_back();
+        }
+        void createSpace() override
+        {
+            const CodeType code = codeFor({});
+            m_codes.push_back(code);
+        }
+        bool isGreater(IndexType index1, IndexType index2) const noexcept override
+        {
+            return getRank(index1) > getRank(index2);
+        }
+        bool isEqual(IndexType index1, IndexType index2) const noexcept override
+        {
+            return m_codes[index1] == m_codes[index2];
+        }
+        bool isLess(IndexType index1, IndexType index2) const noexcept override
+        {
+            return getRank(index1) < getRank(index2);
+        }
+        bool isGreaterV(IndexType index, const Variant &data) const override
+        {
+            return getValue(index) > std::string_view(data.asString());
+        }
+        bool isEqualV(IndexType index, const Variant &data) const override
+        {
+            return getValue(index) == std::string_view(data.asString());
+        }
+        bool isLessV(IndexType index, const Variant &data) const override
+        {
+            return getValue(index) < std::string_view(data.asString());
+        }
+        void findEqualV(const Variant &data, const std::vector<IndexType> &indices, std::vector<IndexType> &positions) const override
+        {
+            const IndexType code = findCode(data.asString()); // resolve once, then compare codes.
+            if (code == INVALID_INDEX)
+                return;
+            for (IndexType k = 0, size = indices.size(); k < size; ++k)
+            {
+                if (m_codes[indices[k]] == code)
+                    positions.push_back(k);
+            }
+        }
+
+        ~DictionaryColumn() override = default;
+
+    private:
+        // returns position in m_sorted of the first string which is not less than str.
+        std::pmr::vector<CodeType>::const_iterator lowerBound(std::string_view str) const noexcept
+        {
+            return std::lower_bound(m_sorted.begin(), m_sorted.end(), str,
+                                    [this](CodeType code, std::string_view value) { return std::string_view(m_dictionary[code]) < value; });
+        }
+
+        // returns code for str, adds it to the dictionary if it doesn't exist.
+        CodeType codeFor(std::string_view str)
+        {
+            auto it = lowerBound(str);
+            if (it != m_sorted.end() && m_dictionary[*it] == str)
+                return *it;
+
+            // new string gets the next code, only ranks of greater strings move.
+            const CodeType code = static_cast<CodeType>(m_dictionary.size());
+            const CodeType rank = static_cast<CodeType>(it - m_sorted.begin());
+            m_dictionary.emplace_back(str);
+            m_sorted.insert(it, code);
+            for (CodeType &r : m_ranks)
+            {
+                if (r >= rank)
+                    ++r;
+            }
+            m_ranks.push_back(rank);
+            return code;
+        }
+
+        std::pmr::vector<std::pmr::string> m_dictionary; // strings in the order they were added, index is the code.
+        std::pmr::vector<CodeType> m_sorted;             // codes in the order of their strings.
+        std::pmr::vector<CodeType> m_ranks;              // position of each code in m_sorted.
+        std::pmr::vector<CodeType> m_codes;
+    };
+
+    /**
+     * @brief ArenaStringColumn stores all strings of a column in one contiguous buffer.
+     *
+     * It is created by passing ColumnStorage::ARENA in @ref ColumnMetaData for a DataType::STRING column.
+     * Every row keeps only offset and length of its string in the arena, so appending a string doesn't
+     * allocate a new string and scanning the column reads contiguous memory. It suits columns with many
+     * unique strings, for few unique strings see @ref DictionaryColumn.
+     *
+     * When a string is overwritten by a longer string, the new string is appended and old bytes become
+     * unused, unused bytes are freed by compact() or when the table frees its space.
+     */
+    class ArenaStringColumn final : public AbstractColumn
+    {
+        struct Slot
+        {
+            SizeType offset; ///< offset of the first byte in arena
+            SizeType length; ///< length of the string
+        };
+
+    public:
+        /**
+         * @brief Constructor
+         *
+         * Constructs an empty arena string column with given @a column_name and @a display_name.
+         */
+        ArenaStringColumn(const std::string &column_name, const std::string &display_name, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : AbstractColumn(column_name, display_name, DataType::STRING, ColumnStorage::ARENA, resource), m_arena(resource), m_slots(resource), m_used_size(0) {}
+
+        KM_DISABLE_COPY_MOVE(ArenaStringColumn)
+
+        /**
+         * @brief Returns view of the string at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB.
+         * @warning The view is invalidated when any data is added or modified in the column.
+         */
+        std::string_view getValue(IndexType index) const noexcept
+        {
+            const Slot &slot = m_slots[index];
+            return {m_arena.data() + slot.offset, slot.length};
+        }
+
+        /**
+         * @brief Appends @a str at the end of the column.
+         */
+        void append(std::string_view str)
+        {
+            m_slots.push_back({m_arena.size(), str.length()});
+            m_arena.insert(m_arena.end(), str.begin(), str.end());
+            m_used_size += str.length();
+        }
+
+        /**
+         * @brief Returns size of the arena in bytes, including unused bytes.
+         */
+        SizeType getArenaSize() const noexcept
+        {
+            return m_arena.size();
+        }
+
+        /**
+         * @brief Returns number of bytes in the arena which are not used by any row.
+         */
+        SizeType getUnusedSize() const noexcept
+        {
+            return m_arena.size() - m_used_size;
+        }
+
+        /**
+         * @brief Rewrites the arena so that it contains only used bytes, in the order of rows.
+         */
+        void compact()
+        {
+            std::pmr::vector<char> arena(m_arena.get_allocator());
+            arena.reserve(m_used_size);
+            for (Slot &slot : m_slots)
+            {
+                const SizeType offset = arena.size();
+                arena.insert(arena.end(), m_arena.begin() + slot.offset, m_arena.begin() + slot.offset + slot.length);
+                slot.offset = offset;
+            }
+            m_arena.swap(arena);
+        }
+
+        void reserve(SizeType size) override
+        {
+            // expect strings of the same average length as already stored.
+            if (!m_slots.empty() && size > m_slots.size())
+                m_arena.reserve(m_arena.size() + (size - m_slots.size()) * (m_used_size / m_slots.size()));
+            m_slots.reserve(size);
+        }
+        void resize(SizeType size) override
+        {
+            for (IndexType i = size; i < m_slots.size(); ++i)
+                m_used_size -= m_slots[i].length;
+            m_slots.resize(size, Slot{m_arena.size(), 0});
+        }
+        AbstractColumn *getSameTypeColumn(const std::string &column_name) const override
+        {
+            return new ArenaStringColumn(column_name, getDisplayName(), getMemoryResource());
+        }
+        AbstractColumn *getCompactedColumn(const std::vector<IndexType> &indices) const override
+        {
+            auto column = new ArenaStringColumn(getName(), getDisplayName(), getMemoryResource());
+            SizeType used_size = 0;
+            for (IndexType index : indices)
+                used_size += m_slots[index].length;
+            column->m_arena.reserve(used_size);
+            column->m_slots.reserve(indices.size());
+            for (IndexType index : indices)
+                column->append(getValue(index));
+            return column;
+        }
+        void setData(const Variant &data, IndexType index) override
+        {
+            setValue(data.asString(), index);
+        }
+        void moveData(IndexType from, IndexType to) override
+        {
+            // bytes are not copied, slot at @a to takes over the bytes of @a from .
+            m_used_size -= m_slots[to].length;
+            m_slots[to] = m_slots[from];
+            m_slots[from].length = 0;
+        }
+
+        /**
+         * @brief Sets @a value at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB.
+         */
+        void setValue(const KString &str, IndexType index)
+        {
+            Slot &slot = m_slots[index];
+            m_used_size = m_used_size - slot.length + str.length();
+            if (str.length() <= slot.length) // fits in old place
+            {
+                std::memcpy(m_arena.data() + slot.offset, str.data(), str.length());
+                slot.length = str.length();
+                return;
+            }
+            slot = {m_arena.size(), str.length()};
+            m_arena.insert(m_arena.end(), str.begin(), str.end());
+            if (getUnusedSize() > m_used_size && getUnusedSize() > k_min_unused_size)
+                compact();
+        }
+        Variant getData(IndexType index) const noexcept override
+        {
+            return KString(getValue(index));
+        }
+        void pushData(const Variant &data) override
+        {
+            pushValue(data.asString());
+        }
+
+        /**
+         * @brief Adds @a value at the end of column without creating a Variant.
+         */
+        void pushValue(const KString &value)
+        {
+            append(value);
+        }
+        void popData() override
+        {
+            if (m_slots.empty())
+                return;
+            const Slot &slot = m_slots.back();
+            m_used_size -= slot.length;
+            if (slot.offset + slot.length == m_arena.size()) // last string in arena, give back its bytes.
+                m_arena.resize(slot.offset);
+            m_slots.pop_back();
+        }
+        void createSpace() override
+        {
+            m_slots.push_back({m_arena.size(), 0});
+        }
+        bool isGreater(IndexType index1, IndexType index2) const noexcept override
+        {
+            return getValue(index1) > getValue(index2);
+        }
+        bool isEqual(IndexType index1, IndexType index2) const noexcept override
+        {
+            return getValue(index1) == getValue(index2);
+        }
+        bool isLess(IndexType index1, IndexType index2) const noexcept override
+        {
+            return getValue(index1) < getValue(index2);
+        }
+        bool isGreaterV(IndexType index, const Variant &data) const override
+        {
+            return getValue(index) > std::string_view(data.asString());
+        }
+        bool isEqualV(IndexType index, const Variant &data) const override
+        {
+            return getValue(index) == std::string_view(data.asString());
+        }
+        bool isLessV(IndexType index, const Variant &data) const override
+        {
+            return getValue(index) < std::string_view(data.asString());
+        }
+        void findEqualV(const Variant &data, const std::vector<IndexType> &indices, std::vector<IndexType> &positions) const override
+        {
+            const std::string_view value = data.asString();
+            for (IndexType k = 0, size = indices.size(); k < size; ++k)
+            {
+                if (getValue(indices[k]) == value)
+                    positions.push_back(k);
+            }
+        }
+
+        ~ArenaStringColumn() override = default;
+
+    private:
+        static constexpr SizeType k_min_unused_size = 4096; ///< setData() compacts only if more bytes than this are unused
+
+        std::pmr::vector<char> m_arena;
+        std::pmr::vector<Slot> m_slots;
+        SizeType m_used_size; ///< bytes used by the rows
+    };
+
+    /**
+     * @brief ChunkedColumn stores data in fixed size segments of 64K rows (see @ref ChunkedVector).
+     *
+     * It is created by passing ColumnStorage::CHUNKED in @ref ColumnMetaData. Appending never copies the
+     * existing data, so there is no reallocation stall or transient double memory while loading big tables,
+     * and addresses of the data are stable. reserve() and resize() allocate whole segments.
+     *
+     * @tparam Type_ is the type of data, any K-type except KBoolean.
+     */
+    template <typename Type_>
+    class ChunkedColumn final : public AbstractColumn
+    {
+        static_assert(k_is_ktype<Type_>::value && !std::is_same_v<Type_, KBoolean>, "Type is not supported for chunked column");
+        static constexpr bool k_is_float = std::is_floating_point_v<Type_>;
+        static constexpr bool k_is_string = std::is_same_v<Type_, KString>;
+
+        // strings are stored as std::pmr::string, so their characters are allocated from the resource of the column.
+        using Stored_ = std::conditional_t<k_is_string, std::pmr::string, Type_>;
+
+    public:
+        using const_reference = std::conditional_t<k_is_string, std::string_view, const Type_ &>;
+
+        /**
+         * @brief Constructor
+         *
+         * Constructs an empty chunked column with given @a column_name and @a display_name and type is auto detected.
+         * Segments are allocated from @a resource .
+         */
+        ChunkedColumn(const std::string &column_name, const std::string &display_name, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : AbstractColumn(column_name, display_name, dataTypeFor<Type_>(), ColumnStorage::CHUNKED, resource), m_data(resource), m_epsilon(epsilonFor()) {}
+
+        KM_DISABLE_COPY_MOVE(ChunkedColumn)
+
+        /**
+         * @brief Returns reference to the data at @a index without creating a Variant.
+         *
+         * The reference stays valid until the data at @a index is removed, for KString it is a view.
+         */
+        const_reference getValue(IndexType index) const noexcept
+        {
+            return m_data[index];
+        }
+
+        /**
+         * @brief Returns number of segments.
+         */
+        SizeType segmentCount() const noexcept
+        {
+            return m_data.segmentCount();
+        }
+
+        /**
+         * @brief Returns a span over segment @a segment_index in physical order.
+         */
+        ColumnSpan<Stored_> getSegment(IndexType segment_index) const noexcept
+        {
+            return {m_data.segment(segment_index), m_data.segmentSize(segment_index)};
+        }
+
+        void setEpsilon(const Variant &epsilon) override
+        {
+            if constexpr (k_is_float)
+                m_epsilon = epsilon.as<Type_>();
+        }
+        void reserve(SizeType size) override
+        {
+            m_data.reserve(size);
+        }
+        void resize(SizeType size) override
+        {
+            m_data.resize(size);
+        }
+        AbstractColumn *getSameTypeColumn(const std::string &column_name) const override
+        {
+            return new ChunkedColumn<Type_>(column_name, getDisplayName(), getMemoryResource());
+        }
+        AbstractColumn *getCompactedColumn(const std::vector<IndexType> &indices) const override
+        {
+            auto column = new ChunkedColumn<Type_>(getName(), getDisplayName(), getMemoryResource());
+            column->m_epsilon = m_epsilon;
+            column->m_data.reserve(indices.size());
+            for (IndexType index : indices)
+                column->m_data.push_back(m_data[index]);
+            return column;
+        }
+        void setData(const Variant &data, IndexType index) override
+        {
+            setValue(data.as<Type_>(), index);
+        }
+        void setMovedData(Variant &&data, IndexType index) override
+        {
+            setValue(data.moveAs<Type_>(), index);
+        }
+        void moveData(IndexType from, IndexType to) override
+        {
+            m_data[to] = std::move(m_data[from]);
+        }
+        bool beginConcurrentWrites() override
+        {
+            // elements are independent, there is no derived data. Strings allocate, only the global heap can be
+            // used from many threads.
+            return !k_is_string || getMemoryResource() == std::pmr::new_delete_resource();
+        }
+
+        /**
+         * @brief Sets @a value at @a index without creating a Variant.
+         *
+         * @a index must be a valid index else it would be UB.
+         */
+        void setValue(const Type_ &value, IndexType index)
+        {
+            m_data[index] = value;
+        }
+
+        /**
+         * @brief Same as setValue() but @a value is moved.
+         */
+        void setValue(Type_ &&value, IndexType index)
+        {
+            m_data[index] = std::move(value);
+        }
+        Variant getData(IndexType index) const noexcept override
+        {
+            return Type_(getValue(index));
+        }
+        void pushData(const Variant &data) override
+        {
+            pushValue(data.as<Type_>());
+        }
+        void pushMovedData(Variant &&data) override
+        {
+            pushValue(data.moveAs<Type_>());
+        }
+
+        /**
+         * @brief Adds @a value at the end of column without creating a Variant.
+         */
+        void pushValue(const Type_ &value)
+        {
+            m_data.push_back(value);
+        }
+
+        /**
+         * @brief Same as pushValue() but @a value is moved.
+         */
+        void pushValue(Type_ &&value)
+        {
+            m_data.push_back(std::move(value));
+        }
+        void popData() override
+        {
+            m_data.pop_back();
+        }
+        void createSpace() override
+        {
+            m_data.push_back(Type_());
+        }
+        bool isGreater(IndexType index1, IndexType index2) const noexcept override
+        {
+            return m_data[index1] > m_data[index2];
+        }
+        bool isEqual(IndexType index1, IndexType index2) const noexcept override
+        {
+            return equals(m_data[index1], m_data[index2]);
+        }
+        bool isLess(IndexType index1, IndexType index2) const noexcept override
+        {
+            return m_data[index1] < m_data[index2];
+        }
+        bool isGreaterV(IndexType index, const Variant &data) const override
+        {
+            return getValue(index) > data.as<Type_>();
+        }
+        bool isEqualV(IndexType index, const Variant &data) const override
+        {
+            return equals(getValue(index), data.as<Type_>());
+        }
+        bool isLessV(IndexType index, const Variant &data) const override
+        {
+            return getValue(index) < data.as<Type_>();
+        }
+        SizeType getRadixKeys(const std::vector<IndexType> &indices, std::vector<uint64_t> &keys) const override
+        {
+            if constexpr (!std::is_same_v<Type_, KString>)
+            {
+                keys.resize(indices.size());
+                for (IndexType k = 0, size = indices.size(); k < size; ++k)
+                    keys[k] = toRadixKey(m_data[indices[k]]);
+                return radixKeyBytes<Type_>();
+            }
+            else
+                return 0;
+        }
+        void findEqualV(const Variant &data, const std::vector<IndexType> &indices, std::vector<IndexType> &positions) const override
+        {
+            const Type_ &value = data.as<Type_>();
+            for (IndexType k = 0, size = indices.size(); k < size; ++k)
+            {
+                if (equals(getValue(indices[k]), value))
+                    positions.push_back(k);
+            }
+        }
+
+        ~ChunkedColumn() override = default;
+
+    private:
+        // epsilon is used only for KFloat32 and KFloat64, same as Column<KFloatXX>.
+        using EpsilonType_ = std::conditional_t<k_is_float, Type_, char>;
+
+        static EpsilonType_ epsilonFor() noexcept
+        {
+            if constexpr (k_is_float)
+                return std::numeric_limits<Type_>::epsilon();
+            else
+                return 0;
+        }
+
+        template <typename Lhs_, typename Rhs_>
+        bool equals(const Lhs_ &data1, const Rhs_ &data2) const noexcept
+        {
+            if constexpr (k_is_float)
+                return std::abs(data1 - data2) < m_epsilon;
+            else
+                return data1 == data2;
+        }
+
+        ChunkedVector<Stored_> m_data;
+        EpsilonType_ m_epsilon;
+    };
 }
 #endif // KMTABLELIB_KMT_COLUMN_HPP
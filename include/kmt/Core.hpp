@@ -241,6 +241,17 @@ namespace km
             return std::get<Type_>(m_data);
         }
 
+        /**
+         * @brief Returns rvalue reference to @b Type_ to the underlying data, so it can be moved out of the variant.
+         *
+         * @exception May throw std::bad_variant_access exception if variant holds different type.
+         */
+        template <class Type_>
+        Type_ &&moveAs()
+        {
+            return std::get<Type_>(std::move(m_data));
+        }
+
         /**
          * @brief Returns const reference to Kint32 to the underlying data.
          * 
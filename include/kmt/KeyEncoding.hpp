@@ -0,0 +1,101 @@
+/**
+ * @file KeyEncoding.hpp
+ * @author Keshav Sahu
+ * @date May 1st 2022
+ * @brief This file contains functions to encode sort keys into bytes which can be compared with memcmp.
+ */
+
+#ifndef KMTABLELIB_KMT_KEYENCODING_HPP
+#define KMTABLELIB_KMT_KEYENCODING_HPP
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+#include "AbstractTable.hpp"
+
+namespace km
+{
+    /**
+     * @brief Appends the bytes of @a value to @a key , most significant byte first.
+     */
+    template <typename UInt_>
+    inline void appendBigEndian(std::string &key, UInt_ value)
+    {
+        for (int shift = int(sizeof(UInt_) * 8) - 8; shift >= 0; shift -= 8)
+            key.push_back(char(uint8_t(value >> shift)));
+    }
+
+    /**
+     * @brief Appends a null to the sort key @a key , see appendKeyValue().
+     */
+    inline void appendKeyNull(std::string &key, NullOrder null_order)
+    {
+        key.push_back(null_order == NullOrder::FIRST ? '\x00' : '\x02');
+    }
+
+    /**
+     * @brief Appends @a data to the sort key @a key .
+     *
+     * A sort key is made by appending the data (or null) of each column of a composite key in order. Two keys made from
+     * same columns compare with compareKeys() (a memcmp) like the data compares with AbstractColumn::isLess() column by
+     * column, so sorting doesn't have to go through a virtual call per column per comparison. Every value starts with a
+     * marker byte which places nulls before or after it, integers are stored big endian with flipped sign bit, floats
+     * with the usual sign flip, dates by toDateKey() and toDateTimeKey() like integers and strings with escaped zero bytes and a
+     * terminator, so no value is a prefix of the other. Bytes of a descending column are inverted.
+     */
+    inline void appendKeyValue(std::string &key, const Variant &data, SortingOrder sorting_order)
+    {
+        key.push_back('\x01');
+        const SizeType begin = key.size();
+        std::visit([&key](const auto &value)
+                   {
+                       using Type_ = std::decay_t<decltype(value)>;
+                       if constexpr (std::is_same_v<Type_, KInt32>)
+                           appendBigEndian(key, uint32_t(value) ^ 0x80000000U);
+                       else if constexpr (std::is_same_v<Type_, KInt64>)
+                           appendBigEndian(key, uint64_t(value) ^ 0x8000000000000000ULL);
+                       else if constexpr (std::is_floating_point_v<Type_>)
+                       {
+                           using UInt_ = std::conditional_t<sizeof(Type_) == 4, uint32_t, uint64_t>;
+                           const UInt_ sign = UInt_(1) << (sizeof(Type_) * 8 - 1);
+                           UInt_ bits = 0;
+                           if (value != 0) // -0 and 0 are equal
+                               std::memcpy(&bits, &value, sizeof(Type_));
+                           appendBigEndian(key, (bits & sign) ? UInt_(~bits) : UInt_(bits | sign));
+                       }
+                       else if constexpr (std::is_same_v<Type_, KString>)
+                       {
+                           for (char c : value)
+                           {
+                               key.push_back(c);
+                               if (c == '\0')
+                                   key.push_back('\x01');
+                           }
+                           key.append(2, '\0');
+                       }
+                       else if constexpr (std::is_same_v<Type_, KBoolean>)
+                           key.push_back(value ? '\x01' : '\x00');
+                       else if constexpr (std::is_same_v<Type_, KDate>)
+                           appendBigEndian(key, uint32_t(toDateKey(value)) ^ 0x80000000U);
+                       else
+                           appendBigEndian(key, uint64_t(toDateTimeKey(value)) ^ 0x8000000000000000ULL); },
+                   data.data());
+        if (sorting_order == SortingOrder::DESCENDING)
+        {
+            for (SizeType i = begin, size = key.size(); i < size; ++i)
+                key[i] = char(~key[i]);
+        }
+    }
+
+    /**
+     * @brief Compares two sort keys byte by byte, returns negative, zero or positive like memcmp.
+     */
+    inline int compareKeys(const std::string &key1, const std::string &key2) noexcept
+    {
+        const int result = std::memcmp(key1.data(), key2.data(), std::min(key1.size(), key2.size()));
+        return result ? result : (key1.size() < key2.size() ? -1 : key1.size() > key2.size());
+    }
+}
+
+#endif // KMTABLELIB_KMT_KEYENCODING_HPP
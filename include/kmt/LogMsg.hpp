@@ -7,6 +7,8 @@
 #ifndef KMTABLELIB_KMT_LOGMSG_HPP
 #define KMTABLELIB_KMT_LOGMSG_HPP
 
+#include <string_view>
+
 #include "Core.hpp"
 
 namespace km::err
@@ -36,6 +38,7 @@ namespace km::err
         ///@{
         LogMsg &operator << (const char *msg);
         LogMsg &operator << (const KString &msg);
+        LogMsg &operator << (std::string_view msg);
         LogMsg &operator << (KInt32 data);
         LogMsg &operator << (KInt64 data);
         LogMsg &operator << (KFloat32 data);
@@ -88,6 +91,12 @@ namespace km::err
         return *this;
     }
 
+    inline LogMsg &LogMsg::operator << (std::string_view msg)
+    {
+        m_msg += msg;
+        return *this;
+    }
+
     inline LogMsg &LogMsg::operator << (const char *msg)
     {
         m_msg += msg;
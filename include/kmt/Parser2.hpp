@@ -10,8 +10,10 @@
 #include <vector>
 #include <variant>
 #include <string>
+#include <string_view>
 
 #include "Core.hpp"
+#include "BitVector.hpp"
 
 namespace km
 {
@@ -35,8 +37,9 @@ namespace km
 
         struct Token
         {
-            std::string text;    ///< token text
-            uint16_t token_type; ///< token type
+            std::string text;        ///< owned token text, only names of functions keep it as they are resolved later
+            std::string_view source; ///< token text in the formula, valid only while the formula is compiled
+            uint16_t token_type;     ///< token type
             struct
             {
                 function_info_t &asFncInfo() { return std::get<function_info_t>(e); }
@@ -66,8 +69,12 @@ namespace km
          * container @a token_vec . If formula is parsed successfully, true is returned.
          * If string formula is invalid and contains syntax error, it will return false
          * and log messages will be added to logs.
+         *
+         * Formula is split and the type of each token is resolved in a single pass over @a formula . Tokens refer to
+         * their text in @a formula by Token::source, only names of functions are copied to Token::text, so
+         * @a formula must outlive the use of Token::source.
          */
-        bool parseToTokens(std::string formula, TokenContainerRef token_vec);
+        bool parseToTokens(std::string_view formula, TokenContainerRef token_vec);
 
         /**
          * @brief Compiles the parsed tokens.
@@ -126,6 +133,9 @@ namespace km
          *
          * If everything is fine then it returns true. If formula contains any type of error or doesn't produce a boolean
          * result errors will be written to logs and it will return false.
+         *
+         * @note Rows having null in any column referred by @a formula are not added, they are found in bulk with
+         * AbstractTable::getValidityMask() and skipped without evaluating the formula.
          */
         bool filter(const std::string &formula, std::vector<IndexType> &index_vec, const AbstractTable *table);
 
@@ -148,6 +158,17 @@ namespace km
          */
         bool filter(ConstTokenContainerRef token_vec, const AbstractTable *table, IndexType index);
 
+        /**
+         * @brief Overloaded function.
+         *
+         * It uses @a mask as a selection mask, index of every bit that is set in @a mask is added to @a index_vec
+         * in increasing order. It scans the mask a word at a time, so unset words are skipped cheaply.
+         *
+         * If the formula passed to other filter functions is just a boolean column (e.g. "$is_valid") then the mask of
+         * that column is taken from AbstractTable::getBooleanMask() and filtered by this function.
+         */
+        void filter(const BitVector &mask, std::vector<IndexType> &index_vec);
+
     } // namespace parse
 
 } // namespace km
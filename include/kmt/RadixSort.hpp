@@ -0,0 +1,139 @@
+/**
+ * @file RadixSort.hpp
+ * @author Keshav Sahu
+ * @date May 1st 2022
+ * @brief This file contains radix keys of the data types and a stable LSD radix sort on them.
+ */
+
+#ifndef KMTABLELIB_KMT_RADIXSORT_HPP
+#define KMTABLELIB_KMT_RADIXSORT_HPP
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "Types.hpp"
+
+namespace km
+{
+    /**
+     * @brief Minimum number of rows for which sorting uses radix sort, comparison sort is faster below it.
+     */
+    constexpr SizeType k_radix_sort_threshold = 1024;
+
+    /**
+     * @brief Returns unsigned key of @a value which compares like @a value , with operator<.
+     *
+     * Sign bit of integers is flipped, floats use the sign flip trick (negative values are inverted, -0 is same as 0),
+     * dates use their integral representation. Only lower radixKeyBytes<Type_>() bytes are used.
+     */
+    template <typename Type_>
+    inline uint64_t toRadixKey(const Type_ &value) noexcept
+    {
+        if constexpr (std::is_same_v<Type_, KBoolean>)
+            return value ? 1 : 0;
+        else if constexpr (std::is_integral_v<Type_>)
+        {
+            using UInt_ = std::make_unsigned_t<Type_>;
+            return UInt_(value) ^ (UInt_(1) << (sizeof(Type_) * 8 - 1));
+        }
+        else if constexpr (std::is_floating_point_v<Type_>)
+        {
+            using UInt_ = std::conditional_t<sizeof(Type_) == 4, uint32_t, uint64_t>;
+            const UInt_ sign = UInt_(1) << (sizeof(Type_) * 8 - 1);
+            UInt_ bits = 0;
+            if (value != 0)
+                std::memcpy(&bits, &value, sizeof(Type_));
+            return (bits & sign) ? UInt_(~bits) : UInt_(bits | sign);
+        }
+        else // KDate and KDateTime
+            return toRadixKey(integralRepresentationOf(value));
+    }
+
+    /**
+     * @brief Returns number of bytes used by toRadixKey() for @b Type_ .
+     */
+    template <typename Type_>
+    constexpr SizeType radixKeyBytes() noexcept
+    {
+        if constexpr (std::is_same_v<Type_, KBoolean>)
+            return 1;
+        else if constexpr (std::is_same_v<Type_, KDate>)
+            return 4;
+        else if constexpr (std::is_same_v<Type_, KDateTime>)
+            return 8;
+        else
+            return sizeof(Type_);
+    }
+
+    /**
+     * @brief Sorts @a values by @a keys (same size) with a stable LSD radix sort, one byte per pass.
+     *
+     * Only lower @a key_bytes bytes of the keys are used and passes in which all keys have same byte are skipped. If
+     * @a descending is true then values with greater keys come first. Like std::stable_sort(), values with equal keys
+     * keep their order. @a keys is reordered along with @a values .
+     */
+    inline void radixSort(std::vector<IndexType> &values, std::vector<uint64_t> &keys, SizeType key_bytes, bool descending)
+    {
+        const SizeType size = values.size();
+        std::vector<IndexType> values_buffer(size);
+        std::vector<uint64_t> keys_buffer(size);
+        for (SizeType byte = 0; byte < key_bytes; ++byte)
+        {
+            const SizeType shift = byte * 8;
+            std::array<SizeType, 256> counts{};
+            for (uint64_t key : keys)
+                ++counts[(key >> shift) & 0xFF];
+            if (std::any_of(counts.begin(), counts.end(), [size](SizeType count)
+                            { return count == size; }))
+                continue; // all keys have same byte
+
+            std::array<SizeType, 256> offsets;
+            SizeType offset = 0;
+            for (SizeType i = 0; i < 256; ++i)
+            {
+                const SizeType digit = descending ? 255 - i : i;
+                offsets[digit] = offset;
+                offset += counts[digit];
+            }
+            for (SizeType k = 0; k < size; ++k)
+            {
+                const SizeType pos = offsets[(keys[k] >> shift) & 0xFF]++;
+                values_buffer[pos] = values[k];
+                keys_buffer[pos] = keys[k];
+            }
+            values.swap(values_buffer);
+            keys.swap(keys_buffer);
+        }
+    }
+
+    /**
+     * @brief Same as radixSort() but values for which @a is_null(value) is true are placed first or last as per
+     * @a nulls_first in their current order, their keys are ignored.
+     */
+    template <typename IsNull_>
+    void radixSort(std::vector<IndexType> &values, std::vector<uint64_t> &keys, SizeType key_bytes, bool descending, bool nulls_first, IsNull_ is_null)
+    {
+        std::vector<IndexType> nulls;
+        SizeType kept = 0;
+        for (SizeType k = 0, size = values.size(); k < size; ++k)
+        {
+            if (is_null(values[k]))
+                nulls.push_back(values[k]);
+            else
+            {
+                values[kept] = values[k];
+                keys[kept++] = keys[k];
+            }
+        }
+        values.resize(kept);
+        keys.resize(kept);
+        radixSort(values, keys, key_bytes, descending);
+        values.insert(nulls_first ? values.begin() : values.end(), nulls.begin(), nulls.end());
+    }
+}
+
+#endif // KMTABLELIB_KMT_RADIXSORT_HPP
@@ -0,0 +1,530 @@
+/**
+ * @file RowIndex.hpp
+ * @author Keshav Sahu
+ * @date May 1st 2022
+ * @brief This file contains RowIndex class, the ordered list of physical row indices of a table.
+ */
+
+#ifndef KMTABLELIB_KMT_ROWINDEX_HPP
+#define KMTABLELIB_KMT_ROWINDEX_HPP
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#include "Types.hpp"
+
+namespace km
+{
+    /**
+     * @brief RowIndexKind selects the structure which keeps the order of the rows of a table.
+     */
+    enum class RowIndexKind : uint8_t
+    {
+        VECTOR, ///< flat vector, fastest access but insertion and removal shift half of the rows.
+        TREE    ///< counted B+ tree, O(log n) access, insertion and removal. Better for big, frequently updated tables.
+    };
+
+    /**
+     * @brief RowIndexTree is a counted B+ tree of indices, addressed by position.
+     *
+     * Leaves keep up to k_leaf_capacity indices in order and every internal node keeps the count and the last
+     * index of each child, so an index can be found by position, inserted or erased in O(log n) and an ordered
+     * position can be searched with partitionPoint() in O(log n) comparisons.
+     */
+    class RowIndexTree
+    {
+    public:
+        static constexpr SizeType k_leaf_capacity = 512; ///< max indices in a leaf
+        static constexpr SizeType k_node_capacity = 64;  ///< max children of an internal node
+
+        RowIndexTree() : m_root(new Node(true)) {}
+
+        /**
+         * @brief Returns number of indices.
+         */
+        SizeType size() const noexcept { return m_root->count; }
+
+        /**
+         * @brief Returns index at position @a pos . @a pos must be valid else it would be UB.
+         */
+        IndexType at(IndexType pos) const noexcept
+        {
+            const Node *node = m_root.get();
+            while (!node->leaf)
+            {
+                IndexType i = 0;
+                for (; pos >= node->children[i]->count; ++i)
+                    pos -= node->children[i]->count;
+                node = node->children[i].get();
+            }
+            return node->values[pos];
+        }
+
+        /**
+         * @brief Replaces index at position @a pos with @a value . @a pos must be valid else it would be UB.
+         */
+        void set(IndexType pos, IndexType value) noexcept
+        {
+            Node *node = m_root.get();
+            while (!node->leaf)
+            {
+                IndexType i = 0;
+                for (; pos >= node->children[i]->count; ++i)
+                    pos -= node->children[i]->count;
+                if (pos + 1 == node->children[i]->count) // last index of the child is cached
+                    node->lasts[i] = value;
+                node = node->children[i].get();
+            }
+            node->values[pos] = value;
+        }
+
+        /**
+         * @brief Inserts @a value at position @a pos , @a pos must not be greater than size().
+         */
+        void insert(IndexType pos, IndexType value)
+        {
+            insert(*m_root, pos, value);
+            if (overflows(*m_root))
+            {
+                std::unique_ptr<Node> new_root(new Node(false));
+                new_root->count = m_root->count;
+                new_root->lasts.push_back(lastOf(*m_root));
+                new_root->children.push_back(std::move(m_root));
+                split(*new_root, 0);
+                m_root = std::move(new_root);
+            }
+        }
+
+        /**
+         * @brief Removes the index at position @a pos . @a pos must be valid else it would be UB.
+         */
+        void erase(IndexType pos)
+        {
+            erase(*m_root, pos);
+            if (!m_root->leaf && m_root->children.empty())
+                m_root.reset(new Node(true));
+            while (!m_root->leaf && m_root->children.size() == 1)
+                m_root = std::move(m_root->children.front());
+        }
+
+        /**
+         * @brief Removes all indices.
+         */
+        void clear() { m_root.reset(new Node(true)); }
+
+        /**
+         * @brief Replaces the content with @a values , the tree is built bottom up in O(n).
+         */
+        void assign(const std::vector<IndexType> &values)
+        {
+            std::vector<std::unique_ptr<Node>> level;
+            for (IndexType begin = 0, size = values.size(); begin < size; begin += k_leaf_capacity)
+            {
+                std::unique_ptr<Node> leaf(new Node(true));
+                leaf->values.assign(values.begin() + begin, values.begin() + std::min(size, begin + k_leaf_capacity));
+                leaf->count = leaf->values.size();
+                level.push_back(std::move(leaf));
+            }
+            while (level.size() > 1)
+            {
+                std::vector<std::unique_ptr<Node>> parents;
+                for (IndexType begin = 0, size = level.size(); begin < size; begin += k_node_capacity)
+                {
+                    std::unique_ptr<Node> parent(new Node(false));
+                    for (IndexType i = begin, end = std::min(size, begin + k_node_capacity); i < end; ++i)
+                    {
+                        parent->count += level[i]->count;
+                        parent->lasts.push_back(lastOf(*level[i]));
+                        parent->children.push_back(std::move(level[i]));
+                    }
+                    parents.push_back(std::move(parent));
+                }
+                level = std::move(parents);
+            }
+            if (level.empty())
+                clear();
+            else
+                m_root = std::move(level.front());
+        }
+
+        /**
+         * @brief Returns the first position for which @a pred is false.
+         *
+         * Indices must be partitioned by @a pred (all indices for which it is true come first), like
+         * std::partition_point().
+         */
+        template <typename Pred>
+        IndexType partitionPoint(Pred pred) const
+        {
+            const Node *node = m_root.get();
+            IndexType pos = 0;
+            while (!node->leaf)
+            {
+                IndexType i = 0;
+                for (const IndexType last = node->children.size() - 1; i < last && pred(node->lasts[i]); ++i)
+                    pos += node->children[i]->count;
+                node = node->children[i].get();
+            }
+            return pos + (std::partition_point(node->values.begin(), node->values.end(), pred) - node->values.begin());
+        }
+
+        /**
+         * @brief Calls @a fnc(index) for every index in order.
+         */
+        template <typename Fnc>
+        void forEach(Fnc fnc) const
+        {
+            forEach(*m_root, fnc);
+        }
+
+    private:
+        struct Node
+        {
+            explicit Node(bool is_leaf) : leaf(is_leaf), count(0) {}
+            bool leaf;
+            SizeType count;                              ///< number of indices in the subtree
+            std::vector<IndexType> values;               ///< indices, only for leaf
+            std::vector<std::unique_ptr<Node>> children; ///< children, only for internal node
+            std::vector<IndexType> lasts;                ///< last index of each child, only for internal node
+        };
+
+        static IndexType lastOf(const Node &node) noexcept
+        {
+            return node.leaf ? node.values.back() : node.lasts.back();
+        }
+
+        static bool overflows(const Node &node) noexcept
+        {
+            return node.leaf ? node.values.size() > k_leaf_capacity : node.children.size() > k_node_capacity;
+        }
+
+        static SizeType width(const Node &node) noexcept
+        {
+            return node.leaf ? node.values.size() : node.children.size();
+        }
+
+        static void insert(Node &node, IndexType pos, IndexType value)
+        {
+            ++node.count;
+            if (node.leaf)
+            {
+                node.values.insert(node.values.begin() + pos, value);
+                return;
+            }
+            IndexType i = 0;
+            for (const IndexType last = node.children.size() - 1; i < last && pos > node.children[i]->count; ++i)
+                pos -= node.children[i]->count;
+            insert(*node.children[i], pos, value);
+            node.lasts[i] = lastOf(*node.children[i]);
+            if (overflows(*node.children[i]))
+                split(node, i);
+        }
+
+        // splits child i of parent in two halves.
+        static void split(Node &parent, IndexType i)
+        {
+            Node &child = *parent.children[i];
+            std::unique_ptr<Node> right(new Node(child.leaf));
+            if (child.leaf)
+            {
+                const SizeType half = child.values.size() / 2;
+                right->values.assign(child.values.begin() + half, child.values.end());
+                child.values.resize(half);
+                right->count = right->values.size();
+            }
+            else
+            {
+                const SizeType half = child.children.size() / 2;
+                for (IndexType k = half, size = child.children.size(); k < size; ++k)
+                {
+                    right->count += child.children[k]->count;
+                    right->children.push_back(std::move(child.children[k]));
+                }
+                right->lasts.assign(child.lasts.begin() + half, child.lasts.end());
+                child.children.resize(half);
+                child.lasts.resize(half);
+            }
+            child.count -= right->count;
+            parent.lasts[i] = lastOf(child);
+            parent.lasts.insert(parent.lasts.begin() + i + 1, lastOf(*right));
+            parent.children.insert(parent.children.begin() + i + 1, std::move(right));
+        }
+
+        static void erase(Node &node, IndexType pos)
+        {
+            --node.count;
+            if (node.leaf)
+            {
+                node.values.erase(node.values.begin() + pos);
+                return;
+            }
+            IndexType i = 0;
+            for (; pos >= node.children[i]->count; ++i)
+                pos -= node.children[i]->count;
+            erase(*node.children[i], pos);
+            if (node.children[i]->count == 0)
+            {
+                node.children.erase(node.children.begin() + i);
+                node.lasts.erase(node.lasts.begin() + i);
+                return;
+            }
+            node.lasts[i] = lastOf(*node.children[i]);
+            // merge an underfull child with a neighbour, if both fit comfortably in one node.
+            const SizeType capacity = node.children[i]->leaf ? k_leaf_capacity : k_node_capacity;
+            if (width(*node.children[i]) >= capacity / 4)
+                return;
+            if (i + 1 < node.children.size() && width(*node.children[i]) + width(*node.children[i + 1]) <= capacity * 3 / 4)
+                merge(node, i);
+            else if (i > 0 && width(*node.children[i - 1]) + width(*node.children[i]) <= capacity * 3 / 4)
+                merge(node, i - 1);
+        }
+
+        // moves child i + 1 of parent into child i.
+        static void merge(Node &parent, IndexType i)
+        {
+            Node &left = *parent.children[i];
+            Node &right = *parent.children[i + 1];
+            if (left.leaf)
+                left.values.insert(left.values.end(), right.values.begin(), right.values.end());
+            else
+            {
+                for (auto &child : right.children)
+                    left.children.push_back(std::move(child));
+                left.lasts.insert(left.lasts.end(), right.lasts.begin(), right.lasts.end());
+            }
+            left.count += right.count;
+            parent.lasts[i] = parent.lasts[i + 1];
+            parent.children.erase(parent.children.begin() + i + 1);
+            parent.lasts.erase(parent.lasts.begin() + i + 1);
+        }
+
+        template <typename Fnc>
+        static void forEach(const Node &node, Fnc &fnc)
+        {
+            if (node.leaf)
+            {
+                for (IndexType value : node.values)
+                    fnc(value);
+                return;
+            }
+            for (const auto &child : node.children)
+                forEach(*child, fnc);
+        }
+
+        std::unique_ptr<Node> m_root;
+    };
+
+    /**
+     * @brief RowIndex keeps the physical indices of the rows of a table in the table's order.
+     *
+     * Position i holds the index (in the columns) of row i. It is either a flat vector or a RowIndexTree, see
+     * RowIndexKind. Bulk operations like sorting and merging are done on a flat vector with update(), for the tree
+     * it is flattened and rebuilt in O(n).
+     */
+    class RowIndex
+    {
+    public:
+        explicit RowIndex(RowIndexKind kind = RowIndexKind::VECTOR) : m_kind(kind), m_flat_valid(false), m_positions_valid(false) {}
+
+        /**
+         * @brief Returns the current structure.
+         */
+        RowIndexKind kind() const noexcept { return m_kind; }
+
+        /**
+         * @brief Changes the structure to @a kind , order is kept.
+         */
+        void setKind(RowIndexKind kind)
+        {
+            if (kind == m_kind)
+                return;
+            if (kind == RowIndexKind::TREE)
+            {
+                m_tree.assign(m_vector);
+                m_vector = std::vector<IndexType>();
+            }
+            else
+            {
+                m_vector = flat();
+                m_tree.clear();
+            }
+            m_kind = kind;
+            invalidate();
+        }
+
+        SizeType size() const noexcept { return isTree() ? m_tree.size() : m_vector.size(); }
+        bool empty() const noexcept { return size() == 0; }
+
+        /**
+         * @brief Returns index of the row at position @a pos . @a pos must be valid else it would be UB.
+         */
+        IndexType operator[](IndexType pos) const noexcept { return isTree() ? m_tree.at(pos) : m_vector[pos]; }
+
+        /**
+         * @brief Inserts @a value at position @a pos .
+         */
+        void insert(IndexType pos, IndexType value)
+        {
+            if (isTree())
+                m_tree.insert(pos, value);
+            else
+                m_vector.insert(m_vector.begin() + pos, value);
+            invalidate();
+        }
+
+        /**
+         * @brief Replaces the index at position @a pos with @a value . @a pos must be valid else it would be UB.
+         */
+        void set(IndexType pos, IndexType value)
+        {
+            if (isTree())
+            {
+                m_tree.set(pos, value);
+                if (m_flat_valid)
+                    m_flat[pos] = value;
+            }
+            else
+                m_vector[pos] = value;
+            if (m_positions_valid)
+            {
+                if (value >= m_positions.size())
+                    m_positions.resize(value + 1, INVALID_INDEX);
+                m_positions[value] = pos;
+            }
+        }
+
+        /**
+         * @brief Removes the index at position @a pos .
+         */
+        void erase(IndexType pos)
+        {
+            if (isTree())
+                m_tree.erase(pos);
+            else
+                m_vector.erase(m_vector.begin() + pos);
+            invalidate();
+        }
+
+        /**
+         * @brief Appends @a value at the end.
+         */
+        void push_back(IndexType value) { insert(size(), value); }
+
+        /**
+         * @brief Reserves memory for @a size indices, it does nothing for tree.
+         */
+        void reserve(SizeType size)
+        {
+            if (!isTree())
+                m_vector.reserve(size);
+        }
+
+        /**
+         * @brief Replaces the content with @a indices .
+         */
+        void assign(std::vector<IndexType> indices)
+        {
+            if (isTree())
+                m_tree.assign(indices);
+            else
+                m_vector = std::move(indices);
+            invalidate();
+        }
+
+        /**
+         * @brief Returns the first position for which @a pred is false, see RowIndexTree::partitionPoint().
+         */
+        template <typename Pred>
+        IndexType partitionPoint(Pred pred) const
+        {
+            if (isTree())
+                return m_tree.partitionPoint(pred);
+            return std::partition_point(m_vector.begin(), m_vector.end(), pred) - m_vector.begin();
+        }
+
+        /**
+         * @brief Returns all indices in a flat vector.
+         *
+         * For tree it is built on first call after a modification and kept until next modification.
+         */
+        const std::vector<IndexType> &flat() const
+        {
+            if (!isTree())
+                return m_vector;
+            if (!m_flat_valid)
+            {
+                m_flat.clear();
+                m_flat.reserve(m_tree.size());
+                m_tree.forEach([this](IndexType value)
+                               { m_flat.push_back(value); });
+                m_flat_valid = true;
+            }
+            return m_flat;
+        }
+
+        /**
+         * @brief Calls @a fnc(std::vector<IndexType> &) to modify the indices in bulk.
+         */
+        template <typename Fnc>
+        void update(Fnc fnc)
+        {
+            m_positions_valid = false;
+            if (!isTree())
+            {
+                fnc(m_vector);
+                return;
+            }
+            std::vector<IndexType> indices = flat();
+            fnc(indices);
+            m_tree.assign(indices);
+            m_flat = std::move(indices);
+            m_flat_valid = true;
+        }
+
+        /**
+         * @brief Returns the position of index @a value , which must be in the row index.
+         *
+         * Positions of all the indices are found in a single pass on first call after a modification and kept until
+         * next modification (other than set()), so later calls are O(1).
+         */
+        IndexType positionOf(IndexType value) const
+        {
+            if (!m_positions_valid)
+            {
+                const std::vector<IndexType> &indices = flat();
+                m_positions.assign(indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end()) + 1, INVALID_INDEX);
+                for (IndexType pos = 0, size = indices.size(); pos < size; ++pos)
+                    m_positions[indices[pos]] = pos;
+                m_positions_valid = true;
+            }
+            return m_positions[value];
+        }
+
+        /**
+         * @brief Returns true if positionOf() doesn't need to find the positions again.
+         */
+        bool hasPositions() const noexcept { return m_positions_valid; }
+
+    private:
+        bool isTree() const noexcept { return m_kind == RowIndexKind::TREE; }
+        void invalidate() noexcept
+        {
+            m_flat_valid = false;
+            m_flat = std::vector<IndexType>();
+            m_positions_valid = false;
+        }
+
+        RowIndexKind m_kind;
+        std::vector<IndexType> m_vector; ///< used if kind is VECTOR
+        RowIndexTree m_tree;             ///< used if kind is TREE
+        mutable std::vector<IndexType> m_flat;
+        mutable bool m_flat_valid;
+        mutable std::vector<IndexType> m_positions; ///< position of each index, see positionOf()
+        mutable bool m_positions_valid;
+    };
+}
+
+#endif // KMTABLELIB_KMT_ROWINDEX_HPP
@@ -0,0 +1,252 @@
+/**
+ * @file SecondaryIndex.hpp
+ * @author Keshav Sahu
+ * @date May 1st 2022
+ * @brief This file contains secondary indexes, which speed up search on the columns other than the key column.
+ */
+
+#ifndef KMTABLELIB_KMT_SECONDARYINDEX_HPP
+#define KMTABLELIB_KMT_SECONDARYINDEX_HPP
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+
+#include "Column.hpp"
+#include "RowIndex.hpp"
+
+namespace km
+{
+    /**
+     * @brief IndexKind is the kind of a secondary index created by Table::createIndex().
+     */
+    enum class IndexKind : uint8_t
+    {
+        HASH,   ///< hash table from values to rows, for equality search
+        ORDERED ///< rows sorted by the values, for equality and range search
+    };
+
+    /**
+     * @brief Hash of a Variant, dates are hashed by their integral representation.
+     */
+    struct VariantHash
+    {
+        std::size_t operator()(const Variant &data) const noexcept
+        {
+            return std::visit([](const auto &value) -> std::size_t
+                              {
+                                  using Type_ = std::decay_t<decltype(value)>;
+                                  if constexpr (std::is_same_v<Type_, KDate> || std::is_same_v<Type_, KDateTime>)
+                                      return std::hash<int64_t>()(integralRepresentationOf(value));
+                                  else
+                                      return std::hash<Type_>()(value); },
+                              data.data());
+        }
+    };
+
+    /**
+     * @brief Equality of two Variants, it is true only if both have same type and same value.
+     */
+    struct VariantEqual
+    {
+        bool operator()(const Variant &data1, const Variant &data2) const noexcept
+        {
+            return data1.data() == data2.data();
+        }
+    };
+
+    /**
+     * @brief SecondaryIndex is base of the indexes on a column of a @ref Table.
+     *
+     * An index maps values of a column to the physical indices of the rows (index of the data in the column, not
+     * the row index of the table). The table keeps it updated whenever data of the column changes. Nulls are
+     * never indexed.
+     */
+    class SecondaryIndex
+    {
+    public:
+        /**
+         * @brief Returns kind of the index.
+         */
+        virtual IndexKind getKind() const noexcept = 0;
+
+        /**
+         * @brief Adds data at physical index @a index of @a column , does nothing if it is null.
+         */
+        virtual void insert(const AbstractColumn &column, IndexType index) = 0;
+
+        /**
+         * @brief Removes data at physical index @a index of @a column , which must not be changed since it was inserted.
+         */
+        virtual void erase(const AbstractColumn &column, IndexType index) = 0;
+
+        /**
+         * @brief Removes everything.
+         */
+        virtual void clear() noexcept = 0;
+
+        /**
+         * @brief Appends to @a indices the physical indices whose data is equal to @a data , in no specific order.
+         */
+        virtual void findEqual(const AbstractColumn &column, const Variant &data, std::vector<IndexType> &indices) const = 0;
+
+        /**
+         * @brief Appends to @a indices the physical indices whose data lies between @a low and @a high , in no specific order.
+         *
+         * Bounds are included if @a low_inclusive and @a high_inclusive are true. If the index doesn't support range
+         * search then it returns false, else true.
+         */
+        virtual bool findRange([[maybe_unused]] const AbstractColumn &column, [[maybe_unused]] const Variant &low, [[maybe_unused]] bool low_inclusive,
+                               [[maybe_unused]] const Variant &high, [[maybe_unused]] bool high_inclusive, [[maybe_unused]] std::vector<IndexType> &indices) const
+        {
+            return false;
+        }
+
+        /**
+         * @brief Recreates the index from data at physical indices @a indices of @a column .
+         */
+        virtual void rebuild(const AbstractColumn &column, const std::vector<IndexType> &indices)
+        {
+            clear();
+            for (IndexType index : indices)
+                insert(column, index);
+        }
+
+        virtual ~SecondaryIndex() = default;
+    };
+
+    /**
+     * @brief HashIndex is a secondary index for equality search, see IndexKind::HASH.
+     *
+     * insertion, removal and search take O(1) on average (plus the number of duplicates of the value).
+     */
+    class HashIndex final : public SecondaryIndex
+    {
+    public:
+        IndexKind getKind() const noexcept override { return IndexKind::HASH; }
+
+        void insert(const AbstractColumn &column, IndexType index) override
+        {
+            if (!column.isNull(index))
+                m_map.emplace(column.getData(index), index);
+        }
+
+        void erase(const AbstractColumn &column, IndexType index) override
+        {
+            if (column.isNull(index))
+                return;
+            auto [first, last] = m_map.equal_range(column.getData(index));
+            for (; first != last; ++first)
+            {
+                if (first->second == index)
+                {
+                    m_map.erase(first);
+                    return;
+                }
+            }
+        }
+
+        void clear() noexcept override { m_map.clear(); }
+
+        void findEqual([[maybe_unused]] const AbstractColumn &column, const Variant &data, std::vector<IndexType> &indices) const override
+        {
+            auto [first, last] = m_map.equal_range(data);
+            for (; first != last; ++first)
+                indices.push_back(first->second);
+        }
+
+        /**
+         * @brief Returns number of indexed (non null) values.
+         */
+        SizeType size() const noexcept { return m_map.size(); }
+
+    private:
+        std::unordered_multimap<Variant, IndexType, VariantHash, VariantEqual> m_map;
+    };
+
+    /**
+     * @brief OrderedIndex is a secondary index for equality and range search, see IndexKind::ORDERED.
+     *
+     * Physical indices are kept sorted with AbstractColumn::isLess() (ties by physical index) in a counted B+ tree, so
+     * insertion and removal take O(log n) and search takes O(log n + k) for k results.
+     */
+    class OrderedIndex final : public SecondaryIndex
+    {
+    public:
+        IndexKind getKind() const noexcept override { return IndexKind::ORDERED; }
+
+        void insert(const AbstractColumn &column, IndexType index) override
+        {
+            if (!column.isNull(index))
+                m_order.insert(positionOf(column, index), index);
+        }
+
+        void erase(const AbstractColumn &column, IndexType index) override
+        {
+            if (column.isNull(index))
+                return;
+            const IndexType pos = positionOf(column, index);
+            if (pos < m_order.size() && m_order.at(pos) == index)
+                m_order.erase(pos);
+        }
+
+        void clear() noexcept override { m_order.clear(); }
+
+        void findEqual(const AbstractColumn &column, const Variant &data, std::vector<IndexType> &indices) const override
+        {
+            findRange(column, data, true, data, true, indices);
+        }
+
+        bool findRange(const AbstractColumn &column, const Variant &low, bool low_inclusive,
+                       const Variant &high, bool high_inclusive, std::vector<IndexType> &indices) const override
+        {
+            const IndexType first = m_order.partitionPoint([&column, &low, low_inclusive](IndexType index)
+                                                           { return column.isLessV(index, low) || (!low_inclusive && !column.isGreaterV(index, low)); });
+            const IndexType last = m_order.partitionPoint([&column, &high, high_inclusive](IndexType index)
+                                                          { return column.isLessV(index, high) || (high_inclusive && !column.isGreaterV(index, high)); });
+            for (IndexType pos = first; pos < last; ++pos)
+                indices.push_back(m_order.at(pos));
+            return true;
+        }
+
+        /**
+         * @brief Recreates the index in O(n log n), faster than inserting one by one.
+         */
+        void rebuild(const AbstractColumn &column, const std::vector<IndexType> &indices) override
+        {
+            std::vector<IndexType> order;
+            order.reserve(indices.size());
+            for (IndexType index : indices)
+            {
+                if (!column.isNull(index))
+                    order.push_back(index);
+            }
+            std::sort(order.begin(), order.end(), [&column](IndexType index1, IndexType index2)
+                      { return isLess(column, index1, index2); });
+            m_order.assign(order);
+        }
+
+        /**
+         * @brief Returns number of indexed (non null) values.
+         */
+        SizeType size() const noexcept { return m_order.size(); }
+
+    private:
+        static bool isLess(const AbstractColumn &column, IndexType index1, IndexType index2) noexcept
+        {
+            return column.isLess(index1, index2) || (!column.isLess(index2, index1) && index1 < index2);
+        }
+
+        IndexType positionOf(const AbstractColumn &column, IndexType index) const
+        {
+            return m_order.partitionPoint([&column, index](IndexType mid)
+                                          { return isLess(column, mid, index); });
+        }
+
+        RowIndexTree m_order;
+    };
+}
+
+#endif // KMTABLELIB_KMT_SECONDARYINDEX_HPP
@@ -8,13 +8,51 @@
 #define KMTABLELIB_KMT_TABLE_HPP
 
 #include <algorithm>
+#include <memory>
+#include <memory_resource>
 
 #include "AbstractTable.hpp"
+#include "RowIndex.hpp"
+#include "SecondaryIndex.hpp"
+#include "KeyEncoding.hpp"
 #include "ErrorHandler.hpp"
 #include "Parser2.hpp"
 
 namespace km
 {
+    template <typename Type_>
+    class ColumnHandle;
+
+    /**
+     * @brief DataLayout tells how the values passed to Table::insertRows() are arranged.
+     */
+    enum class DataLayout : uint8_t
+    {
+        ROW_MAJOR,   ///< data[i] is i-th row, data[i][j] is value of j-th column.
+        COLUMN_MAJOR ///< data[j] is j-th column, data[j][i] is value of i-th row.
+    };
+
+    /**
+     * @brief CompactionMode tells when Table reclaims the space of dropped rows, see Table::setCompactionMode().
+     */
+    enum class CompactionMode : uint8_t
+    {
+        IMMEDIATE,   ///< all free space is reclaimed at once when it reaches the max free space tolerance.
+        INCREMENTAL, ///< after reaching the tolerance, each insertion and drop reclaims a bounded slice of free space.
+        DEFERRED     ///< free space is reclaimed only by Table::compact(), e.g. from an idle loop.
+    };
+
+    /**
+     * @brief FragmentationStats describes the space wasted by a Table, see Table::getFragmentationStats().
+     */
+    struct FragmentationStats
+    {
+        SizeType row_count;      ///< number of rows in the table
+        SizeType free_row_count; ///< dropped rows whose space is not reclaimed yet
+        SizeType unused_bytes;   ///< bytes not used by any row in the arenas of string columns
+        double fragmentation;    ///< free_row_count / (row_count + free_row_count), 0 if both are 0
+    };
+
     /**
      * @brief Table allows us to create table with multiple columns and rows where each column can have their own data type.
      * Data types includes KInt32, KInt64, KFloat32, KFloat64, KString, KBoolean, KDate and KDateTime. The first column is
@@ -55,8 +93,12 @@ namespace km
          * 
          * @exception It throws std::invalid_argument exception if table name or columns names are not valid or
          * column names are not unique within the table or contains a data type which is altered.
+         *
+         * Data of the columns is allocated from @a resource (see AbstractColumn::getMemoryResource()), e.g. a
+         * std::pmr::monotonic_buffer_resource for short lived tables. @a resource must outlive the table.
          */
-        Table(const std::string &table_name, const std::vector<ColumnMetaData> &column_list, SortingOrder sorting_order = SortingOrder::ASCENDING) KM_THROWS_EXCEPTION(std::invalid_argument);
+        Table(const std::string &table_name, const std::vector<ColumnMetaData> &column_list, SortingOrder sorting_order = SortingOrder::ASCENDING,
+              std::pmr::memory_resource *resource = std::pmr::get_default_resource()) KM_THROWS_EXCEPTION(std::invalid_argument);
 
         KM_DISABLE_COPY_MOVE(Table)
 
@@ -77,6 +119,83 @@ namespace km
          */
         IndexType insertRow(const std::vector<Variant> &values) noexcept;
 
+        /**
+         * @brief Same as insertRow() but strings are moved from @a values into the columns instead of being copied.
+         */
+        IndexType insertRow(std::vector<Variant> &&values) noexcept;
+
+        /**
+         * @brief Inserts a row from typed values, without creating Variants.
+         *
+         * There must be one value per column. The type of each value (string literals are taken as KString) is
+         * checked once against the data type of its column and then the value is written directly into the column,
+         * rvalue strings are moved. It is the fastest way to insert a row. Return value is same as insertRow(), if
+         * the number or types of values don't match the columns then error is written to logs and INVALID_INDEX
+         * is returned.
+         *
+         * @code {.cpp}
+         * km::Table student("student", {{"name", km::DataType::STRING}, {"age", km::DataType::INT32}});
+         * student.insertRowT("Keshav Sahu", 25);
+         * student.insertRowT(std::string("Adil Hussain"), KInt32(18));
+         * @endcode
+         */
+        template <typename... Values_>
+        IndexType insertRowT(Values_ &&...values) noexcept;
+
+        /**
+         * @brief Insert a row which may contain nulls.
+         *
+         * Same as insertRow() but an element of @a values can be std::nullopt to insert null in that column. Nulls
+         * in the first column are placed according to getNullOrder().
+         */
+        IndexType insertRowN(const std::vector<std::optional<Variant>> &values) noexcept;
+
+        /**
+         * @brief Inserts many rows at once.
+         *
+         * @a data is arranged as per @a layout and every row must have a value for each column with the data type of
+         * that column. Rows are appended to the columns, the new rows are sorted among themselves and merged with the
+         * table in one pass and dependent views are notified with a single rowsInsertionEvent(). So it is much faster
+         * than calling insertRow() for each row.
+         *
+         * If any value is invalid then no row is inserted, error is written to logs and false is returned. Else it
+         * returns true.
+         *
+         * @note If isSortingPaused() is true then rows are only appended, like insertRow().
+         */
+        bool insertRows(const std::vector<std::vector<Variant>> &data, DataLayout layout = DataLayout::ROW_MAJOR) noexcept;
+
+        /**
+         * @brief Updates the row with the same key as @a values , or inserts @a values if there is no such row.
+         *
+         * The row is found with a binary search on the key column. Only the cells whose value changes are written and
+         * each of them is notified with a dataUpdateEvent(), so an unchanged row emits nothing. If many rows have the
+         * key then the first one is updated. If a secondary sort key (see setSortKeys()) changes then the row is
+         * dropped and inserted again. Returns the row index of the updated or inserted row, or INVALID_INDEX if
+         * @a values is invalid or sorting is paused (see logs).
+         */
+        IndexType upsert(const std::vector<Variant> &values) noexcept;
+
+        /**
+         * @brief Upserts many rows at once.
+         *
+         * @a rows are sorted by key and matched with the table in a single linear pass. Matched rows are updated like
+         * upsert(), rows that need to move are dropped with dropRows() and the rest are inserted with insertRows(), so
+         * a batch emits one event per changed cell plus at most one rowsDropEvent() and one rowsInsertionEvent(). If
+         * @a rows have a key more than once then the last row wins.
+         *
+         * If any row is invalid or sorting is paused then nothing is changed, error is written to logs and false is
+         * returned. Else it returns true.
+         */
+        bool mergeFrom(const std::vector<std::vector<Variant>> &rows) noexcept;
+
+        /**
+         * @brief Upserts all the rows of @a other , which must have the same data types of columns.
+         *
+         * Same as above but nulls of @a other are copied too, a row with null key never matches so it is inserted.
+         */
+        bool mergeFrom(const Table &other) noexcept;
+
         /**
          * @brief Removes the row from the table.
          * 
@@ -85,6 +204,23 @@ namespace km
          */
         bool dropRow(IndexType row_index);
 
+        /**
+         * @brief Removes many rows at once.
+         *
+         * @a row_indices may be in any order and may have duplicates. All rows are removed in one pass, free space
+         * is checked once and dependent views are notified with a single rowsDropEvent(). If any index is invalid
+         * then no row is removed, error is written to logs and false is returned. Else it returns true.
+         */
+        bool dropRows(std::vector<IndexType> row_indices);
+
+        /**
+         * @brief Removes all the rows for which boolean @a formula is true.
+         *
+         * Rows are found with parse::filter() and removed with dropRows(). If @a formula is invalid then it returns
+         * false (see logs) and nothing is removed. Else it returns true.
+         */
+        bool dropWhere(const std::string &formula);
+
         /**
          * @brief Set @a size to the max free space tolerance size.
          *
@@ -99,6 +235,99 @@ namespace km
          */
         SizeType getMaxFreeSpaceTolerance() const;
 
+        /**
+         * @brief Sets when the space of dropped rows is reclaimed, default is CompactionMode::IMMEDIATE.
+         *
+         * With CompactionMode::IMMEDIATE all columns are rebuilt once free rows reach the max free space tolerance,
+         * so a drop now and then takes time proportional to the size of the table. With CompactionMode::INCREMENTAL
+         * the work is spread instead, each insertion and drop calls compact(@a slice_size) until no free row is left.
+         * With CompactionMode::DEFERRED only compact() reclaims the space.
+         */
+        void setCompactionMode(CompactionMode mode, SizeType slice_size = 256);
+
+        /**
+         * @brief Returns the compaction mode set by setCompactionMode().
+         */
+        CompactionMode getCompactionMode() const noexcept;
+
+        /**
+         * @brief Reclaims the space of at most @a max_rows dropped rows, returns true if no free row is left.
+         *
+         * The last rows of the columns are moved into the space of the dropped rows and the columns are shrunk, data
+         * is moved directly (no Variant) and order of the rows doesn't change so dependent views are not notified.
+         * Rows of the moved data are found together, in at most one pass over the rows (none if their positions are
+         * already known since the last change of order), then each step costs the number of columns.
+         *
+         * @note Unlike freeSpace(), rows lose their physical order, so in clustered mode moved rows count as
+         * unclustered insertions.
+         */
+        bool compact(SizeType max_rows);
+
+        /**
+         * @brief Returns how much space is wasted by dropped rows and unused string bytes.
+         */
+        FragmentationStats getFragmentationStats() const;
+
+        /**
+         * @brief Physically reorders the data of all columns to the order of the table.
+         *
+         * Normally sorting only reorders the row indices, so reading the table row by row jumps around the columns.
+         * After clustering, row i is stored at index i of every column so scans and exports read the columns
+         * sequentially. It also frees the space of dropped rows.
+         */
+        void cluster();
+
+        /**
+         * @brief Enables or disables clustered mode.
+         *
+         * In clustered mode the table is clustered (see cluster()) after each sort(). If @a threshold is not zero then
+         * it is also clustered once @a threshold rows have been inserted out of physical order. Freeing the space of
+         * dropped rows always clusters the table.
+         */
+        void setClusteredMode(bool clustered, SizeType threshold = 0);
+
+        /**
+         * @brief Returns true if clustered mode is enabled.
+         */
+        bool isClusteredMode() const;
+
+        /**
+         * @brief Selects the structure which keeps the order of the rows.
+         *
+         * Default is RowIndexKind::VECTOR. With RowIndexKind::TREE insertRow(), dropRow() and access to a row by its
+         * index (e.g. getDataWC()) take O(log n) instead of shifting half of the rows on every insertion and removal,
+         * it is better for big tables which are updated continuously. Order of the rows doesn't change.
+         */
+        void setRowIndexKind(RowIndexKind kind);
+
+        /**
+         * @brief Returns the structure which keeps the order of the rows.
+         */
+        RowIndexKind getRowIndexKind() const noexcept;
+
+        /**
+         * @brief Sets secondary sort keys, rows with equal data in the key column are ordered by @a keys .
+         *
+         * Rows are sorted by the key column (column 0) in the sorting order of the table and then by each column of @a keys in
+         * its own order, e.g. table of sales with key column `region` and @a keys `{{"date", SortingOrder::DESCENDING}, {"id"}}`.
+         * Like the key column, the columns of @a keys can't be changed with setData() or setNull(). Search in the key column
+         * still works as the table remains sorted by it. Pass empty @a keys to remove them.
+         *
+         * If a column doesn't exist, is the key column or is repeated then error message is written to logs, keys are not
+         * changed and false is returned. Else table is sorted and true is returned.
+         */
+        bool setSortKeys(const std::vector<SortKey> &keys);
+
+        /**
+         * @brief Returns secondary sort keys set by setSortKeys().
+         */
+        std::vector<SortKey> getSortKeys() const;
+
+        /**
+         * @brief Returns the memory resource passed to the constructor.
+         */
+        std::pmr::memory_resource *getMemoryResource() const noexcept;
+
         /**
          * @brief Appends a new column with formula.
          *
@@ -110,6 +339,9 @@ namespace km
          * or formula contains any type of error, column is not added and false is returned. But if
          * table has no rows, then @b formula is not evaluated, thus if column name is valid and does
          * not exist in table, then it is added and true is returned.
+         *
+         * @note For big tables rows are evaluated on ThreadPool::instance(), so functions registered in the
+         * FunctionStore are called concurrently and must be thread safe.
          */
         bool addColumnE(const ColumnMetaData &column_data, const std::string &formula);
 
@@ -156,7 +388,8 @@ namespace km
          * @code {.cpp}
          * student.transformColumn("per", "add($per,5.0f)");
          * @endcode
-         * 
+         *
+         * @note Like addColumnE(), big tables are evaluated on ThreadPool::instance().
          */
         bool transformColumn(const std::string &column_name, const std::string &formula);
 
@@ -165,11 +398,49 @@ namespace km
          * 
          * It searches all rows for the data @a data in the given column @a column_name.
          * Returns rows that contains the data. In case of float32 and float64, epsilon set in those columns are used for accuracy.
-         * If @a column_name is the key column then binary search is applied and caused O(logN) time complexity but in case of other
-         * columns, linear search is applied hence causing O(N) complexity.
+         * If @a column_name is the key column then binary search is applied and caused O(logN) time complexity. If the column has
+         * an index (see createIndex()) then it is used, else linear search is applied hence causing O(N) complexity.
          */
         std::vector<IndexType> search(const std::string &column_name, const Variant &data) const;
 
+        /**
+         * @brief Creates an index of kind @a kind on the column @a column_name .
+         *
+         * The index is kept updated on every insertion, removal and change of data and search() uses it instead of
+         * scanning the column. Only one index can exist on a column, so an existing index is replaced.
+         *
+         * IndexKind::HASH is for search() only, IndexKind::ORDERED is also used by searchRange(). If column doesn't exist, it is
+         * the key column (which is already sorted) or @a kind is IndexKind::HASH and column is of float type (epsilon equality
+         * can't be hashed) then error message is written to logs and false is returned. Else it returns true.
+         */
+        bool createIndex(const std::string &column_name, IndexKind kind = IndexKind::HASH);
+
+        /**
+         * @brief Searches the rows whose data in the column @a column_name lies between @a low and @a high .
+         *
+         * Bounds are included if @a low_inclusive and @a high_inclusive are true, nulls are never included. Returned rows are
+         * sorted. For the key column binary search is applied and for a column with IndexKind::ORDERED index the index is used,
+         * both take O(logN + K) time for K rows. For other columns linear search is applied. If column doesn't exist or type of
+         * @a low or @a high doesn't match then no row is returned.
+         *
+         * @code {.cpp}
+         * // students with age in [18, 25)
+         * auto rows = student.searchRange("age", 18, 25, true, false);
+         * @endcode
+         */
+        std::vector<IndexType> searchRange(const std::string &column_name, const Variant &low, const Variant &high,
+                                           bool low_inclusive = true, bool high_inclusive = true) const;
+
+        /**
+         * @brief Removes the index of the column @a column_name , returns false if it has no index.
+         */
+        bool dropIndex(const std::string &column_name);
+
+        /**
+         * @brief Returns true if the column @a column_name has an index.
+         */
+        bool hasIndex(const std::string &column_name) const;
+
         /**
          * @brief Searches the data @a data in the primary column.
          * 
@@ -179,6 +450,26 @@ namespace km
          */
         std::vector<IndexType> searchInKeyColumn(const Variant &data) const;
 
+        /**
+         * @brief Returns typed handle to the column @a column_name .
+         *
+         * The handle reads the data directly from the column as `const Type_ &` without creating Variants, so
+         * it should be preferred for scanning the table. If column doesn't exist, @b Type_ doesn't match the
+         * column's data type or column doesn't use ColumnStorage::DEFAULT then error message is written to logs
+         * and an invalid handle is returned.
+         *
+         * @code {.cpp}
+         * if (auto age = table.columnAs<KInt32>("age"))
+         * {
+         *      KInt64 sum = 0;
+         *      for (IndexType row = 0; row < age.size(); ++row)
+         *          sum += age[row];
+         * }
+         * @endcode
+         */
+        template <typename Type_>
+        ColumnHandle<Type_> columnAs(const std::string &column_name) const;
+
         //pure virtual functions
 
         std::optional<std::pair<IndexType, DataType>> findColumn(const std::string &column_name) const override;
@@ -190,15 +481,34 @@ namespace km
         SizeType columnCount() const override;
         
         // virtual functions
+
+        bool isLess(IndexType row_index1, IndexType row_index2, IndexType column_index) const override;
+        void getBooleanMask(IndexType column_index, BitVector &mask) const override;
         
         /**
          * @brief Set data at the table.
          * 
          * If @a row_index and @a column_index is valid and data contains a value with the required data type
          * it will be set at that location and returns true, false otherwise. If @a column_index == 0 then it
-         * doesn't change the data and returns false. Primary key not editable.
+         * doesn't change the data and returns false. Primary key not editable, neither are the columns of secondary sort keys
+         * (see setSortKeys()).
          */
         bool setData(IndexType row_index, IndexType column_index, const Variant &data) override;
+
+        /**
+         * @brief Sets null at the table.
+         *
+         * If @a row_index and @a column_index is valid, data is marked as null and true is returned, false otherwise.
+         * Like setData(), it doesn't change the first column. setData() clears the null.
+         */
+        bool setNull(IndexType row_index, IndexType column_index);
+
+        bool isNull(IndexType row_index, IndexType column_index) const override;
+        bool getValidityMask(IndexType column_index, BitVector &mask) const override;
+        bool getCandidateMask(IndexType column_index, CompareOp op, const Variant &data, BitVector &mask) const override;
+        SizeType getRadixKeys(IndexType column_index, const std::vector<IndexType> &row_indices, std::vector<uint64_t> &keys) const override;
+        const AbstractColumn *getPhysicalColumn(IndexType column_index, const std::vector<IndexType> *&indices) const override;
+        void setNullOrder(NullOrder null_order) override;
         
         void setEpsilon(const std::string &column_name, const Variant &data) override;
         void reserve(SizeType row_count) override;
@@ -209,18 +519,168 @@ namespace km
     protected:
 
         void setDataWC(IndexType row_index, IndexType column_index, const Variant &data) override;
+        void sortingPaused() override;
+
+        /**
+         * @brief Sorts only the rows appended while sorting was paused and merges them with the rest in linear time.
+         *
+         * Dependent views are notified with rowsInsertionEvent(). If anything other than insertion happened while
+         * sorting was paused (i.e. an event was missed) then it falls back to sort().
+         */
+        void sortPausedRows() override;
 
     // will be made private in next update.
     protected:
-        std::vector<IndexType> m_indices;                   ///< index of the rows inserted in the columns
+        RowIndex m_indices;                                 ///< index of the rows inserted in the columns
         std::vector<AbstractColumnPtr_> m_columns;          ///< list of columns
         std::vector<IndexType> m_free_space;                ///< contains indices which are marked free
         AbstractColumnPtr_ m_base_column;                   ///< the first column
+        std::pmr::memory_resource *const m_resource;        ///< allocates data of the columns
         const Comparator_ m_comparator;                     ///< comparator for the primary column
         SizeType m_mfst;                                    ///< max free space tolerance
+        bool m_clustered_mode;                              ///< physically reorder columns on sort
+        SizeType m_cluster_threshold;                       ///< unclustered insertions that trigger clustering, 0 to never
+        SizeType m_unclustered_count;                       ///< rows inserted out of physical order since last clustering
+        std::vector<std::unique_ptr<SecondaryIndex>> m_secondary_indices; ///< index of each column, null if it has no index
+        std::vector<std::pair<IndexType, SortingOrder>> m_sort_keys;      ///< secondary sort keys, see setSortKeys()
+        SizeType m_paused_row_count;                        ///< rows when sorting was paused, rows after them are appended
+        CompactionMode m_compaction_mode;                   ///< when free space is reclaimed
+        SizeType m_compaction_slice;                        ///< rows reclaimed per step in CompactionMode::INCREMENTAL
+        bool m_compacting;                                  ///< true if incremental compaction has started
 
     private:
-        
+
+        /**
+         * @brief Inserts the row, values of columns for which @a nulls is true are ignored and nulls are inserted.
+         * @a nulls may be empty if there is no null.
+         */
+        template <typename Values_>
+        IndexType insertRow_(Values_ &&values, const std::vector<bool> &nulls) noexcept;
+
+        /**
+         * @brief Indexes the row whose data is written at physical index @a index and places it in the sorted order
+         * (appends it if sorting is paused). Returns its row index.
+         */
+        IndexType placeRow(IndexType index);
+
+        /**
+         * @brief Reclaims free space as per the compaction mode, it is called after insertion and drop.
+         */
+        void reclaimSpace();
+
+        /**
+         * @brief Checks that @a values (with @a nulls , which may be empty) can be a row of the table, logs error if not.
+         */
+        bool isValidRow(const std::vector<Variant> &values, const std::vector<bool> &nulls) const;
+
+        /**
+         * @brief Writes the cells of @a values (except the key) which differ from row @a row_index and emits
+         * dataUpdateEvent() for each of them. If a secondary sort key differs then nothing is written and false is
+         * returned, the row must be inserted again.
+         */
+        bool updateRow(IndexType row_index, const std::vector<Variant> &values, const std::vector<bool> &nulls);
+
+        /**
+         * @brief Implements insertRows(), @a nulls is either empty or has nulls of each row (which may be empty).
+         *
+         * Values of the cells for which @a nulls is true are ignored and nulls are inserted. @a nulls can only be
+         * given with DataLayout::ROW_MAJOR.
+         */
+        bool insertRows_(const std::vector<std::vector<Variant>> &data, DataLayout layout, const std::vector<std::vector<bool>> &nulls) noexcept;
+
+        /**
+         * @brief Implements mergeFrom(), @a nulls is either empty or has nulls of each row (which may be empty).
+         *
+         * All rows are validated before any row is updated, dropped or inserted.
+         */
+        bool mergeRows(const std::vector<std::vector<Variant>> &rows, const std::vector<std::vector<bool>> &nulls) noexcept;
+
+        /**
+         * @brief Data type of the column for a value of type @b Value_ passed to insertRowT().
+         */
+        template <typename Value_>
+        using RowValueType_ = std::conditional_t<k_is_ktype<std::decay_t<Value_>>::value, std::decay_t<Value_>, KString>;
+
+        /**
+         * @brief Writes @a value to @a column (with data type @b Type_ ) at physical index @a index if @a reuse is
+         * true, else appends it.
+         */
+        template <typename Type_, typename Value_>
+        static void writeValue(AbstractColumn *column, Value_ &&value, IndexType index, bool reuse);
+
+        /**
+         * @brief Compares key of physical rows @a index1 and @a index2 according to the sorting order and null order.
+         */
+        bool isKeyLess(IndexType index1, IndexType index2) const;
+
+        /**
+         * @brief Compares physical rows @a index1 and @a index2 by the secondary sort keys.
+         */
+        bool isTieLess(IndexType index1, IndexType index2) const;
+
+        /**
+         * @brief Sorts physical indices @a indices by the key column alone with radix sort, like isKeyLess() does.
+         *
+         * It returns false without touching @a indices if there are secondary sort keys, too few rows or the key column
+         * doesn't support radix keys.
+         */
+        bool radixSortByKey(std::vector<IndexType> &indices) const;
+
+        /**
+         * @brief Returns true if column @a column_index is the key column or a column of secondary sort keys.
+         */
+        bool isSortColumn(IndexType column_index) const noexcept;
+
+        /**
+         * @brief Returns index of the column @a column_index , nullptr if it has no index.
+         */
+        SecondaryIndex *indexOf(IndexType column_index) const noexcept;
+
+        /**
+         * @brief Recreates all indexes, it is needed when physical indices of the rows change.
+         */
+        void rebuildIndexes();
+
+        /**
+         * @brief Adds the row at physical index @a index to all indexes.
+         */
+        void indexRow(IndexType index);
+
+        /**
+         * @brief Removes the row at physical index @a index from all indexes.
+         */
+        void unindexRow(IndexType index);
+
+        /**
+         * @brief Maps physical indices @a indices to row indices using the sorted key column, result is sorted. See findRows().
+         */
+        std::vector<IndexType> rowsOf(const std::vector<IndexType> &indices) const;
+
+        /**
+         * @brief Sets @a row_indices to the row index of each physical index of @a indices , all must belong to rows.
+         *
+         * A few indices having keys with few duplicates are searched among the rows with their keys. Else positions of all
+         * the rows are found in a single pass, RowIndex::positionOf() keeps them until the order of rows changes, so
+         * further calls cost O(1) per index.
+         */
+        void findRows(const std::vector<IndexType> &indices, std::vector<IndexType> &row_indices) const;
+
+        /**
+         * @brief Sets nulls of column @a column_index after evaluating a formula with @a tokens.
+         *
+         * Data is null wherever any column referred by @a tokens is null, it is computed by ANDing validity bitmaps.
+         */
+        void propagateNulls(IndexType column_index, const std::vector<parse::Token> &tokens);
+
+        /**
+         * @brief Evaluates @a tokens for every row and writes the results to column @a column_index .
+         *
+         * For big tables the rows are split in contiguous ranges across ThreadPool::instance(), each range is evaluated
+         * with its own stack directly into the column (see AbstractColumn::beginConcurrentWrites()). Every row is
+         * computed independently, so the result is same for any number of threads.
+         */
+        void evaluateColumn(IndexType column_index, const std::vector<parse::Token> &tokens);
+
         /**
          * @brief Frees the space occupied by the column and shrinks it to fit the table.
          *
@@ -239,6 +699,77 @@ namespace km
          * error message is written to logs and false is returned. If everything is fine then true is returned.
          */
         bool validateForNewColumn(const std::string &column, DataType data_type);
+
+        template <typename Type_>
+        friend class ColumnHandle;
+    };
+
+    /**
+     * @brief ColumnHandle provides typed read only access to a column of a @ref Table.
+     *
+     * It is created by Table::columnAs(). Rows are relative to the table (in sorted order) and data is
+     * read directly from the underlying Column\<Type_\>. It refers to the table, not the data, so it stays
+     * valid as long as the table exists even if rows are inserted or dropped.
+     *
+     * @warning An invalid handle (see isValid()) must not be accessed.
+     */
+    template <typename Type_>
+    class ColumnHandle
+    {
+    public:
+        using const_reference = typename Column<Type_>::const_reference;
+
+        /**
+         * @brief Constructs an invalid handle.
+         */
+        ColumnHandle() noexcept : m_table(nullptr), m_column_index(INVALID_INDEX) {}
+
+        /**
+         * @brief Returns true if handle refers to a column.
+         */
+        bool isValid() const noexcept { return m_table != nullptr; }
+
+        /**
+         * @brief Same as isValid().
+         */
+        explicit operator bool() const noexcept { return isValid(); }
+
+        /**
+         * @brief Returns index of the column in the table.
+         */
+        IndexType columnIndex() const noexcept { return m_column_index; }
+
+        /**
+         * @brief Returns number of rows in the table.
+         */
+        SizeType size() const noexcept { return m_table->rowCount(); }
+
+        /**
+         * @brief Returns the data at @a row_index without bound checking.
+         */
+        const_reference operator[](IndexType row_index) const noexcept
+        {
+            return column().getValue(m_table->m_indices[row_index]);
+        }
+
+        /**
+         * @brief Returns the underlying column.
+         *
+         * It can be used to get a span over the storage (see Column::getSpan()), but the span follows
+         * the physical order of the rows, not the order of the table.
+         */
+        const Column<Type_> &column() const noexcept
+        {
+            return *static_cast<const Column<Type_> *>(m_table->m_columns[m_column_index]);
+        }
+
+    private:
+        ColumnHandle(const Table *table, IndexType column_index) noexcept : m_table(table), m_column_index(column_index) {}
+
+        const Table *m_table;
+        IndexType m_column_index;
+
+        friend class Table;
     };
 
     inline void Table::setMaxFreeSpaceTolerance(SizeType size)
@@ -251,6 +782,26 @@ namespace km
         return m_mfst;
     }
 
+    inline CompactionMode Table::getCompactionMode() const noexcept
+    {
+        return m_compaction_mode;
+    }
+
+    inline bool Table::isClusteredMode() const
+    {
+        return m_clustered_mode;
+    }
+
+    inline RowIndexKind Table::getRowIndexKind() const noexcept
+    {
+        return m_indices.kind();
+    }
+
+    inline std::pmr::memory_resource *Table::getMemoryResource() const noexcept
+    {
+        return m_resource;
+    }
+
     inline SizeType Table::rowCount() const
     {
         return m_indices.size();
@@ -266,6 +817,144 @@ namespace km
         return m_columns[column_index]->getData(m_indices[row_index]);
     }
 
+    inline bool Table::isLess(IndexType row_index1, IndexType row_index2, IndexType column_index) const
+    {
+        return m_columns[column_index]->isLess(m_indices[row_index1], m_indices[row_index2]);
+    }
+
+    inline bool Table::isKeyLess(IndexType index1, IndexType index2) const
+    {
+        if (m_base_column->hasValidity())
+        {
+            const bool null1 = m_base_column->isNull(index1), null2 = m_base_column->isNull(index2);
+            if (null1 != null2)
+                return null1 == (getNullOrder() == NullOrder::FIRST);
+            if (null1)
+                return !m_sort_keys.empty() && isTieLess(index1, index2);
+        }
+        if (m_sort_keys.empty())
+            return (m_base_column->*m_comparator)(index1, index2);
+        if ((m_base_column->*m_comparator)(index1, index2))
+            return true;
+        return !(m_base_column->*m_comparator)(index2, index1) && isTieLess(index1, index2);
+    }
+
+    inline SecondaryIndex *Table::indexOf(IndexType column_index) const noexcept
+    {
+        return column_index < m_secondary_indices.size() ? m_secondary_indices[column_index].get() : nullptr;
+    }
+
+    template <typename... Values_>
+    IndexType Table::insertRowT(Values_ &&...values) noexcept
+    {
+        if (sizeof...(Values_) != m_columns.size())
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ InvalidArgs") << "Invalid number of values are given to insert.");
+            return INVALID_INDEX;
+        }
+        IndexType column_index = 0;
+        if (!(... && (m_columns[column_index++]->getDataType() == dataTypeFor<RowValueType_<Values_>>())))
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ DataType") << "Couldn't insert the row, insertion failed due to `type mismatch`.");
+            return INVALID_INDEX;
+        }
+
+        const bool reuse = !m_free_space.empty();
+        const IndexType index = reuse ? m_free_space.back() : m_indices.size();
+        column_index = 0;
+        try
+        {
+            ((writeValue<RowValueType_<Values_>>(m_columns[column_index], std::forward<Values_>(values), index, reuse), ++column_index), ...);
+        }
+        catch (const std::exception &e)
+        {
+            if (!reuse)
+            {
+                while (column_index-- > 0)
+                    m_columns[column_index]->popData(); // clean the data
+            }
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ UnknownException") << "Unknown excepton caught `" << e.what() << "`.");
+            return INVALID_INDEX;
+        }
+        if (reuse)
+            m_free_space.pop_back();
+        try
+        {
+            for (AbstractColumnPtr_ column : m_columns)
+                column->setNull(index, false); // clears nulls left by the dropped row
+            return placeRow(index);
+        }
+        catch (const std::exception &e)
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ UnknownException") << "Unknown excepton caught `" << e.what() << "`.");
+        }
+        return INVALID_INDEX;
+    }
+
+    template <typename Type_, typename Value_>
+    void Table::writeValue(AbstractColumn *column, Value_ &&value, IndexType index, bool reuse)
+    {
+        static_assert(std::is_constructible_v<Type_, Value_ &&>, "Value can't be converted to any data type of the columns");
+        auto write = [&value, index, reuse](auto *typed_column)
+        {
+            if constexpr (std::is_same_v<std::decay_t<Value_>, Type_>)
+            {
+                if (reuse)
+                    typed_column->setValue(std::forward<Value_>(value), index);
+                else
+                    typed_column->pushValue(std::forward<Value_>(value));
+            }
+            else // e.g. string literal
+            {
+                if (reuse)
+                    typed_column->setValue(Type_(std::forward<Value_>(value)), index);
+                else
+                    typed_column->pushValue(Type_(std::forward<Value_>(value)));
+            }
+        };
+        // column type depends on the storage, see createColumn().
+        const ColumnStorage storage = column->getMetaData().storage;
+        if constexpr (std::is_same_v<Type_, KString>)
+        {
+            if (storage == ColumnStorage::DICTIONARY)
+                return write(static_cast<DictionaryColumn *>(column));
+            else if (storage == ColumnStorage::ARENA)
+                return write(static_cast<ArenaStringColumn *>(column));
+        }
+        if constexpr (!std::is_same_v<Type_, KBoolean>)
+        {
+            if (storage == ColumnStorage::CHUNKED)
+                return write(static_cast<ChunkedColumn<Type_> *>(column));
+        }
+        write(static_cast<Column<Type_> *>(column));
+    }
+
+    template <typename Type_>
+    ColumnHandle<Type_> Table::columnAs(const std::string &column_name) const
+    {
+        const auto found_column = findColumn(column_name);
+        if (!found_column)
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ Name") << "Column `" << column_name << "` doesn't exist in this table.");
+            return {};
+        }
+        const auto &[column_index, data_type] = found_column.value();
+        if (data_type != dataTypeFor<Type_>())
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ DataType") << "Column `" << column_name << "` has type `"
+                                                                           << data_type << "` but requested type is `"
+                                                                           << dataTypeFor<Type_>() << "`.");
+            return {};
+        }
+        else if (!dynamic_cast<const Column<Type_> *>(m_columns[column_index]))
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ Storage") << "Column `" << column_name
+                                                                          << "` doesn't use default storage, typed access is not available.");
+            return {};
+        }
+        return {this, column_index};
+    }
+
     template <typename Fnc, class... Args>
     bool Table::addColumnF(const ColumnMetaData &column, Fnc functor, Args... args)
     {
@@ -273,7 +962,7 @@ namespace km
             return false;
 
         AbstractColumnPtr_ column_ptr = nullptr;
-        createColumn(column_ptr, column.column_name, column.display_name, column.data_type);
+        createColumn(column_ptr, column.column_name, column.display_name, column.data_type, column.storage, m_resource);
         IndexType row_count = rowCount();
         try
         {
@@ -0,0 +1,189 @@
+/**
+ * @file ThreadPool.hpp
+ * @author Keshav Sahu
+ * @date May 1st 2022
+ * @brief This file contains ThreadPool used by the library and parallelStableSort() built on it.
+ */
+
+#ifndef KMTABLELIB_KMT_THREADPOOL_HPP
+#define KMTABLELIB_KMT_THREADPOOL_HPP
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <exception>
+
+#include "Types.hpp"
+
+namespace km
+{
+    /**
+     * @brief ThreadPool is the pool of worker threads owned by the library.
+     *
+     * There is a single pool (see instance()), it is used for heavy operations like sorting of big tables. By default it
+     * has as many threads as std::thread::hardware_concurrency(), it can be changed with setThreadCount(), e.g. to 1 to
+     * disable parallelism. Threads are started on first use.
+     *
+     * @code {.cpp}
+     * km::ThreadPool::instance().setThreadCount(8);
+     * table.sort(); // uses 8 threads
+     * @endcode
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * @brief Returns the pool used by the library.
+         */
+        static ThreadPool &instance();
+
+        /**
+         * @brief Sets number of threads used by parallel operations including the calling thread, 0 for
+         * std::thread::hardware_concurrency(). It waits for the running job to finish, it must not be called from a task.
+         */
+        void setThreadCount(SizeType thread_count);
+
+        /**
+         * @brief Returns number of threads used by parallel operations including the calling thread.
+         */
+        SizeType getThreadCount() const noexcept;
+
+        /**
+         * @brief Calls @a fnc(i) for each i in [0, @a count) on the pool and waits for all of them.
+         *
+         * The calling thread also runs the tasks. If it is called from a task itself then tasks run on the calling
+         * thread only. If any call throws, the first exception is rethrown after all tasks are finished.
+         */
+        void parallelFor(SizeType count, const std::function<void(IndexType)> &fnc);
+
+        ~ThreadPool();
+
+    private:
+        ThreadPool();
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        void start();
+        void stop();
+        void work();
+
+        std::vector<std::thread> m_workers;           ///< threads other than the calling thread
+        std::mutex m_job_mutex;                       ///< allows one job at a time
+        std::mutex m_mutex;                           ///< guards the state of the current job
+        std::condition_variable m_job_cv;             ///< notifies workers of a new job or stop
+        std::condition_variable m_done_cv;            ///< notifies the calling thread when all tasks are done
+        const std::function<void(IndexType)> *m_job;  ///< current job, nullptr if there is none
+        SizeType m_job_size;                          ///< number of tasks in current job
+        IndexType m_next_task;                        ///< next task to be picked
+        SizeType m_pending_tasks;                     ///< tasks not finished yet
+        std::exception_ptr m_exception;               ///< first exception thrown by a task
+        std::atomic<SizeType> m_thread_count;         ///< threads including the calling thread, read without lock
+        bool m_stop;                                  ///< asks workers to exit
+    };
+
+    /**
+     * @brief Minimum number of elements for which parallelStableSort() uses more than one thread.
+     */
+    constexpr SizeType k_parallel_sort_threshold = SizeType(1) << 15;
+
+    /**
+     * @brief Sorts [@a first, @a last) with @a comp like std::stable_sort() but on ThreadPool::instance().
+     *
+     * Range is split into one chunk per thread, chunks are sorted in parallel and then merged pairwise, each merge
+     * is also split into independent parts so all threads are busy till the last merge. Equal elements keep their
+     * order, so the result is exactly same as std::stable_sort() whatever the number of threads is. @a comp is
+     * called concurrently, so it must not modify anything.
+     */
+    template <typename RandomIt_, typename Compare_>
+    void parallelStableSort(RandomIt_ first, RandomIt_ last, Compare_ comp)
+    {
+        using Value_ = typename std::iterator_traits<RandomIt_>::value_type;
+        ThreadPool &pool = ThreadPool::instance();
+        const SizeType size = std::distance(first, last);
+        const SizeType thread_count = pool.getThreadCount();
+        if (thread_count < 2 || size < k_parallel_sort_threshold)
+        {
+            std::stable_sort(first, last, comp);
+            return;
+        }
+
+        // run boundaries, run i is [bounds[i], bounds[i + 1]).
+        std::vector<SizeType> bounds(thread_count + 1);
+        for (IndexType i = 0; i <= thread_count; ++i)
+            bounds[i] = size * i / thread_count;
+        pool.parallelFor(thread_count, [&](IndexType i)
+                         { std::stable_sort(first + bounds[i], first + bounds[i + 1], comp); });
+
+        std::vector<Value_> buffer(size);
+        bool in_buffer = false; // where the sorted runs are
+        struct Part
+        {
+            SizeType left_begin, left_end, right_begin, right_end, output;
+        };
+        std::vector<Part> parts;
+        std::vector<SizeType> new_bounds;
+        while (bounds.size() > 2)
+        {
+            // every pair of adjacent runs is split into parts at points of the left run, elements of the right run which
+            // are less than a point go before it, so equal elements of the left run stay before those of the right run.
+            const SizeType run_count = bounds.size() - 1;
+            const SizeType parts_per_pair = std::max<SizeType>(1, thread_count / (run_count / 2));
+            parts.clear();
+            new_bounds.clear();
+            for (IndexType run = 0; run < run_count; run += 2)
+            {
+                const SizeType left_begin = bounds[run], right_begin = bounds[run + 1];
+                new_bounds.push_back(left_begin);
+                if (run + 1 == run_count) // last run has no pair, it is copied as it is
+                {
+                    parts.push_back({left_begin, right_begin, right_begin, right_begin, left_begin});
+                    continue;
+                }
+                const SizeType right_end = bounds[run + 2];
+                SizeType previous_left = left_begin, previous_right = right_begin;
+                for (IndexType p = 1; p <= parts_per_pair; ++p)
+                {
+                    SizeType left = right_begin, right = right_end;
+                    if (p != parts_per_pair)
+                    {
+                        left = left_begin + (right_begin - left_begin) * p / parts_per_pair;
+                        if (in_buffer)
+                            right = std::lower_bound(buffer.begin() + previous_right, buffer.begin() + right_end, buffer[left], comp) - buffer.begin();
+                        else
+                            right = std::lower_bound(first + previous_right, first + right_end, first[left], comp) - first;
+                    }
+                    parts.push_back({previous_left, left, previous_right, right, previous_left + previous_right - right_begin});
+                    previous_left = left;
+                    previous_right = right;
+                }
+            }
+            new_bounds.push_back(size);
+
+            pool.parallelFor(parts.size(), [&](IndexType i)
+                             {
+                                 const Part &part = parts[i];
+                                 if (in_buffer)
+                                     std::merge(std::make_move_iterator(buffer.begin() + part.left_begin), std::make_move_iterator(buffer.begin() + part.left_end),
+                                                std::make_move_iterator(buffer.begin() + part.right_begin), std::make_move_iterator(buffer.begin() + part.right_end),
+                                                first + part.output, comp);
+                                 else
+                                     std::merge(std::make_move_iterator(first + part.left_begin), std::make_move_iterator(first + part.left_end),
+                                                std::make_move_iterator(first + part.right_begin), std::make_move_iterator(first + part.right_end),
+                                                buffer.begin() + part.output, comp); });
+            in_buffer = !in_buffer;
+            bounds.swap(new_bounds);
+        }
+        if (in_buffer)
+        {
+            pool.parallelFor(thread_count, [&](IndexType i)
+                             { std::move(buffer.begin() + size * i / thread_count, buffer.begin() + size * (i + 1) / thread_count, first + size * i / thread_count); });
+        }
+    }
+}
+
+#endif // KMTABLELIB_KMT_THREADPOOL_HPP
@@ -131,6 +131,109 @@ namespace km
         return d.year * 10000 + d.month * 100 + d.day;
     }
 
+    /**
+     * @brief Converts date time into integer (yyyyMMddhhmmss), so it can be compared with a single comparison.
+     */
+    constexpr inline int64_t integralRepresentationOf(KDateTime dt)
+    {
+        return int64_t(integralRepresentationOf(dt.date)) * 1000000 + dt.time.hour * 10000 + dt.time.minute * 100 + dt.time.second;
+    }
+
+    /**
+     * @brief Converts @a date to an integer key, keys are in the order of year, month and day.
+     *
+     * Every date, valid or not, has its own key, so fromDateKey() gives back the same date. Columns of DataType::DATE
+     * store dates as keys, so they are compared with a single integer comparison.
+     */
+    constexpr inline int32_t toDateKey(KDate date)
+    {
+        return (int32_t(date.year) - 32768) * 65536 + date.month * 256 + date.day;
+    }
+
+    /**
+     * @brief Converts key @a key to date. It is inverse of toDateKey().
+     */
+    constexpr inline KDate fromDateKey(int32_t key)
+    {
+        const int64_t packed = int64_t(key) + 2147483648LL; // year, month and day in 4 bytes
+        return KDate{uint16_t(packed >> 16), uint8_t((packed >> 8) & 0xFF), uint8_t(packed & 0xFF)};
+    }
+
+    /**
+     * @brief Converts @a date_time to an integer key, keys are in the order of date, hour, minute and second.
+     *
+     * Every date time, valid or not, has its own key, so fromDateTimeKey() gives back the same date time.
+     */
+    constexpr inline int64_t toDateTimeKey(KDateTime date_time)
+    {
+        return int64_t(toDateKey(date_time.date)) * 16777216 + date_time.time.hour * 65536 + date_time.time.minute * 256 + date_time.time.second;
+    }
+
+    /**
+     * @brief Converts key @a key to date time. It is inverse of toDateTimeKey().
+     */
+    constexpr inline KDateTime fromDateTimeKey(int64_t key)
+    {
+        const int64_t time = key & 0xFFFFFF; // hour, minute and second in the last 3 bytes
+        return KDateTime{fromDateKey(int32_t((key - time) / 16777216)), {uint8_t(time >> 16), uint8_t((time >> 8) & 0xFF), uint8_t(time & 0xFF)}};
+    }
+
+    /**
+     * @brief Converts @a date to number of days since 1st January 1970 (negative for dates before it).
+     *
+     * @a date must be valid, else it is normalized (e.g. 30/02/2022 is same as 02/03/2022).
+     */
+    constexpr inline int32_t toEpochDays(KDate date)
+    {
+        // proleptic gregorian calendar with years starting from 1st March, so leap day is the last day of the year.
+        const int32_t year = int32_t(date.year) - (date.month <= 2);
+        const int32_t era = (year >= 0 ? year : year - 399) / 400;
+        const int32_t year_of_era = year - era * 400;
+        const int32_t day_of_year = (153 * ((date.month + 9) % 12) + 2) / 5 + date.day - 1;
+        const int32_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        return era * 146097 + day_of_era - 719468;
+    }
+
+    /**
+     * @brief Converts number of days since 1st January 1970 @a days to date. It is inverse of toEpochDays().
+     */
+    constexpr inline KDate fromEpochDays(int32_t days)
+    {
+        days += 719468;
+        const int32_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const int32_t day_of_era = days - era * 146097;
+        const int32_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+        const int32_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+        const int32_t month = (5 * day_of_year + 2) / 153; // 0 for March
+        const int32_t day = day_of_year - (153 * month + 2) / 5 + 1;
+        const int32_t real_month = month < 10 ? month + 3 : month - 9;
+        return KDate{uint16_t(year_of_era + era * 400 + (real_month <= 2)), uint8_t(real_month), uint8_t(day)};
+    }
+
+    /**
+     * @brief Converts @a date_time to number of seconds since 1st January 1970 00:00:00.
+     */
+    constexpr inline int64_t toEpochSeconds(KDateTime date_time)
+    {
+        return int64_t(toEpochDays(date_time.date)) * 86400 + toSeconds(date_time.time);
+    }
+
+    /**
+     * @brief Converts number of seconds since 1st January 1970 00:00:00 @a seconds to date time. It is inverse
+     * of toEpochSeconds().
+     */
+    constexpr inline KDateTime fromEpochSeconds(int64_t seconds)
+    {
+        int64_t days = seconds / 86400;
+        int64_t rest = seconds % 86400;
+        if (rest < 0)
+        {
+            rest += 86400;
+            --days;
+        }
+        return KDateTime{fromEpochDays(int32_t(days)), {uint8_t(rest / 3600), uint8_t(rest / 60 % 60), uint8_t(rest % 60)}};
+    }
+
     /**
      * @brief Checks if @a date1 and @a date2 are equal. If any of them is invalid then result may not be correct.
      */
@@ -209,13 +312,7 @@ namespace km
      */
     constexpr bool operator>(const KDateTime &date_time1, const KDateTime &date_time2)
     {
-        if (date_time1.date > date_time2.date)
-            return true;
-        else if (date_time1.date < date_time2.date)
-            return false;
-        const auto value1 = toSeconds(date_time1.time);
-        const auto value2 = toSeconds(date_time2.time);
-        return value1 > value2;
+        return integralRepresentationOf(date_time1) > integralRepresentationOf(date_time2);
     }
 
     /**
@@ -223,13 +320,7 @@ namespace km
      */
     constexpr bool operator<(const KDateTime &date_time1, const KDateTime &date_time2)
     {
-        if (date_time1.date < date_time2.date)
-            return true;
-        else if (date_time1.date > date_time2.date)
-            return false;
-        const auto value1 = toSeconds(date_time1.time);
-        const auto value2 = toSeconds(date_time2.time);
-        return value1 < value2;
+        return integralRepresentationOf(date_time1) < integralRepresentationOf(date_time2);
     }
 
     /**
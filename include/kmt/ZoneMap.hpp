@@ -0,0 +1,220 @@
+/**
+ * @file ZoneMap.hpp
+ * @author Keshav Sahu
+ * @date May 1st 2022
+ * @brief This file contains ZoneMap class, per block min/max statistics of a column.
+ */
+
+#ifndef KMTABLELIB_KMT_ZONEMAP_HPP
+#define KMTABLELIB_KMT_ZONEMAP_HPP
+
+#include <vector>
+#include <memory_resource>
+#include <cstdint>
+#include <type_traits>
+
+#include "Types.hpp"
+#include "BitVector.hpp"
+
+namespace km
+{
+    /**
+     * @brief CompareOp is the comparison of a simple predicate like `isGreater($price, 1000)`.
+     */
+    enum class CompareOp : uint8_t
+    {
+        LESS,             ///< value < data
+        LESS_OR_EQUAL,    ///< value <= data
+        EQUAL,            ///< value == data
+        GREATER_OR_EQUAL, ///< value >= data
+        GREATER           ///< value > data
+    };
+
+    /**
+     * @brief Returns the comparison with swapped operands, e.g. LESS for GREATER.
+     */
+    constexpr CompareOp swapOperands(CompareOp op) noexcept
+    {
+        return static_cast<CompareOp>(static_cast<uint8_t>(CompareOp::GREATER) - static_cast<uint8_t>(op));
+    }
+
+    /**
+     * @brief Block size of the zone maps, it is same for every type.
+     */
+    struct ZoneMapBase
+    {
+        static constexpr SizeType k_block_shift = 12;
+        static constexpr SizeType k_block_size = SizeType(1) << k_block_shift; ///< values per block, multiple of 64
+    };
+
+    /**
+     * @brief ZoneMap keeps min and max of every block of k_block_size values of a column.
+     *
+     * The range of a block is only widened by push_back() and update(), so after overwriting or removing
+     * a value it may be wider than the actual range. It is still safe for skipping blocks: a block is skipped
+     * only if no value in its range can satisfy the predicate. NaNs are not included as they never satisfy
+     * a comparison.
+     */
+    template <typename Value_>
+    class ZoneMap : public ZoneMapBase
+    {
+    public:
+        /**
+         * @brief Constructs an empty ZoneMap whose zones are allocated from @a resource .
+         */
+        explicit ZoneMap(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) : m_zones(resource), m_size(0), m_suspended(false) {}
+
+        /**
+         * @brief Returns number of values.
+         */
+        SizeType size() const noexcept { return m_size; }
+
+        /**
+         * @brief Returns number of blocks.
+         */
+        SizeType blockCount() const noexcept { return m_zones.size(); }
+
+        /**
+         * @brief Returns false if block @a block_index has no value (other than NaN).
+         */
+        bool hasRange(IndexType block_index) const noexcept { return m_zones[block_index].has_range; }
+
+        /**
+         * @brief Returns min of block @a block_index . It is valid only if hasRange() is true.
+         */
+        const Value_ &min(IndexType block_index) const noexcept { return m_zones[block_index].min; }
+
+        /**
+         * @brief Returns max of block @a block_index . It is valid only if hasRange() is true.
+         */
+        const Value_ &max(IndexType block_index) const noexcept { return m_zones[block_index].max; }
+
+        /**
+         * @brief Appends @a value , starts a new block if the last one is full.
+         */
+        void push_back(const Value_ &value)
+        {
+            if (m_size % k_block_size == 0)
+                m_zones.emplace_back();
+            ++m_size;
+            include(m_zones.back(), value);
+        }
+
+        /**
+         * @brief Removes the last value, the range of its block is kept as it is.
+         */
+        void pop_back()
+        {
+            if (m_size == 0)
+                return;
+            if (--m_size % k_block_size == 0)
+                m_zones.pop_back();
+        }
+
+        /**
+         * @brief Includes @a value (which is stored at @a index ) in the range of its block.
+         */
+        void update(IndexType index, const Value_ &value) noexcept
+        {
+            if (!m_suspended)
+                include(m_zones[index >> k_block_shift], value);
+        }
+
+        /**
+         * @brief Makes update() do nothing till the next rebuild(), so that values can be written by many threads.
+         */
+        void suspend() noexcept { m_suspended = true; }
+
+        /**
+         * @brief Removes all values.
+         */
+        void clear() noexcept
+        {
+            m_zones.clear();
+            m_size = 0;
+        }
+
+        /**
+         * @brief Recomputes the zones from @a values , which must be indexable and have size().
+         */
+        template <typename Container_>
+        void rebuild(const Container_ &values)
+        {
+            clear();
+            m_suspended = false;
+            m_zones.reserve((values.size() + k_block_size - 1) >> k_block_shift);
+            for (IndexType i = 0, size = values.size(); i < size; ++i)
+                push_back(values[i]);
+        }
+
+        /**
+         * @brief Returns true if a value of block @a block_index may satisfy `value op data`.
+         */
+        bool mayMatch(IndexType block_index, CompareOp op, const Value_ &data) const noexcept
+        {
+            const Zone &zone = m_zones[block_index];
+            if (!zone.has_range)
+                return false;
+            switch (op)
+            {
+            case CompareOp::LESS:
+                return zone.min < data;
+            case CompareOp::LESS_OR_EQUAL:
+                return zone.min <= data;
+            case CompareOp::EQUAL:
+                return zone.min <= data && data <= zone.max;
+            case CompareOp::GREATER_OR_EQUAL:
+                return zone.max >= data;
+            case CompareOp::GREATER:
+                return zone.max > data;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Sets bit i of @a blocks if block i may satisfy `value op data`.
+         */
+        void getCandidates(CompareOp op, const Value_ &data, BitVector &blocks) const
+        {
+            blocks.clear();
+            blocks.resize(m_zones.size());
+            for (IndexType i = 0, size = m_zones.size(); i < size; ++i)
+            {
+                if (mayMatch(i, op, data))
+                    blocks.set(i, true);
+            }
+        }
+
+    private:
+        struct Zone
+        {
+            Value_ min{};
+            Value_ max{};
+            bool has_range = false;
+        };
+
+        static void include(Zone &zone, const Value_ &value) noexcept
+        {
+            if constexpr (std::is_floating_point_v<Value_>)
+            {
+                if (value != value) // NaN
+                    return;
+            }
+            if (!zone.has_range)
+            {
+                zone.min = zone.max = value;
+                zone.has_range = true;
+            }
+            else if (value < zone.min)
+                zone.min = value;
+            else if (zone.max < value)
+                zone.max = value;
+        }
+
+        std::pmr::vector<Zone> m_zones;
+        SizeType m_size;
+        bool m_suspended;
+    };
+}
+
+#endif // KMTABLELIB_KMT_ZONEMAP_HPP
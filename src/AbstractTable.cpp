@@ -5,45 +5,75 @@ namespace km
 {
     KM_SIGNAL void AbstractTable::dataUpdateEvent(IndexType row_index, IndexType column_index, const Variant &old_data)
     {
-        if (shouldProcessEvent())
+        if (!shouldProcessEvent())
+            m_missed_event = true;
+        else
             for (auto &view : m_dependent_views)
                 view->dataUpdated(row_index, column_index, old_data);
     }
     KM_SIGNAL void AbstractTable::rowInsertionEvent(IndexType row_index)
     {
-        if (shouldProcessEvent())
+        if (!shouldProcessEvent())
+            m_missed_event = true;
+        else
             for (auto &view : m_dependent_views)
                 view->rowInserted(row_index);
     }
+    KM_SIGNAL void AbstractTable::rowsInsertionEvent(const std::vector<IndexType> &row_indices)
+    {
+        if (!shouldProcessEvent())
+            m_missed_event = true;
+        else
+            for (auto &view : m_dependent_views)
+                view->rowsInserted(row_indices);
+    }
     KM_SIGNAL void AbstractTable::rowDropEvent(IndexType row_index)
     {
-        if (shouldProcessEvent())
+        if (!shouldProcessEvent())
+            m_missed_event = true;
+        else
             for (auto &view : m_dependent_views)
                 view->rowDropped(row_index);
     }
+    KM_SIGNAL void AbstractTable::rowsDropEvent(const std::vector<IndexType> &row_indices)
+    {
+        if (!shouldProcessEvent())
+            m_missed_event = true;
+        else
+            for (auto &view : m_dependent_views)
+                view->rowsDropped(row_indices);
+    }
 
     KM_SIGNAL void AbstractTable::refreshEvent()
     {
-        if (shouldProcessEvent())
+        if (!shouldProcessEvent())
+            m_missed_event = true;
+        else
             for (auto &view : m_dependent_views)
                 view->refresh();
     }
 
     KM_SIGNAL void AbstractTable::sourceReversedEvent()
     {
-        if (shouldProcessEvent())
+        if (!shouldProcessEvent())
+            m_missed_event = true;
+        else
             for (auto &view : m_dependent_views)
                 view->sourceReversed();
     }
     KM_SIGNAL void AbstractTable::sourceSortedEvent()
     {
-        if (shouldProcessEvent())
+        if (!shouldProcessEvent())
+            m_missed_event = true;
+        else
             for (auto &view : m_dependent_views)
                 view->sourceSorted();
     }
     KM_SIGNAL void AbstractTable::columnTransformedEvent(IndexType column_index)
     {
-        if (shouldProcessEvent())
+        if (!shouldProcessEvent())
+            m_missed_event = true;
+        else
             for (auto &view : m_dependent_views)
                 view->columnTransformed(column_index);
     }
@@ -53,33 +83,73 @@ namespace km
         for (auto &view : m_dependent_views)
             view->sourceAboutToBeDestructed();
     }
-    void createColumn(AbstractColumnPtr_ &column_ptr, const std::string &column_name, const std::string &display_name, DataType data_type)
+    void createColumn(AbstractColumnPtr_ &column_ptr, const std::string &column_name, const std::string &display_name, DataType data_type, ColumnStorage storage,
+                      std::pmr::memory_resource *resource)
     {
+        if (data_type == DataType::STRING && storage == ColumnStorage::DICTIONARY)
+        {
+            column_ptr = new DictionaryColumn(column_name, display_name, resource);
+            return;
+        }
+        else if (data_type == DataType::STRING && storage == ColumnStorage::ARENA)
+        {
+            column_ptr = new ArenaStringColumn(column_name, display_name, resource);
+            return;
+        }
+        else if (storage == ColumnStorage::CHUNKED)
+        {
+            switch (data_type)
+            {
+            case DataType::INT32:
+                column_ptr = new ChunkedColumn<KInt32>(column_name, display_name, resource);
+                return;
+            case DataType::INT64:
+                column_ptr = new ChunkedColumn<KInt64>(column_name, display_name, resource);
+                return;
+            case DataType::FLOAT32:
+                column_ptr = new ChunkedColumn<KFloat32>(column_name, display_name, resource);
+                return;
+            case DataType::FLOAT64:
+                column_ptr = new ChunkedColumn<KFloat64>(column_name, display_name, resource);
+                return;
+            case DataType::STRING:
+                column_ptr = new ChunkedColumn<KString>(column_name, display_name, resource);
+                return;
+            case DataType::DATE:
+                column_ptr = new ChunkedColumn<KDate>(column_name, display_name, resource);
+                return;
+            case DataType::DATE_TIME:
+                column_ptr = new ChunkedColumn<KDateTime>(column_name, display_name, resource);
+                return;
+            default: // BOOLEAN is already bit packed
+                break;
+            }
+        }
         switch (data_type)
         {
         case DataType::INT32:
-            column_ptr = new Column<KInt32>(column_name, display_name);
+            column_ptr = new Column<KInt32>(column_name, display_name, resource);
             break;
         case DataType::INT64:
-            column_ptr = new Column<KInt64>(column_name, display_name);
+            column_ptr = new Column<KInt64>(column_name, display_name, resource);
             break;
         case DataType::FLOAT32:
-            column_ptr = new Column<KFloat32>(column_name, display_name);
+            column_ptr = new Column<KFloat32>(column_name, display_name, resource);
             break;
         case DataType::FLOAT64:
-            column_ptr = new Column<KFloat64>(column_name, display_name);
+            column_ptr = new Column<KFloat64>(column_name, display_name, resource);
             break;
         case DataType::STRING:
-            column_ptr = new Column<KString>(column_name, display_name);
+            column_ptr = new Column<KString>(column_name, display_name, resource);
             break;
         case DataType::BOOLEAN:
-            column_ptr = new Column<KBoolean>(column_name, display_name);
+            column_ptr = new Column<KBoolean>(column_name, display_name, resource);
             break;
         case DataType::DATE:
-            column_ptr = new Column<KDate>(column_name, display_name);
+            column_ptr = new Column<KDate>(column_name, display_name, resource);
             break;
         case DataType::DATE_TIME:
-            column_ptr = new Column<KDateTime>(column_name, display_name);
+            column_ptr = new Column<KDateTime>(column_name, display_name, resource);
             break;
         default:
             column_ptr = nullptr;
@@ -10,6 +10,18 @@ namespace km
             m_source_table->installView(this);
     }
 
+    KM_SLOT void AbstractView::rowsInserted(const std::vector<IndexType> &row_indices)
+    {
+        for (IndexType row_index : row_indices)
+            rowInserted(row_index);
+    }
+
+    KM_SLOT void AbstractView::rowsDropped(const std::vector<IndexType> &row_indices)
+    {
+        for (auto it = row_indices.rbegin(); it != row_indices.rend(); ++it)
+            rowDropped(*it);
+    }
+
     AbstractView::~AbstractView()
     {
         if (m_source_table)
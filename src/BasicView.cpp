@@ -5,6 +5,7 @@
 
 #include "UniqueNameContainer.h"
 #include "ErrorHandler.hpp"
+#include "ThreadPool.hpp"
 #include "KException.h"
 
 namespace km
@@ -184,11 +185,230 @@ namespace km
         return getSourceTable()->getDataWC(m_indices[row_index], m_selected_columns[column_index]);
     }
 
+    bool BasicView::isLess(IndexType row_index1, IndexType row_index2, IndexType column_index) const
+    {
+        return getSourceTable()->isLess(m_indices[row_index1], m_indices[row_index2], m_selected_columns[column_index]);
+    }
+
+    void BasicView::getBooleanMask(IndexType column_index, BitVector &mask) const
+    {
+        BitVector source_mask;
+        getSourceTable()->getBooleanMask(m_selected_columns[column_index], source_mask);
+        const SizeType row_count = rowCount();
+        mask.resize(row_count);
+        for (IndexType row_index = 0; row_index < row_count; ++row_index)
+            mask.set(row_index, source_mask.test(m_indices[row_index]));
+    }
+
+    bool BasicView::isNull(IndexType row_index, IndexType column_index) const
+    {
+        return getSourceTable()->isNull(m_indices[row_index], m_selected_columns[column_index]);
+    }
+
+    bool BasicView::getValidityMask(IndexType column_index, BitVector &mask) const
+    {
+        BitVector source_mask;
+        if (!getSourceTable()->getValidityMask(m_selected_columns[column_index], source_mask))
+            return false;
+        const SizeType row_count = rowCount();
+        mask.resize(row_count);
+        for (IndexType row_index = 0; row_index < row_count; ++row_index)
+            mask.set(row_index, source_mask.test(m_indices[row_index]));
+        return true;
+    }
+
+    bool BasicView::getCandidateMask(IndexType column_index, CompareOp op, const Variant &data, BitVector &mask) const
+    {
+        BitVector source_mask;
+        if (!getSourceTable()->getCandidateMask(m_selected_columns[column_index], op, data, source_mask))
+            return false;
+        const SizeType row_count = rowCount();
+        mask.clear();
+        mask.resize(row_count);
+        for (IndexType row_index = 0; row_index < row_count; ++row_index)
+            mask.set(row_index, source_mask.test(m_indices[row_index]));
+        return true;
+    }
+
+    SizeType BasicView::getRadixKeys(IndexType column_index, const std::vector<IndexType> &row_indices, std::vector<uint64_t> &keys) const
+    {
+        std::vector<IndexType> src_row_indices(row_indices.size());
+        for (IndexType k = 0, size = row_indices.size(); k < size; ++k)
+            src_row_indices[k] = m_indices[row_indices[k]];
+        return getSourceTable()->getRadixKeys(m_selected_columns[column_index], src_row_indices, keys);
+    }
+
+    void BasicView::setNullOrder(NullOrder null_order)
+    {
+        if (null_order == getNullOrder())
+            return;
+        AbstractTable::setNullOrder(null_order);
+        if (columnAt(getKeyColumn()))
+            sortRows();
+    }
+
+    bool BasicView::isRowBefore(IndexType src_row_index1, IndexType src_row_index2) const
+    {
+        const AbstractTable *source_table = getSourceTable();
+        const bool nulls_first = (getNullOrder() == NullOrder::FIRST);
+        // returns true if the rows are ordered by column @a column_index , @a is_before tells the order.
+        auto compare = [=](IndexType column_index, SortingOrder sorting_order, bool &is_before)
+        {
+            const bool null1 = source_table->isNull(src_row_index1, column_index);
+            const bool null2 = source_table->isNull(src_row_index2, column_index);
+            if (null1 || null2)
+            {
+                is_before = (null1 != null2 && null1 == nulls_first);
+                return null1 != null2;
+            }
+            const bool ascending = (sorting_order == SortingOrder::ASCENDING);
+            is_before = ascending ? source_table->isLess(src_row_index1, src_row_index2, column_index)
+                                  : source_table->isLess(src_row_index2, src_row_index1, column_index);
+            return is_before || m_secondary_keys.empty() || (ascending ? source_table->isLess(src_row_index2, src_row_index1, column_index)
+                                                                       : source_table->isLess(src_row_index1, src_row_index2, column_index));
+        };
+        bool is_before = false;
+        if (compare(m_selected_columns[getKeyColumn()], getSortingOrder(), is_before))
+            return is_before;
+        for (const auto &[column_index, sorting_order] : m_secondary_keys)
+        {
+            if (compare(m_selected_columns[column_index], sorting_order, is_before))
+                return is_before;
+        }
+        return false;
+    }
+
+    int BasicView::compareRows(IndexType src_row_index1, IndexType src_row_index2, IndexType src_column_index, const Variant *data) const
+    {
+        const AbstractTable *source_table = getSourceTable();
+        const bool nulls_first = (getNullOrder() == NullOrder::FIRST);
+        // compares like the encoded keys, nulls are placed by the null order whatever the sorting order is.
+        auto compare = [&](IndexType column_index, SortingOrder sorting_order)
+        {
+            const IndexType src_column = m_selected_columns[column_index];
+            const bool replaced = (src_column == src_column_index);
+            const bool null1 = source_table->isNull(src_row_index1, src_column);
+            const bool null2 = replaced ? !data : source_table->isNull(src_row_index2, src_column);
+            if (null1 || null2)
+                return null1 == null2 ? 0 : (null1 == nulls_first ? -1 : 1);
+            int result = 0;
+            if (replaced)
+            {
+                const auto is_less = isLessComparatorFor(source_table->getColumnMetaData(src_column).data_type);
+                const Variant value = source_table->getDataWC(src_row_index1, src_column);
+                result = is_less(value, *data) ? -1 : int(is_less(*data, value));
+            }
+            else
+                result = source_table->isLess(src_row_index1, src_row_index2, src_column) ? -1 : int(source_table->isLess(src_row_index2, src_row_index1, src_column));
+            return sorting_order == SortingOrder::ASCENDING ? result : -result;
+        };
+        int result = compare(getKeyColumn(), getSortingOrder());
+        for (auto it = m_secondary_keys.begin(); result == 0 && it != m_secondary_keys.end(); ++it)
+            result = compare(it->first, it->second);
+        return result;
+    }
+
+    std::string BasicView::keyOf(IndexType src_row_index, IndexType src_column_index, const Variant *data) const
+    {
+        const AbstractTable *source_table = getSourceTable();
+        const NullOrder null_order = getNullOrder();
+        std::string key;
+        auto append = [&](IndexType column_index, SortingOrder sorting_order)
+        {
+            const IndexType src_column = m_selected_columns[column_index];
+            if (src_column == src_column_index)
+            {
+                if (data)
+                    appendKeyValue(key, *data, sorting_order);
+                else
+                    appendKeyNull(key, null_order);
+            }
+            else if (source_table->isNull(src_row_index, src_column))
+                appendKeyNull(key, null_order);
+            else
+                appendKeyValue(key, source_table->getDataWC(src_row_index, src_column), sorting_order);
+        };
+        append(getKeyColumn(), getSortingOrder());
+        for (const auto &[column_index, sorting_order] : m_secondary_keys)
+            append(column_index, sorting_order);
+        return key;
+    }
+
+    void BasicView::sortRows()
+    {
+        const AbstractTable *source_table = getSourceTable();
+        const IndexType src_key_column = m_selected_columns[getKeyColumn()];
+        std::vector<uint64_t> keys;
+        SizeType key_bytes = 0;
+        if (m_secondary_keys.empty() && m_indices.size() >= k_radix_sort_threshold)
+            key_bytes = source_table->getRadixKeys(src_key_column, m_indices, keys);
+        if (key_bytes != 0)
+        {
+            radixSort(m_indices, keys, key_bytes, getSortingOrder() == SortingOrder::DESCENDING, getNullOrder() == NullOrder::FIRST,
+                      [source_table, src_key_column](IndexType src_row_index)
+                      { return source_table->isNull(src_row_index, src_key_column); });
+        }
+        else if (m_secondary_keys.empty())
+        {
+            // compares directly in the source, so no Variant is created per comparison.
+            parallelStableSort(m_indices.begin(), m_indices.end(), [this](IndexType index1, IndexType index2)
+                               { return isRowBefore(index1, index2); });
+        }
+        else
+        {
+            // composite key, encode it once per row so a comparison is a single memcmp.
+            const SizeType row_count = m_indices.size();
+            std::vector<std::string> keys(row_count);
+            const SizeType chunk_count = (row_count < k_parallel_sort_threshold) ? 1 : ThreadPool::instance().getThreadCount();
+            ThreadPool::instance().parallelFor(chunk_count, [&](IndexType chunk)
+                                               {
+                                                   for (IndexType row_index = row_count * chunk / chunk_count, end = row_count * (chunk + 1) / chunk_count; row_index < end; ++row_index)
+                                                       keys[row_index] = keyOf(m_indices[row_index]); });
+            std::vector<IndexType> order(row_count);
+            std::iota(order.begin(), order.end(), 0);
+            parallelStableSort(order.begin(), order.end(), [&keys](IndexType row_index1, IndexType row_index2)
+                               { return compareKeys(keys[row_index1], keys[row_index2]) < 0; });
+            std::vector<IndexType> indices(row_count);
+            for (IndexType row_index = 0; row_index < row_count; ++row_index)
+                indices[row_index] = m_indices[order[row_index]];
+            m_indices = std::move(indices);
+        }
+        KM_EMIT sourceSortedEvent();
+    }
+
+    IndexType BasicView::insertablePositionOf(IndexType src_row_index) const
+    {
+        auto it = std::upper_bound(m_indices.begin(), m_indices.end(), src_row_index, [this](IndexType src_row_index, IndexType middle)
+                                   { return isRowBefore(src_row_index, middle); });
+        return std::distance(m_indices.begin(), it);
+    }
+
     void BasicView::sortBy(SortingOrder s_order)
     {
-        if (m_sorder != s_order)
+        if (m_sorder != s_order && !m_secondary_keys.empty())
+        {
+            // reversing would also reverse the secondary keys.
+            m_sorder = s_order;
+            sortRows();
+        }
+        else if (m_sorder != s_order)
         {
             std::reverse(m_indices.begin(), m_indices.end());
+            // reversing moves the nulls to the other end, move them back.
+            const IndexType key_column = m_selected_columns[getKeyColumn()];
+            const auto source_table = getSourceTable();
+            auto is_null = [source_table, key_column](IndexType index)
+            { return source_table->isNull(index, key_column); };
+            if (getNullOrder() == NullOrder::FIRST)
+            {
+                auto first_null = std::find_if_not(m_indices.rbegin(), m_indices.rend(), is_null).base();
+                std::rotate(m_indices.begin(), first_null, m_indices.end());
+            }
+            else
+            {
+                auto last_null = std::find_if_not(m_indices.begin(), m_indices.end(), is_null);
+                std::rotate(m_indices.begin(), last_null, m_indices.end());
+            }
             m_sorder = s_order;
             KM_EMIT sourceReversedEvent();
         }
@@ -200,15 +420,9 @@ namespace km
         if (!found)
             return;
         IndexType idx = found.value().first;
-        DataType type = found.value().second;
-        IndexType original_clm_index = m_selected_columns[idx];
-        auto fnc = getSortingOrder() == SortingOrder::ASCENDING ? isLessComparatorFor(type) : isGreaterComparatorFor(type);
-        auto source_table = getSourceTable();
-
-        std::stable_sort(m_indices.begin(), m_indices.end(), [fnc, source_table, original_clm_index](IndexType index1, IndexType index2)
-                         { return fnc(source_table->getDataWC(index1, original_clm_index), source_table->getDataWC(index2, original_clm_index)); });
         setKeyColumn(idx);
-        KM_EMIT sourceSortedEvent();
+        m_secondary_keys.clear();
+        sortRows();
     }
 
     void BasicView::sortBy(const std::string &column_name, SortingOrder s_order)
@@ -217,6 +431,42 @@ namespace km
         sortBy(column_name);
     }
 
+    void BasicView::sortBy(const std::vector<SortKey> &keys)
+    {
+        std::vector<std::pair<IndexType, SortingOrder>> view_keys;
+        for (const SortKey &key : keys)
+        {
+            const auto found = findColumn(key.column_name);
+            if (!found || std::any_of(view_keys.begin(), view_keys.end(), [&found](const auto &view_key)
+                                      { return view_key.first == found.value().first; }))
+            {
+                err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ InvalidArgs") << "Column `" << key.column_name
+                                                                                  << "` passed as sort key doesn't exist in the view or is repeated.");
+                return;
+            }
+            view_keys.emplace_back(found.value().first, key.sorting_order);
+        }
+        if (view_keys.empty())
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ InvalidArgs") << "No sort key is passed to sort the view.");
+            return;
+        }
+        setKeyColumn(view_keys.front().first);
+        m_sorder = view_keys.front().second;
+        m_secondary_keys.assign(view_keys.begin() + 1, view_keys.end());
+        sortRows();
+    }
+
+    std::vector<SortKey> BasicView::getSortKeys() const
+    {
+        std::vector<SortKey> keys;
+        if (auto column_info = columnAt(getKeyColumn()))
+            keys.push_back({column_info.value().first, getSortingOrder()});
+        for (const auto &[column_index, sorting_order] : m_secondary_keys)
+            keys.push_back({columnAt(column_index).value().first, sorting_order});
+        return keys;
+    }
+
     void BasicView::refresh()
     {
         m_indices.clear();
@@ -229,8 +479,8 @@ namespace km
             filter(m_filtered_token, m_indices, getSourceTable());
 
         pauseEventProcessing();
-        if (auto column_info = columnAt(getKeyColumn()))
-            sortBy(column_info.value().first, getSortingOrder());
+        if (columnAt(getKeyColumn()))
+            sortRows();
         resumeEventProcessing();
 
         KM_EMIT refreshEvent();
@@ -240,23 +490,21 @@ namespace km
     {
         if (!getSourceTable())
             return INVALID_INDEX;
-        return mapToLocal(src_row_index, getSourceTable()->getDataWC(src_row_index, m_selected_columns[getKeyColumn()]));
+        return mapToLocal(src_row_index, INVALID_INDEX, nullptr);
     }
 
-    IndexType BasicView::mapToLocal(IndexType src_row_index, const Variant &key_data)
+    IndexType BasicView::mapToLocal(IndexType src_row_index, IndexType src_column_index, const Variant *data) const
     {
-        int64_t lower = 0, upper = static_cast<int64_t>(m_indices.size()) - 1;
-        auto data_type = columnAt(getKeyColumn()).value().second;
-        auto fnc = (getSortingOrder() == SortingOrder::ASCENDING) ? (isLessComparatorFor(data_type)) : (isGreaterComparatorFor(data_type));
-        while (lower <= upper)
-        {
-            long long int mid = (lower + upper) / 2;
-            if (m_indices[mid] == src_row_index)
-                return mid;
-            else if (fnc(key_data, getDataWC(mid, getKeyColumn())))
-                upper = mid - 1;
-            else
-                lower = mid + 1;
+        // rows are ordered by their keys, rows with equal key are searched linearly. Data of the row itself may be
+        // changed, so it is never compared with itself.
+        auto it = std::lower_bound(m_indices.begin(), m_indices.end(), src_row_index, [=](IndexType middle, IndexType src_row_index)
+                                   { return middle != src_row_index && compareRows(middle, src_row_index, src_column_index, data) < 0; });
+        for (; it != m_indices.end(); ++it)
+        {
+            if (*it == src_row_index)
+                return std::distance(m_indices.begin(), it);
+            if (compareRows(*it, src_row_index, src_column_index, data) != 0)
+                break;
         }
         return INVALID_INDEX;
     }
@@ -278,8 +526,14 @@ namespace km
     {
         bool should_filter = std::any_of(m_filtered_token.begin(), m_filtered_token.end(), [src_column_index](const parse::Token &token)
                                          { return (token.token_type == 0x0040 && token.element.asColInfo().index == src_column_index); });
-        bool change_in_key_column = (src_column_index == m_selected_columns[getKeyColumn()]);
-        IndexType local_row_index = (change_in_key_column) ? mapToLocal(src_row_index, old_data) : mapToLocal(src_row_index);
+        bool change_in_key_column = (src_column_index == m_selected_columns[getKeyColumn()]) ||
+                                    std::any_of(m_secondary_keys.begin(), m_secondary_keys.end(), [this, src_column_index](const auto &key)
+                                                { return m_selected_columns[key.first] == src_column_index; });
+        IndexType local_row_index = INVALID_INDEX;
+        if (!change_in_key_column)
+            local_row_index = mapToLocal(src_row_index);
+        else if ((local_row_index = mapToLocal(src_row_index, src_column_index, &old_data)) == INVALID_INDEX)
+            local_row_index = mapToLocal(src_row_index, src_column_index, nullptr); // it was null
         bool row_exists = (local_row_index != INVALID_INDEX);
         bool filter_result = should_filter ? parse::filter(m_filtered_token, getSourceTable(), src_row_index) : false;
 
@@ -299,8 +553,7 @@ namespace km
         // insert
         if (should_filter && filter_result && !row_exists)
         {
-            Variant new_data = getSourceTable()->getDataWC(src_row_index, m_selected_columns[getKeyColumn()]);
-            auto new_pos = insertablePosition(new_data);
+            auto new_pos = insertablePositionOf(src_row_index);
             m_indices.insert(m_indices.begin() + new_pos, src_row_index);
             KM_EMIT rowInsertionEvent(new_pos);
             return;
@@ -317,8 +570,7 @@ namespace km
         {
             m_indices.erase(m_indices.begin() + local_row_index);
             KM_EMIT rowDropEvent(local_row_index);
-            Variant new_data = getSourceTable()->getDataWC(src_row_index, m_selected_columns[getKeyColumn()]);
-            auto new_pos = insertablePosition(new_data);
+            auto new_pos = insertablePositionOf(src_row_index);
             m_indices.insert(m_indices.begin() + new_pos, src_row_index);
             KM_EMIT rowInsertionEvent(new_pos);
             return;
@@ -335,15 +587,61 @@ namespace km
                       });
         if (!m_filtered_token.empty() && !parse::filter(m_filtered_token, getSourceTable(), row_index))
             return;
-        Variant data = getSourceTable()->getDataWC(row_index, m_selected_columns[getKeyColumn()]);
-        IndexType view_row_index = insertablePosition(data);
+        IndexType view_row_index = insertablePositionOf(row_index);
         m_indices.insert(m_indices.begin() + view_row_index, row_index);
         KM_EMIT rowInsertionEvent(view_row_index);
     }
 
+    KM_SLOT void BasicView::rowsInserted(const std::vector<IndexType> &row_indices)
+    {
+        const AbstractTable *source_table = getSourceTable();
+        const SizeType source_row_count = source_table->rowCount();
+        BitVector is_new(source_row_count);
+        for (IndexType row_index : row_indices)
+            is_new.set(row_index, true);
+
+        // shift existing rows in one pass, old source index -> new source index.
+        std::vector<IndexType> new_index_of;
+        new_index_of.reserve(source_row_count - row_indices.size());
+        for (IndexType row_index = 0; row_index < source_row_count; ++row_index)
+        {
+            if (!is_new.test(row_index))
+                new_index_of.push_back(row_index);
+        }
+        for (IndexType &index : m_indices)
+            index = new_index_of[index];
+
+        std::vector<IndexType> accepted;
+        for (IndexType row_index : row_indices)
+        {
+            if (m_filtered_token.empty() || parse::filter(m_filtered_token, source_table, row_index))
+                accepted.push_back(row_index);
+        }
+        if (accepted.empty())
+            return;
+
+        auto is_before = [this](IndexType index1, IndexType index2)
+        { return isRowBefore(index1, index2); };
+        std::stable_sort(accepted.begin(), accepted.end(), is_before);
+        const SizeType old_count = m_indices.size();
+        m_indices.insert(m_indices.end(), accepted.begin(), accepted.end());
+        std::inplace_merge(m_indices.begin(), m_indices.begin() + old_count, m_indices.end(), is_before);
+
+        std::vector<IndexType> view_row_indices;
+        view_row_indices.reserve(accepted.size());
+        for (IndexType view_row_index = 0, size = m_indices.size(); view_row_index < size; ++view_row_index)
+        {
+            if (is_new.test(m_indices[view_row_index]))
+                view_row_indices.push_back(view_row_index);
+        }
+        KM_EMIT rowsInsertionEvent(view_row_indices);
+    }
+
     KM_SLOT void BasicView::rowDropped(IndexType row_index)
     {
-        IndexType view_row_index = mapToLocal(row_index);
+        // the row doesn't exist in the source anymore, so it can't be searched by its key.
+        auto found_it = std::find(m_indices.begin(), m_indices.end(), row_index);
+        IndexType view_row_index = (found_it != m_indices.end()) ? std::distance(m_indices.begin(), found_it) : INVALID_INDEX;
         if (view_row_index != INVALID_INDEX)
             m_indices.erase(m_indices.begin() + view_row_index);
         std::for_each(m_indices.begin(), m_indices.end(), [row_index](IndexType &index)
@@ -353,6 +651,38 @@ namespace km
             KM_EMIT rowDropEvent(view_row_index);
     }
 
+    KM_SLOT void BasicView::rowsDropped(const std::vector<IndexType> &row_indices)
+    {
+        // old source index -> new source index, dropped rows are marked with INVALID_INDEX.
+        const SizeType old_row_count = getSourceTable()->rowCount() + row_indices.size();
+        std::vector<IndexType> new_index_of(old_row_count);
+        for (IndexType row_index = 0, k = 0, dropped = 0; row_index < old_row_count; ++row_index)
+        {
+            if (k < row_indices.size() && row_indices[k] == row_index)
+            {
+                new_index_of[row_index] = INVALID_INDEX;
+                ++k;
+                ++dropped;
+            }
+            else
+                new_index_of[row_index] = row_index - dropped;
+        }
+
+        std::vector<IndexType> view_row_indices;
+        IndexType kept = 0;
+        for (IndexType view_row_index = 0, size = m_indices.size(); view_row_index < size; ++view_row_index)
+        {
+            const IndexType new_index = new_index_of[m_indices[view_row_index]];
+            if (new_index == INVALID_INDEX)
+                view_row_indices.push_back(view_row_index);
+            else
+                m_indices[kept++] = new_index;
+        }
+        m_indices.resize(kept);
+        if (!view_row_indices.empty())
+            KM_EMIT rowsDropEvent(view_row_indices);
+    }
+
     KM_SLOT void BasicView::sourceSorted()
     {
         refresh();
@@ -373,7 +703,7 @@ namespace km
         }
         else if (m_selected_columns[getKeyColumn()] == column_index) // if it was the base column for the view
         {
-            sortBy(columnAt(getKeyColumn()).value().first); // calls sourceSortedEvent()
+            sortRows(); // calls sourceSortedEvent()
         }
     }
 
@@ -0,0 +1,463 @@
+#include "Bytecode.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include "Column.hpp"
+#include "FunctionStore.hpp"
+#include "functions/NativeOps.h"
+#include "TokenType.h"
+
+namespace km
+{
+    namespace parse
+    {
+        using fnc::NativeOp;
+
+        namespace
+        {
+            constexpr bool isScalar(DataType type) noexcept
+            {
+                return type == DataType::INT32 || type == DataType::INT64 || type == DataType::FLOAT32 ||
+                       type == DataType::FLOAT64 || type == DataType::BOOLEAN;
+            }
+
+            template <typename Type_>
+            Type_ &as(Scalar &scalar) noexcept
+            {
+                if constexpr (std::is_same_v<Type_, KInt32>)
+                    return scalar.i32;
+                else if constexpr (std::is_same_v<Type_, KInt64>)
+                    return scalar.i64;
+                else if constexpr (std::is_same_v<Type_, KFloat32>)
+                    return scalar.f32;
+                else if constexpr (std::is_same_v<Type_, KFloat64>)
+                    return scalar.f64;
+                else
+                    return scalar.b;
+            }
+
+            Variant box(Scalar scalar, DataType type)
+            {
+                switch (type)
+                {
+                case DataType::INT32:
+                    return scalar.i32;
+                case DataType::INT64:
+                    return scalar.i64;
+                case DataType::FLOAT32:
+                    return scalar.f32;
+                case DataType::FLOAT64:
+                    return scalar.f64;
+                default:
+                    return scalar.b;
+                }
+            }
+
+            void unbox(const Variant &data, DataType type, Scalar &scalar)
+            {
+                switch (type)
+                {
+                case DataType::INT32:
+                    scalar.i32 = data.asInt32();
+                    break;
+                case DataType::INT64:
+                    scalar.i64 = data.asInt64();
+                    break;
+                case DataType::FLOAT32:
+                    scalar.f32 = data.asFloat32();
+                    break;
+                case DataType::FLOAT64:
+                    scalar.f64 = data.asFloat64();
+                    break;
+                default:
+                    scalar.b = data.asBoolean();
+                    break;
+                }
+            }
+
+            // calls fn with a value of the K-type of type, returns false if type is not a number.
+            template <typename Fn_>
+            bool forArithmeticType(DataType type, Fn_ &&fn)
+            {
+                switch (type)
+                {
+                case DataType::INT32:
+                    fn(KInt32{});
+                    return true;
+                case DataType::INT64:
+                    fn(KInt64{});
+                    return true;
+                case DataType::FLOAT32:
+                    fn(KFloat32{});
+                    return true;
+                case DataType::FLOAT64:
+                    fn(KFloat64{});
+                    return true;
+                default:
+                    return false;
+                }
+            }
+
+            template <typename Fn_>
+            bool forScalarType(DataType type, Fn_ &&fn)
+            {
+                if (type == DataType::BOOLEAN)
+                {
+                    fn(KBoolean{});
+                    return true;
+                }
+                return forArithmeticType(type, std::forward<Fn_>(fn));
+            }
+
+            // handlers, arguments of a function are in the registers dst, dst + 1, ...
+
+            void loadConstant(Frame &frame, const Instruction &instruction)
+            {
+                frame.scalars[instruction.dst] = instruction.constant;
+            }
+
+            void loadData(Frame &frame, const Instruction &instruction)
+            {
+                frame.variants[instruction.dst] = instruction.data;
+            }
+
+            template <typename Column_>
+            void loadValue(Frame &frame, const Instruction &instruction)
+            {
+                using Type_ = std::decay_t<decltype(std::declval<const Column_ &>().getValue(0))>;
+                as<Type_>(frame.scalars[instruction.dst]) =
+                    static_cast<const Column_ *>(instruction.column)->getValue((*instruction.indices)[frame.row_index]);
+            }
+
+            void loadColumn(Frame &frame, const Instruction &instruction)
+            {
+                frame.variants[instruction.dst] = frame.table->getDataWC(frame.row_index, instruction.column_index);
+            }
+
+            void loadColumnUnboxed(Frame &frame, const Instruction &instruction)
+            {
+                unbox(frame.table->getDataWC(frame.row_index, instruction.column_index), instruction.type,
+                      frame.scalars[instruction.dst]);
+            }
+
+            template <NativeOp op_, typename Type_>
+            void arithmeticOp(Frame &frame, const Instruction &instruction)
+            {
+                Scalar *reg = frame.scalars + instruction.dst;
+                const Type_ a = as<Type_>(reg[0]);
+                const Type_ b = as<Type_>(reg[1]);
+                if constexpr (op_ == NativeOp::ADD)
+                    as<Type_>(reg[0]) = a + b;
+                else if constexpr (op_ == NativeOp::SUBTRACT)
+                    as<Type_>(reg[0]) = a - b;
+                else if constexpr (op_ == NativeOp::MULTIPLY)
+                    as<Type_>(reg[0]) = a * b;
+                else if constexpr (std::is_floating_point_v<Type_>)
+                    as<Type_>(reg[0]) = static_cast<Type_>(std::fmod(a, b));
+                else
+                    as<Type_>(reg[0]) = a % b;
+            }
+
+            // like divide_(), integer division by zero gives 0.
+            template <typename Type_, typename Result_>
+            void divideOp(Frame &frame, const Instruction &instruction)
+            {
+                Scalar *reg = frame.scalars + instruction.dst;
+                const Type_ a = as<Type_>(reg[0]);
+                const Type_ b = as<Type_>(reg[1]);
+                if constexpr (std::is_integral_v<Result_>)
+                {
+                    if (b == 0)
+                    {
+                        as<Result_>(reg[0]) = 0;
+                        return;
+                    }
+                }
+                as<Result_>(reg[0]) = static_cast<Result_>(a) / static_cast<Result_>(b);
+            }
+
+            template <NativeOp op_, typename Type_>
+            void compareOp(Frame &frame, const Instruction &instruction)
+            {
+                Scalar *reg = frame.scalars + instruction.dst;
+                const Type_ a = as<Type_>(reg[0]);
+                const Type_ b = as<Type_>(reg[1]);
+                if constexpr (op_ == NativeOp::LESS)
+                    reg[0].b = a < b;
+                else if constexpr (op_ == NativeOp::GREATER)
+                    reg[0].b = a > b;
+                else if constexpr (op_ == NativeOp::EQUAL)
+                    reg[0].b = a == b;
+                else if constexpr (op_ == NativeOp::LESS_OR_EQUAL)
+                    reg[0].b = a <= b;
+                else
+                    reg[0].b = a >= b;
+            }
+
+            template <typename Type_>
+            void inRangeOp(Frame &frame, const Instruction &instruction)
+            {
+                Scalar *reg = frame.scalars + instruction.dst;
+                const Type_ value = as<Type_>(reg[0]);
+                reg[0].b = (value >= as<Type_>(reg[1])) && (value <= as<Type_>(reg[2]));
+            }
+
+            template <NativeOp op_>
+            void logicalOp(Frame &frame, const Instruction &instruction)
+            {
+                Scalar *reg = frame.scalars + instruction.dst;
+                if constexpr (op_ == NativeOp::AND)
+                    reg[0].b = reg[0].b && reg[1].b;
+                else if constexpr (op_ == NativeOp::OR)
+                    reg[0].b = reg[0].b || reg[1].b;
+                else if constexpr (op_ == NativeOp::XOR)
+                    reg[0].b = reg[0].b != reg[1].b;
+                else
+                    reg[0].b = !reg[0].b;
+            }
+
+            // all the arguments are evaluated already, like IF_().
+            void selectOp(Frame &frame, const Instruction &instruction)
+            {
+                Scalar *reg = frame.scalars + instruction.dst;
+                reg[0] = reg[0].b ? reg[1] : reg[2];
+            }
+
+            template <typename From_, typename To_>
+            void castOp(Frame &frame, const Instruction &instruction)
+            {
+                Scalar &reg = frame.scalars[instruction.dst];
+                as<To_>(reg) = static_cast<To_>(as<From_>(reg));
+            }
+
+            // functions which can't run on unboxed values are called with Variants.
+            void callFunction(Frame &frame, const Instruction &instruction)
+            {
+                const SizeType argc = instruction.argument_types.size();
+                for (IndexType arg_index = 0; arg_index < argc; ++arg_index)
+                {
+                    const IndexType reg = instruction.dst + arg_index;
+                    const DataType type = instruction.argument_types[arg_index];
+                    if (isScalar(type))
+                        frame.arguments[arg_index] = box(frame.scalars[reg], type);
+                    else
+                        frame.arguments[arg_index] = frame.variants[reg];
+                }
+                Variant result = instruction.function(frame.arguments);
+                if (isScalar(instruction.type))
+                    unbox(result, instruction.type, frame.scalars[instruction.dst]);
+                else
+                    frame.variants[instruction.dst] = std::move(result);
+            }
+
+            template <NativeOp op_>
+            Handler arithmeticHandler(DataType type)
+            {
+                Handler handler = nullptr;
+                forArithmeticType(type, [&handler](auto tag)
+                                  { handler = &arithmeticOp<op_, decltype(tag)>; });
+                return handler;
+            }
+
+            template <NativeOp op_>
+            Handler compareHandler(DataType type)
+            {
+                Handler handler = nullptr;
+                forArithmeticType(type, [&handler](auto tag)
+                                  { handler = &compareOp<op_, decltype(tag)>; });
+                return handler;
+            }
+
+            // returns the handler of a built in function on unboxed values, nullptr if it must be called.
+            Handler nativeHandler(NativeOp op, const std::vector<DataType> &argument_types, DataType return_type)
+            {
+                const SizeType argc = argument_types.size();
+                for (DataType type : argument_types)
+                    if (!isScalar(type))
+                        return nullptr;
+                if (!isScalar(return_type) || argc == 0)
+                    return nullptr;
+                const DataType type = argument_types.front();
+                const bool same_types = std::all_of(argument_types.begin(), argument_types.end(), [type](DataType t)
+                                                    { return t == type; });
+                Handler handler = nullptr;
+                switch (op)
+                {
+                case NativeOp::ADD:
+                case NativeOp::SUBTRACT:
+                case NativeOp::MULTIPLY:
+                case NativeOp::MODULO:
+                    if (argc != 2 || !same_types || return_type != type)
+                        return nullptr;
+                    if (op == NativeOp::ADD)
+                        return arithmeticHandler<NativeOp::ADD>(type);
+                    if (op == NativeOp::SUBTRACT)
+                        return arithmeticHandler<NativeOp::SUBTRACT>(type);
+                    if (op == NativeOp::MULTIPLY)
+                        return arithmeticHandler<NativeOp::MULTIPLY>(type);
+                    return arithmeticHandler<NativeOp::MODULO>(type);
+                case NativeOp::DIVIDE:
+                    if (argc != 2 || !same_types)
+                        return nullptr;
+                    forArithmeticType(type, [&handler, return_type](auto tag)
+                                      { forArithmeticType(return_type, [&handler](auto result_tag)
+                                                          { handler = &divideOp<decltype(tag), decltype(result_tag)>; }); });
+                    return handler;
+                case NativeOp::LESS:
+                case NativeOp::GREATER:
+                case NativeOp::EQUAL:
+                case NativeOp::LESS_OR_EQUAL:
+                case NativeOp::GREATER_OR_EQUAL:
+                    if (argc != 2 || !same_types || return_type != DataType::BOOLEAN)
+                        return nullptr;
+                    if (op == NativeOp::LESS)
+                        return compareHandler<NativeOp::LESS>(type);
+                    if (op == NativeOp::GREATER)
+                        return compareHandler<NativeOp::GREATER>(type);
+                    if (op == NativeOp::EQUAL)
+                        return compareHandler<NativeOp::EQUAL>(type);
+                    if (op == NativeOp::LESS_OR_EQUAL)
+                        return compareHandler<NativeOp::LESS_OR_EQUAL>(type);
+                    return compareHandler<NativeOp::GREATER_OR_EQUAL>(type);
+                case NativeOp::IN_RANGE:
+                    if (argc != 3 || !same_types || return_type != DataType::BOOLEAN)
+                        return nullptr;
+                    forArithmeticType(type, [&handler](auto tag)
+                                      { handler = &inRangeOp<decltype(tag)>; });
+                    return handler;
+                case NativeOp::AND:
+                case NativeOp::OR:
+                case NativeOp::XOR:
+                    if (argc != 2 || !same_types || type != DataType::BOOLEAN || return_type != DataType::BOOLEAN)
+                        return nullptr;
+                    if (op == NativeOp::AND)
+                        return &logicalOp<NativeOp::AND>;
+                    return op == NativeOp::OR ? &logicalOp<NativeOp::OR> : &logicalOp<NativeOp::XOR>;
+                case NativeOp::NOT:
+                    if (argc != 1 || type != DataType::BOOLEAN || return_type != DataType::BOOLEAN)
+                        return nullptr;
+                    return &logicalOp<NativeOp::NOT>;
+                case NativeOp::IF:
+                    if (argc != 3 || type != DataType::BOOLEAN || argument_types[1] != return_type ||
+                        argument_types[2] != return_type)
+                        return nullptr;
+                    return &selectOp;
+                case NativeOp::CAST:
+                    if (argc != 1)
+                        return nullptr;
+                    forScalarType(type, [&handler, return_type](auto tag)
+                                  { forScalarType(return_type, [&handler](auto result_tag)
+                                                  { handler = &castOp<decltype(tag), decltype(result_tag)>; }); });
+                    return handler;
+                default:
+                    return nullptr;
+                }
+            }
+
+            // direct load of a column of default or chunked storage, nullptr if it is stored otherwise.
+            Handler valueLoader(const AbstractColumn *column, DataType type)
+            {
+                Handler handler = nullptr;
+                if (type == DataType::BOOLEAN)
+                {
+                    if (dynamic_cast<const Column<KBoolean> *>(column))
+                        handler = &loadValue<Column<KBoolean>>;
+                    return handler;
+                }
+                forArithmeticType(type, [&handler, column](auto tag)
+                                  {
+                                      using Type_ = decltype(tag);
+                                      if (dynamic_cast<const Column<Type_> *>(column))
+                                          handler = &loadValue<Column<Type_>>;
+                                      else if (dynamic_cast<const ChunkedColumn<Type_> *>(column))
+                                          handler = &loadValue<ChunkedColumn<Type_>>; });
+                return handler;
+            }
+        }
+
+        Program::Program(ConstTokenContainerRef token_vec, const AbstractTable *table)
+            : m_result_type(DataType{})
+        {
+            std::vector<DataType> types; // data type of each register, it is the stack of the formula
+            SizeType register_count = 1;
+            SizeType max_argc = 0;
+            m_code.reserve(token_vec.size());
+            for (const Token &token : token_vec)
+            {
+                Instruction instruction{};
+                instruction.dst = types.size();
+                if (token.token_type & FUNCTION)
+                {
+                    const auto &info = token.element.asFncInfo();
+                    instruction.dst -= info.argc;
+                    instruction.function = info.function;
+                    instruction.argument_types.assign(types.begin() + instruction.dst, types.end());
+                    types.resize(instruction.dst);
+                    auto it = FunctionStore::store().find(token.text);
+                    instruction.type = it != FunctionStore::store().invalid() ? it->second.return_type : DataType{};
+                    instruction.handler = nativeHandler(fnc::nativeOpOf(info.function), instruction.argument_types, instruction.type);
+                    if (!instruction.handler)
+                        instruction.handler = &callFunction;
+                    if (info.argc > max_argc)
+                        max_argc = info.argc;
+                }
+                else if (token.token_type & COLUMN)
+                {
+                    const column_info_t &info = token.element.asColInfo();
+                    instruction.type = info.type;
+                    instruction.column_index = info.index;
+                    if (isScalar(info.type))
+                    {
+                        instruction.column = table->getPhysicalColumn(info.index, instruction.indices);
+                        instruction.handler = instruction.column ? valueLoader(instruction.column, info.type) : nullptr;
+                        if (!instruction.handler)
+                            instruction.handler = &loadColumnUnboxed;
+                    }
+                    else
+                        instruction.handler = &loadColumn;
+                }
+                else if (token.token_type & TT_DATA)
+                {
+                    // folded constants don't have the token type of their data.
+                    instruction.type = dataTypeOf(token.element.asData());
+                    if (isScalar(instruction.type))
+                    {
+                        unbox(token.element.asData(), instruction.type, instruction.constant);
+                        instruction.handler = &loadConstant;
+                    }
+                    else
+                    {
+                        instruction.data = token.element.asData();
+                        instruction.handler = &loadData;
+                    }
+                }
+                else
+                    continue;
+                types.push_back(instruction.type);
+                if (types.size() > register_count)
+                    register_count = types.size();
+                m_code.push_back(std::move(instruction));
+            }
+            if (!types.empty())
+                m_result_type = types.front();
+
+            m_scalars.resize(register_count);
+            m_variants.resize(register_count);
+            m_arguments.resize(max_argc);
+            m_frame.table = table;
+            m_frame.row_index = 0;
+            m_frame.scalars = m_scalars.data();
+            m_frame.variants = m_variants.data();
+            m_frame.arguments = m_arguments.data();
+        }
+
+        Variant Program::getResult() const
+        {
+            if (isScalar(m_result_type))
+                return box(m_scalars.front(), m_result_type);
+            return m_variants.front();
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef KMTABLE_SRC_BYTECODE_H
+#define KMTABLE_SRC_BYTECODE_H
+
+#include <vector>
+
+#include "Core.hpp"
+#include "Parser2.hpp"
+#include "AbstractTable.hpp"
+
+namespace km
+{
+    namespace parse
+    {
+        /**
+         * @brief A register for values of DataType INT32, INT64, FLOAT32, FLOAT64 and BOOLEAN, they are kept unboxed.
+         */
+        union Scalar
+        {
+            KInt32 i32;
+            KInt64 i64;
+            KFloat32 f32;
+            KFloat64 f64;
+            KBoolean b;
+        };
+
+        struct Instruction;
+
+        /**
+         * @brief Registers and the current row of a running Program.
+         */
+        struct Frame
+        {
+            const AbstractTable *table; ///< table the formula refers to
+            IndexType row_index;        ///< row being evaluated
+            Scalar *scalars;            ///< scalar register of each stack position
+            Variant *variants;          ///< Variant register of each stack position, for strings and dates
+            Variant *arguments;         ///< arguments of a called function
+        };
+
+        /**
+         * @brief Executes an instruction, it is chosen while compiling as per the operation and the data types.
+         */
+        using Handler = void (*)(Frame &frame, const Instruction &instruction);
+
+        /**
+         * @brief An instruction of Program, it writes its result to the register @b dst .
+         *
+         * A function's arguments are in the registers dst, dst + 1 and so on, like the RPN stack they come from.
+         */
+        struct Instruction
+        {
+            Handler handler;                          ///< executes the instruction
+            IndexType dst;                            ///< register (stack position) of the result
+            DataType type;                            ///< data type of the result
+            Scalar constant;                          ///< literal of scalar type
+            Variant data;                             ///< literal of other types
+            IndexType column_index;                   ///< column loaded with getDataWC()
+            const AbstractColumn *column;             ///< column loaded directly
+            const std::vector<IndexType> *indices;    ///< physical index of each row in @b column
+            Variant (*function)(const Variant *);     ///< called function
+            std::vector<DataType> argument_types;     ///< data types of arguments of called function
+        };
+
+        /**
+         * @brief Program is a formula compiled to bytecode with typed registers.
+         *
+         * It is compiled from the tokens given by getCheckedToken(). Every position of the RPN stack gets a register,
+         * values of DataType INT32, INT64, FLOAT32, FLOAT64 and BOOLEAN are kept unboxed and the built in functions
+         * on them (arithmetic, comparisons, logical, IF and conversions) run as typed instructions. Columns of a Table
+         * with default or chunked storage are read directly from the column. So such formulas are evaluated without
+         * creating any Variant. Other functions are called with Variants as usual, with the same results.
+         *
+         * A Program refers to the data of the table, it must be compiled again after the table is modified. It is not
+         * thread safe, each thread should compile its own Program.
+         */
+        class Program
+        {
+        public:
+            /**
+             * @brief Compiles @a token_vec which refers to the columns of @a table .
+             */
+            Program(ConstTokenContainerRef token_vec, const AbstractTable *table);
+
+            KM_DISABLE_COPY_MOVE(Program)
+
+            /**
+             * @brief Evaluates the formula for row @a row_index .
+             */
+            void run(IndexType row_index)
+            {
+                m_frame.row_index = row_index;
+                for (const Instruction &instruction : m_code)
+                    instruction.handler(m_frame, instruction);
+            }
+
+            /**
+             * @brief Returns result of the last run() of a boolean formula.
+             */
+            KBoolean getBoolean() const { return m_result_type == DataType::BOOLEAN ? m_scalars.front().b : m_variants.front().asBoolean(); }
+
+            /**
+             * @brief Returns result of the last run().
+             */
+            Variant getResult() const;
+
+        private:
+            std::vector<Instruction> m_code;
+            std::vector<Scalar> m_scalars;
+            std::vector<Variant> m_variants;
+            std::vector<Variant> m_arguments;
+            DataType m_result_type;
+            Frame m_frame;
+        };
+    }
+}
+
+#endif // KMTABLE_SRC_BYTECODE_H
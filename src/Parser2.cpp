@@ -1,12 +1,16 @@
 #include <vector>
 #include <string>
-#include <regex>
+#include <string_view>
+#include <charconv>
 #include <stack>
+#include <algorithm>
 
 #include "Core.hpp"
 #include "AbstractTable.hpp"
 #include "ErrorHandler.hpp"
 #include "FunctionStore.hpp"
+#include "Bytecode.h"
+#include "TokenType.h"
 
 namespace km
 {
@@ -14,121 +18,129 @@ namespace km
     namespace parse
     {
 
-        enum TType : uint16_t
+        using TokenRef = Token &;
+        using ConstTokenRef = const Token &;
+
+        // classification is ASCII only, like the "C" locale, so it doesn't depend on the global locale.
+        constexpr bool isDigit(char c) noexcept
         {
-            INT32 = 0x0001,
-            INT64 = 0x0002,
-            FLOAT32 = 0x0004,
-            FLOAT64 = 0x0008,
-            STRING = 0x0010,
-            BOOLEAN = 0x0020,
+            return c >= '0' && c <= '9';
+        }
 
-            COLUMN = 0x0040,
-            FUNCTION = 0x080,
+        constexpr bool isAlpha(char c) noexcept
+        {
+            return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+        }
 
-            COMMA = 0x0100,
-            P_OPEN = 0x0200,
-            P_CLOSE = 0x0400,
-            INVALID = 0x0800,
-        };
+        constexpr bool isWordChar(char c) noexcept
+        {
+            return isAlpha(c) || isDigit(c) || c == '_';
+        }
 
-        constexpr uint16_t TT_DATA = (INT32 | INT64 | FLOAT32 | FLOAT64 | STRING | BOOLEAN);
-        constexpr uint16_t TT_DATAC = (TT_DATA | COLUMN);
+        // characters which end a token (and aren't part of it), except the quote which starts a string.
+        constexpr bool isDelimiter(char c) noexcept
+        {
+            return c == ' ' || c == ',' || c == '(' || c == ')' || c == '\"';
+        }
 
-        using TokenRef = Token &;
-        using ConstTokenRef = const Token &;
+        // true if all characters of @a text from @a pos are word characters.
+        static bool isWordTail(std::string_view text, SizeType pos) noexcept
+        {
+            return std::all_of(text.begin() + pos, text.end(), isWordChar);
+        }
 
-        static void resolveTokenType(TokenRef token)
+        // classifies a number, it may have a leading minus. INT64 needs the l/L suffix, FLOAT32 needs the f suffix
+        // and a float must have digits before the point.
+        static TType numberType(std::string_view text) noexcept
         {
-            static const std::vector<std::pair<TType, std::regex>> regex_map{
-                {INT32, std::regex("\\-?\\d+")},
-                {INT64, std::regex("\\-?\\d+(l|L)?")},
-                {FLOAT32, std::regex("\\-?\\d+\\.(\\d+)?f")},
-                {FLOAT64, std::regex("\\-?\\d+\\.(\\d+)?")},
-                {STRING, std::regex("\".*\"")},
-                {BOOLEAN, std::regex("(True)|(False)")},
-                {COLUMN, std::regex("\\$[A-Za-z_]\\w*")},
-                {FUNCTION, std::regex("[A-Za-z]\\w*")},
-                {P_OPEN, std::regex("\\(")},
-                {P_CLOSE, std::regex("\\)")},
-                {COMMA, std::regex(",")},
-                {INVALID, std::regex(".*")}};
-            for (const auto &ref : regex_map)
-            {
-                if (std::regex_match(token.text, ref.second))
-                {
-                    token.token_type = ref.first;
-                    return;
-                }
-            }
+            const SizeType size = text.size();
+            SizeType pos = (text.front() == '-');
+            const SizeType digits_begin = pos;
+            while (pos < size && isDigit(text[pos]))
+                ++pos;
+            if (pos == digits_begin)
+                return INVALID;
+            if (pos == size)
+                return INT32;
+            if (text[pos] == 'l' || text[pos] == 'L')
+                return (pos + 1 == size) ? INT64 : INVALID;
+            if (text[pos] != '.')
+                return INVALID;
+            for (++pos; pos < size && isDigit(text[pos]);)
+                ++pos;
+            if (pos == size)
+                return FLOAT64;
+            return (text[pos] == 'f' && pos + 1 == size) ? FLOAT32 : INVALID;
         }
 
-        bool parseToTokens(std::string formula, TokenContainerRef token_vec)
+        // classifies a token made by parseToTokens(), i.e. a non empty string literal or a run of non delimiters.
+        static TType tokenType(std::string_view text) noexcept
+        {
+            const char front = text.front();
+            if (front == '\"') // a line break can't be in a literal
+                return (text.find_first_of("\n\r") == std::string_view::npos) ? STRING : INVALID;
+            if (front == '-' || isDigit(front))
+                return numberType(text);
+            if (front == '$')
+                return (text.size() > 1 && (isAlpha(text[1]) || text[1] == '_') && isWordTail(text, 2)) ? COLUMN : INVALID;
+            if (isAlpha(front) && isWordTail(text, 1))
+                return (text == "True" || text == "False") ? BOOLEAN : FUNCTION;
+            return INVALID;
+        }
+
+        bool parseToTokens(std::string_view formula, TokenContainerRef token_vec)
         {
             token_vec.clear();
-            std::string current_token;
-            bool is_string = false; // to check if current token is string
-            formula += ' ';
-            for (char c : formula)
+            IndexType invalid_token = INVALID_INDEX; // first invalid token, it is reported after the whole formula is split
+            auto push = [&token_vec, &invalid_token](std::string_view text, TType token_type)
+            {
+                if (token_type == INVALID && invalid_token == INVALID_INDEX)
+                    invalid_token = token_vec.size();
+                Token &token = token_vec.emplace_back();
+                token.source = text;
+                token.token_type = token_type;
+                if (token_type == FUNCTION) // name gets the argument types while resolving, so it is owned.
+                    token.text = text;
+            };
+
+            const SizeType size = formula.size();
+            for (SizeType pos = 0; pos < size;)
             {
-                if (is_string)
+                const char c = formula[pos];
+                if (c == ' ')
+                    ++pos;
+                else if (c == ',' || c == '(' || c == ')')
                 {
-                    current_token.push_back(c);
-                    if (c == '\"')
-                    {
-                        token_vec.push_back({current_token});
-                        current_token.clear();
-                        is_string = false;
-                    }
+                    push(formula.substr(pos, 1), c == ',' ? COMMA : (c == '(' ? P_OPEN : P_CLOSE));
+                    ++pos;
                 }
                 else if (c == '\"')
                 {
-                    if (!current_token.empty())
-                    {
-                        token_vec.push_back({current_token});
-                        current_token.clear();
-                    }
-                    current_token.push_back('\"');
-                    is_string = true;
-                }
-                else if (c == ' ' || c == ',')
-                {
-                    if (!current_token.empty())
+                    const SizeType end = formula.find('\"', pos + 1);
+                    if (end == std::string_view::npos)
                     {
-                        token_vec.push_back({current_token});
-                        current_token.clear();
-                    }
-                    if (c == ',')
-                        token_vec.push_back({","});
-                }
-                else if (c == '(' || c == ')')
-                {
-                    if (!current_token.empty())
-                    {
-                        token_vec.push_back({current_token});
-                        current_token.clear();
+                        err::addLogMsg(err::LogMsg("Parse") << "Unterminated string.");
+                        return false;
                     }
-                    token_vec.push_back({std::string(1, c)});
+                    const std::string_view text = formula.substr(pos, end + 1 - pos);
+                    push(text, tokenType(text));
+                    pos = end + 1;
                 }
                 else
                 {
-                    current_token.push_back(c);
+                    SizeType end = pos + 1;
+                    while (end < size && !isDelimiter(formula[end]))
+                        ++end;
+                    const std::string_view text = formula.substr(pos, end - pos);
+                    push(text, tokenType(text));
+                    pos = end;
                 }
             }
-            if (is_string)
+            if (invalid_token != INVALID_INDEX)
             {
-                err::addLogMsg(err::LogMsg("Parse") << "Unterminated string.");
+                err::addLogMsg(err::LogMsg("Parse") << "Invalid token '" << token_vec[invalid_token].source << "'.");
                 return false;
             }
-            for (TokenRef pt : token_vec)
-            {
-                resolveTokenType(pt);
-                if (pt.token_type == INVALID)
-                {
-                    err::addLogMsg(err::LogMsg("Parse") << "Invalid token '" << pt.text << "'.");
-                    return false;
-                }
-            }
             return true;
         }
 
@@ -152,13 +164,13 @@ namespace km
             {
                 if (token_vec.front().token_type & TT_DATAC)
                     return true;
-                err::addLogMsg(err::LogMsg("Parse") << "Expected literal values or column name but found '" << token_vec.front().text << "'.");
+                err::addLogMsg(err::LogMsg("Parse") << "Expected literal values or column name but found '" << token_vec.front().source << "'.");
                 return false;
             }
 
             else if (size > 1 && !(token_vec.front().token_type & FUNCTION))
             {
-                err::addLogMsg(err::LogMsg("Parse") << "Expected function name but found '" << token_vec.front().text << "'.");
+                err::addLogMsg(err::LogMsg("Parse") << "Expected function name but found '" << token_vec.front().source << "'.");
                 return false;
             }
 
@@ -210,7 +222,7 @@ namespace km
             }
             if (i != size || p_level != 0)
             {
-                err::addLogMsg(err::LogMsg("Parse") << "Invalid syntax near `" << token_vec[i - 1].text << "` token.");
+                err::addLogMsg(err::LogMsg("Parse") << "Invalid syntax near `" << token_vec[i - 1].source << "` token.");
                 return false;
             }
 
@@ -234,27 +246,36 @@ namespace km
             token_vec[end_pos] = token;
         }
 
-        // assigns token.element (Variant) to the actual data by converting token.text
+        // converts the literal text, type suffixes like L and f are left out as the conversion stops there.
+        template <typename Type_>
+        static Type_ fromLiteral(std::string_view text) noexcept
+        {
+            Type_ value{};
+            std::from_chars(text.data(), text.data() + text.size(), value);
+            return value;
+        }
+
+        // assigns token.element (Variant) to the actual data by converting token.source
         // to appropriate data
         void toDataVariant(TokenRef token)
         {
-            const std::string &value = token.text;
+            const std::string_view value = token.source;
             switch (token.token_type)
             {
             case INT32:
-                token.element = static_cast<KInt32>(std::stol(value));
+                token.element = fromLiteral<KInt32>(value);
                 break;
             case INT64:
-                token.element = static_cast<KInt64>(std::stoll(value));
+                token.element = fromLiteral<KInt64>(value);
                 break;
             case FLOAT32:
-                token.element = static_cast<KFloat32>(std::stof(value));
+                token.element = fromLiteral<KFloat32>(value);
                 break;
             case FLOAT64:
-                token.element = static_cast<KFloat64>(std::stod(value));
+                token.element = fromLiteral<KFloat64>(value);
                 break;
             case STRING:
-                token.element = KString(value.begin() + 1, value.end() - 1); // remove "" from "string"
+                token.element = KString(value.substr(1, value.size() - 2)); // remove "" from "string"
                 break;
             case BOOLEAN:
                 token.element = static_cast<KBoolean>(value == "True");
@@ -266,7 +287,7 @@ namespace km
 
         bool findColumn(const AbstractTable *table, TokenRef token)
         {
-            const std::string text(token.text.begin() + 1, token.text.end()); // ommit the dollar sign
+            const std::string text(token.source.substr(1)); // ommit the dollar sign
             auto found_column = table->findColumn(text);
             if (!found_column)
             {
@@ -391,7 +412,7 @@ namespace km
                     if (token.element.asColInfo().type != required_type)
                     {
                         err::addLogMsg(err::LogMsg("DataType") << "Type mismatch, requested type is `"
-                                                               << required_type << "` but the column `" << token.text
+                                                               << required_type << "` but the column `" << token.source
                                                                << "` has type `" << token.element.asColInfo().type << "`.");
                         return false;
                     }
@@ -488,11 +509,10 @@ namespace km
         bool getCheckedToken(const std::string &formula, TokenContainerRef token_vec, const AbstractTable *table, DataType data_type)
         {
             token_vec.clear();
-            if (!parseToTokens(formula, token_vec))
-                return false;
-            if (!checkGrammar(token_vec))
-                return false;
-            if (!checkReference(token_vec, table, data_type))
+            const bool checked = parseToTokens(formula, token_vec) && checkGrammar(token_vec) && checkReference(token_vec, table, data_type);
+            for (TokenRef token : token_vec) // tokens may outlive the formula
+                token.source = {};
+            if (!checked)
                 return false;
             // remove comma, p_open, p_close tokens
             removeSeparator(token_vec);
@@ -516,33 +536,12 @@ namespace km
 
         void evaluateFormula(ConstTokenContainerRef token_vec, AbstractTable *table, IndexType target_column, IndexType start_r, IndexType end_r)
         {
-            std::vector<Variant> data_stack; // std::vector is better than std::stack
-            SizeType argc;
-            std::vector<Variant> arguments;
-            arguments.resize(maxArgc(token_vec)); // now this arguments vector won't be resized.
-            ++end_r;                              // increase it by 1
+            Program program(token_vec, table);
+            ++end_r; // increase it by 1
             for (IndexType row_index = start_r; row_index < end_r; ++row_index)
             {
-                for (ConstTokenRef token : token_vec)
-                {
-                    if (token.token_type & FUNCTION)
-                    {
-                        argc = token.element.asFncInfo().argc;
-                        std::copy(data_stack.end() - argc, data_stack.end(), arguments.begin());
-                        data_stack.erase(data_stack.end() - argc, data_stack.end());
-                        data_stack.push_back(token.element.asFncInfo().function(arguments.data()));
-                    }
-                    else if (token.token_type & COLUMN)
-                    {
-                        data_stack.push_back(table->getDataWC(row_index, token.element.asColInfo().index));
-                    }
-                    else if (token.token_type & TT_DATA)
-                    {
-                        data_stack.push_back(token.element.asData());
-                    }
-                }
-                table->setDataWC(row_index, target_column, data_stack.back());
-                data_stack.pop_back();
+                program.run(row_index);
+                table->setDataWC(row_index, target_column, program.getResult());
             }
         }
 
@@ -573,6 +572,69 @@ namespace km
             return data_stack.back();
         }
 
+        // moves pos to the first token of the sub formula which ends at token_vec[pos - 1].
+        static void skipSubFormula(ConstTokenContainerRef token_vec, IndexType &pos)
+        {
+            ConstTokenRef token = token_vec[--pos];
+            if (token.token_type & FUNCTION)
+            {
+                for (SizeType argc = token.element.asFncInfo().argc; argc > 0; --argc)
+                    skipSubFormula(token_vec, pos);
+            }
+        }
+
+        // finds rows which may satisfy the boolean sub formula ending at token_vec[pos - 1] using zone maps.
+        // only comparisons of a column with a literal, and AND/OR of them are understood. It returns false if no
+        // row can be skipped. pos is moved to the first token of the sub formula.
+        static bool candidateMask(ConstTokenContainerRef token_vec, IndexType &pos, const AbstractTable *table, BitVector &mask)
+        {
+            static const std::vector<std::pair<std::string, CompareOp>> comparisons{
+                {"isLess", CompareOp::LESS},
+                {"isLessOrEqual", CompareOp::LESS_OR_EQUAL},
+                {"isEqual", CompareOp::EQUAL},
+                {"isGreaterOrEqual", CompareOp::GREATER_OR_EQUAL},
+                {"isGreater", CompareOp::GREATER}};
+
+            const IndexType end = pos;
+            ConstTokenRef token = token_vec[end - 1];
+            if (!(token.token_type & FUNCTION) || token.element.asFncInfo().argc != 2)
+            {
+                skipSubFormula(token_vec, pos);
+                return false;
+            }
+            const std::string name = token.text.substr(0, token.text.rfind('_'));
+            if (name == "AND" || name == "OR")
+            {
+                --pos;
+                BitVector rhs;
+                const bool has_rhs = candidateMask(token_vec, pos, table, rhs);
+                const bool has_lhs = candidateMask(token_vec, pos, table, mask);
+                if (name == "OR")
+                {
+                    if (has_lhs && has_rhs)
+                        mask |= rhs;
+                    return has_lhs && has_rhs;
+                }
+                if (has_lhs && has_rhs)
+                    mask &= rhs;
+                else if (has_rhs)
+                    mask = std::move(rhs);
+                return has_lhs || has_rhs;
+            }
+            skipSubFormula(token_vec, pos);
+            auto it = std::find_if(comparisons.begin(), comparisons.end(), [&name](const auto &p)
+                                   { return p.first == name; });
+            if (it == comparisons.end() || end - pos != 3)
+                return false;
+            ConstTokenRef lhs = token_vec[pos];
+            ConstTokenRef rhs = token_vec[pos + 1];
+            if ((lhs.token_type & COLUMN) && (rhs.token_type & TT_DATA))
+                return table->getCandidateMask(lhs.element.asColInfo().index, it->second, rhs.element.asData(), mask);
+            if ((lhs.token_type & TT_DATA) && (rhs.token_type & COLUMN))
+                return table->getCandidateMask(rhs.element.asColInfo().index, swapOperands(it->second), lhs.element.asData(), mask);
+            return false;
+        }
+
         bool filter(const std::string &formula, std::vector<IndexType> &index_vec, const AbstractTable *table)
         {
             TokenContainer token_vec;
@@ -591,43 +653,72 @@ namespace km
 
         void filter(ConstTokenContainerRef token_vec, std::vector<IndexType> &index_vec, const AbstractTable *table)
         {
-            // now we can evaluate formula
-            std::vector<Variant> data_stack;
-            SizeType argc;
-            std::vector<Variant> arguments;
-            arguments.resize(maxArgc(token_vec));
+            // rows having null in any referred column are not selected, find them in bulk.
+            BitVector validity;
+            bool has_null = false;
+            for (ConstTokenRef token : token_vec)
+            {
+                BitVector column_validity;
+                if ((token.token_type & COLUMN) && table->getValidityMask(token.element.asColInfo().index, column_validity))
+                {
+                    if (has_null)
+                        validity &= column_validity;
+                    else
+                        validity = std::move(column_validity);
+                    has_null = true;
+                }
+            }
+
+            if (token_vec.size() == 1 && (token_vec.front().token_type & COLUMN))
+            {
+                // a boolean column itself is the selection mask.
+                BitVector mask;
+                table->getBooleanMask(token_vec.front().element.asColInfo().index, mask);
+                if (has_null)
+                    mask &= validity;
+                filter(mask, index_vec);
+                return;
+            }
+            // rows of blocks which can't satisfy the formula (as per zone maps) are not evaluated.
+            BitVector candidates;
+            IndexType pos = token_vec.size();
+            const bool has_candidates = !token_vec.empty() && candidateMask(token_vec, pos, table, candidates);
+            if (has_candidates && has_null)
+                candidates &= validity;
+
+            // now we can evaluate formula, it is compiled once for all the rows.
+            Program program(token_vec, table);
+            auto evaluate = [&](IndexType row_index)
+            {
+                program.run(row_index);
+                if (program.getBoolean())
+                    index_vec.push_back(row_index);
+            };
 
             const SizeType row_count = table->rowCount();
+            if (has_candidates)
+            {
+                index_vec.reserve(candidates.count());
+                candidates.forEachSetBit(evaluate);
+                return;
+            }
             index_vec.reserve(row_count);
             for (SizeType row_index = 0; row_index < row_count; ++row_index)
             {
-                for (ConstTokenRef token : token_vec)
-                {
-                    if (token.token_type & FUNCTION)
-                    {
-                        argc = token.element.asFncInfo().argc;
-                        std::copy(data_stack.end() - argc, data_stack.end(), arguments.begin());
-                        data_stack.erase(data_stack.end() - argc, data_stack.end());
-                        data_stack.push_back(token.element.asFncInfo().function(arguments.data()));
-                    }
-                    else if (token.token_type & COLUMN)
-                    {
-                        data_stack.push_back(table->getDataWC(row_index, token.element.asColInfo().index));
-                    }
-                    else if (token.token_type & TT_DATA)
-                    {
-                        data_stack.push_back(token.element.asData());
-                    }
-                }
-                if (data_stack.back().asBoolean())
-                    index_vec.push_back(row_index);
-                data_stack.pop_back();
+                if (has_null && !validity.test(row_index))
+                    continue;
+                evaluate(row_index);
             }
             index_vec.shrink_to_fit();
         }
 
         bool filter(ConstTokenContainerRef token_vec, const AbstractTable *table, IndexType row_index)
         {
+            for (ConstTokenRef token : token_vec)
+            {
+                if ((token.token_type & COLUMN) && table->isNull(row_index, token.element.asColInfo().index))
+                    return false;
+            }
             std::vector<Variant> data_stack; // std::vector is better than std::stack
             std::vector<Variant> arguments;
             arguments.resize(maxArgc(token_vec)); // now this arguments vector won't be resized.
@@ -652,5 +743,12 @@ namespace km
             }
             return data_stack.back().asBoolean();
         }
+
+        void filter(const BitVector &mask, std::vector<IndexType> &index_vec)
+        {
+            index_vec.reserve(index_vec.size() + mask.count());
+            mask.forEachSetBit([&index_vec](IndexType index)
+                               { index_vec.push_back(index); });
+        }
     } // namespace parse
 } // namespace km
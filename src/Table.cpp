@@ -1,9 +1,12 @@
 #include "Table.hpp"
 
 #include <algorithm>
+#include <numeric> //std::iota
 
 #include "ErrorHandler.hpp"
+#include "ThreadPool.hpp"
 #include "KException.h"
+#include "TokenType.h"
 
 namespace km
 {
@@ -55,16 +58,33 @@ namespace km
             }
             return error;
         }
+
+        bool isFloatType(DataType data_type)
+        {
+            return data_type == DataType::FLOAT32 || data_type == DataType::FLOAT64;
+        }
+
+        // minimum number of rows for which a formula is evaluated on more than one thread.
+        constexpr SizeType k_parallel_evaluation_threshold = SizeType(1) << 14;
     } // namespace
 
     Table::Table(
         const std::string &table_name,
         const std::vector<ColumnMetaData> &column_list,
-        SortingOrder sorting_order)
+        SortingOrder sorting_order,
+        std::pmr::memory_resource *resource)
         : AbstractTable(table_name, "Table[" + table_name + "]", sorting_order),
           m_base_column(nullptr),
+          m_resource(resource),
           m_comparator((sorting_order == SortingOrder::ASCENDING) ? &AbstractColumn::isLess : &AbstractColumn::isGreater),
-          m_mfst(64)
+          m_mfst(64),
+          m_clustered_mode(false),
+          m_cluster_threshold(0),
+          m_unclustered_count(0),
+          m_paused_row_count(0),
+          m_compaction_mode(CompactionMode::IMMEDIATE),
+          m_compaction_slice(256),
+          m_compacting(false)
     {
         if (!isValidTableName(table_name))
         {
@@ -96,10 +116,10 @@ namespace km
             }
         }
 
-        for (const auto &[column_name, display_name, data_type] : column_list)
+        for (const auto &[column_name, display_name, data_type, storage] : column_list)
         {
             AbstractColumnPtr_ ptr = nullptr;
-            createColumn(ptr, column_name, display_name, data_type);
+            createColumn(ptr, column_name, display_name, data_type, storage, m_resource);
             m_columns.push_back(ptr);
         }
 
@@ -118,11 +138,40 @@ namespace km
 
     IndexType Table::insertRow(const std::vector<Variant> &values) noexcept
     {
+        return insertRow_(values, {});
+    }
+
+    IndexType Table::insertRow(std::vector<Variant> &&values) noexcept
+    {
+        return insertRow_(std::move(values), {});
+    }
+
+    IndexType Table::insertRowN(const std::vector<std::optional<Variant>> &values) noexcept
+    {
+        std::vector<Variant> data(values.size());
+        std::vector<bool> nulls(values.size());
+        for (IndexType i = 0, size = values.size(); i < size; ++i)
+        {
+            if (values[i])
+                data[i] = values[i].value();
+            else
+                nulls[i] = true;
+        }
+        return insertRow_(std::move(data), nulls);
+    }
+
+    template <typename Values_>
+    IndexType Table::insertRow_(Values_ &&values, const std::vector<bool> &nulls) noexcept
+    {
+        // strings are moved out of @a values if it is an rvalue.
+        constexpr bool k_move_values = !std::is_lvalue_reference_v<Values_>;
         if (m_columns.empty() || values.size() != m_columns.size())
         {
             err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ InvalidArgs") << "Invalid number of values are given to insert.");
             return INVALID_INDEX;
         }
+        auto is_null = [&nulls](IndexType column_index)
+        { return !nulls.empty() && nulls[column_index]; };
         try
         {
             IndexType index = 0;
@@ -131,7 +180,12 @@ namespace km
                 index = m_free_space.back();
                 for (IndexType i = 0; i < m_columns.size(); ++i)
                 {
-                    m_columns[i]->setData(values[i], index); // this may throw
+                    if (is_null(i))
+                        continue;
+                    if constexpr (k_move_values)
+                        m_columns[i]->setMovedData(std::move(values[i]), index); // this may throw
+                    else
+                        m_columns[i]->setData(values[i], index); // this may throw
                 }
                 m_free_space.pop_back();
             }
@@ -142,7 +196,12 @@ namespace km
                 {
                     try
                     {
-                        m_columns[i]->pushData(values[i]);
+                        if (is_null(i))
+                            m_columns[i]->createSpace();
+                        else if constexpr (k_move_values)
+                            m_columns[i]->pushMovedData(std::move(values[i]));
+                        else
+                            m_columns[i]->pushData(values[i]);
                     }
                     catch (const std::exception &e)
                     {
@@ -155,33 +214,350 @@ namespace km
                     }
                 }
             }
-            if (!isSortingPaused())
+            for (IndexType i = 0, size = m_columns.size(); i < size; ++i)
+                m_columns[i]->setNull(index, is_null(i)); // also clears nulls left by the dropped row
+            return placeRow(index);
+        }
+        catch (const std::bad_variant_access & /*e*/)
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ DataType") << "Couldn't insert the row, insertion failed due to `type mismatch`.");
+        }
+        catch (const std::exception &e)
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ UnknownException") << "Unknown excepton caught `" << e.what() << "`.");
+        }
+        return INVALID_INDEX;
+    }
+
+    bool Table::insertRows(const std::vector<std::vector<Variant>> &data, DataLayout layout) noexcept
+    {
+        return insertRows_(data, layout, {});
+    }
+
+    bool Table::insertRows_(const std::vector<std::vector<Variant>> &data, DataLayout layout, const std::vector<std::vector<bool>> &nulls) noexcept
+    {
+        const SizeType column_count = m_columns.size();
+        const bool row_major = (layout == DataLayout::ROW_MAJOR);
+        const SizeType new_row_count = row_major ? data.size() : (data.empty() ? 0 : data.front().size());
+        const bool valid_shape = row_major ? std::all_of(data.begin(), data.end(), [column_count](const std::vector<Variant> &row)
+                                                         { return row.size() == column_count; })
+                                           : (data.size() == column_count && std::all_of(data.begin(), data.end(), [new_row_count](const std::vector<Variant> &column)
+                                                                                         { return column.size() == new_row_count; }));
+        const bool valid_nulls = nulls.empty() || (row_major && nulls.size() == new_row_count &&
+                                                   std::all_of(nulls.begin(), nulls.end(), [column_count](const std::vector<bool> &row_nulls)
+                                                               { return row_nulls.empty() || row_nulls.size() == column_count; }));
+        if (m_columns.empty() || !valid_shape || !valid_nulls)
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ InvalidArgs") << "Invalid number of values are given to insert.");
+            return false;
+        }
+        if (new_row_count == 0)
+            return true;
+
+        // new rows are appended after the physical rows, free space is left for insertRow().
+        const IndexType first_index = m_indices.size() + m_free_space.size();
+        auto is_null = [&nulls](IndexType row_index, IndexType column_index)
+        { return !nulls.empty() && !nulls[row_index].empty() && nulls[row_index][column_index]; };
+        IndexType column_index = 0;
+        SizeType pushed = 0; // values pushed to the current column
+        try
+        {
+            for (; column_index < column_count; ++column_index)
             {
-                auto iterator = std::upper_bound(m_indices.begin(), m_indices.end(), 0,
-                                                 [this, index](IndexType /**/, IndexType mid)
-                                                 {
-                                                     return (m_base_column->*m_comparator)(index, mid);
-                                                 });
-                IndexType insertion_index = iterator - m_indices.begin();
-                m_indices.insert(iterator, index);
-                KM_EMIT rowInsertionEvent(insertion_index);
-                return insertion_index;
+                AbstractColumn *column = m_columns[column_index];
+                column->reserve(first_index + new_row_count);
+                for (pushed = 0; pushed < new_row_count; ++pushed)
+                {
+                    if (is_null(pushed, column_index))
+                        column->createSpace();
+                    else
+                        column->pushData(row_major ? data[pushed][column_index] : data[column_index][pushed]);
+                }
+                for (IndexType row_index = 0; row_index < new_row_count; ++row_index)
+                    column->setNull(first_index + row_index, is_null(row_index, column_index)); // also clears nulls left by popped data
             }
+        }
+        catch (const std::exception &e)
+        {
+            // remove what is appended so far.
+            for (; pushed > 0; --pushed)
+                m_columns[column_index]->popData();
+            for (IndexType j = column_index; j-- > 0;)
+                for (IndexType row_index = 0; row_index < new_row_count; ++row_index)
+                    m_columns[j]->popData();
+            if (dynamic_cast<const std::bad_variant_access *>(&e))
+                err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ DataType") << "Couldn't insert the rows, insertion failed due to `type mismatch`.");
             else
+                err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ UnknownException") << "Unknown excepton caught `" << e.what() << "`.");
+            return false;
+        }
+        for (IndexType row_index = 0; row_index < new_row_count; ++row_index)
+            indexRow(first_index + row_index);
+
+        const bool sorting_paused = isSortingPaused();
+        std::vector<IndexType> row_indices;
+        m_indices.update([&](std::vector<IndexType> &indices)
+                         {
+                             const SizeType old_row_count = indices.size();
+                             indices.resize(old_row_count + new_row_count);
+                             std::iota(indices.begin() + old_row_count, indices.end(), first_index);
+                             if (sorting_paused)
+                                 return;
+
+                             // sort only the new run and merge it, equal keys are kept after existing rows like insertRow().
+                             auto is_key_less = [this](IndexType index1, IndexType index2)
+                             { return isKeyLess(index1, index2); };
+                             std::stable_sort(indices.begin() + old_row_count, indices.end(), is_key_less);
+                             std::inplace_merge(indices.begin(), indices.begin() + old_row_count, indices.end(), is_key_less);
+
+                             row_indices.reserve(new_row_count);
+                             for (IndexType i = 0, size = indices.size(); i < size; ++i)
+                             {
+                                 if (indices[i] >= first_index)
+                                 {
+                                     row_indices.push_back(i);
+                                     if (i && indices[i - 1] > indices[i])
+                                         ++m_unclustered_count;
+                                 }
+                             } });
+        if (sorting_paused)
+            return true;
+        KM_EMIT rowsInsertionEvent(row_indices);
+        if (m_clustered_mode && m_cluster_threshold && m_unclustered_count >= m_cluster_threshold)
+            cluster();
+        reclaimSpace();
+        return true;
+    }
+
+    IndexType Table::placeRow(IndexType index)
+    {
+        indexRow(index);
+        if (isSortingPaused())
+        {
+            m_indices.push_back(index);
+            return m_indices.size() - 1;
+        }
+        IndexType insertion_index = m_indices.partitionPoint([this, index](IndexType mid)
+                                                             { return !isKeyLess(index, mid); });
+        m_indices.insert(insertion_index, index);
+        if (insertion_index + 1 != m_indices.size() || (insertion_index && m_indices[insertion_index - 1] > index))
+            ++m_unclustered_count;
+        KM_EMIT rowInsertionEvent(insertion_index);
+        if (m_clustered_mode && m_cluster_threshold && m_unclustered_count >= m_cluster_threshold)
+            cluster();
+        reclaimSpace(); // doesn't change the order of rows
+        return insertion_index;
+    }
+
+    IndexType Table::upsert(const std::vector<Variant> &values) noexcept
+    {
+        if (isSortingPaused())
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ SortingPaused") << "Rows can't be upserted while sorting is paused.");
+            return INVALID_INDEX;
+        }
+        if (!isValidRow(values, {}))
+            return INVALID_INDEX;
+        const Variant &key = values.front();
+        const bool ascending = (m_sorder == SortingOrder::ASCENDING);
+        const bool nulls_first = (getNullOrder() == NullOrder::FIRST);
+        const IndexType row_index = m_indices.partitionPoint([&](IndexType index)
+                                                             { return m_base_column->isNull(index) ? nulls_first : (ascending ? m_base_column->isLessV(index, key) : m_base_column->isGreaterV(index, key)); });
+        if (row_index == rowCount() || m_base_column->isNull(m_indices[row_index]) || !m_base_column->isEqualV(m_indices[row_index], key))
+            return insertRow(values);
+        try
+        {
+            if (updateRow(row_index, values, {}))
+                return row_index;
+        }
+        catch (const std::exception &e)
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ UnknownException") << "Unknown excepton caught `" << e.what() << "`.");
+            return INVALID_INDEX;
+        }
+        dropRow(row_index); // a sort key is changed
+        return insertRow(values);
+    }
+
+    bool Table::mergeFrom(const std::vector<std::vector<Variant>> &rows) noexcept
+    {
+        return mergeRows(rows, {});
+    }
+
+    bool Table::mergeFrom(const Table &other) noexcept
+    {
+        const SizeType column_count = m_columns.size();
+        bool same_columns = (other.columnCount() == column_count);
+        for (IndexType column_index = 0; same_columns && column_index < column_count; ++column_index)
+            same_columns = (other.m_columns[column_index]->getDataType() == m_columns[column_index]->getDataType());
+        if (!same_columns)
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ InvalidArgs") << "Columns of `" << other.getDecoratedName() << "` don't match, it can't be merged.");
+            return false;
+        }
+        const SizeType row_count = other.rowCount();
+        std::vector<std::vector<Variant>> rows(row_count, std::vector<Variant>(column_count));
+        std::vector<std::vector<bool>> nulls(row_count);
+        for (IndexType row_index = 0; row_index < row_count; ++row_index)
+        {
+            for (IndexType column_index = 0; column_index < column_count; ++column_index)
             {
-                m_indices.push_back(index);
-                return m_indices.size() - 1;
+                if (!other.isNull(row_index, column_index))
+                    rows[row_index][column_index] = other.getDataWC(row_index, column_index);
+                else
+                {
+                    nulls[row_index].resize(column_count);
+                    nulls[row_index][column_index] = true;
+                }
             }
         }
-        catch (const std::bad_variant_access & /*e*/)
+        return mergeRows(rows, nulls);
+    }
+
+    bool Table::isValidRow(const std::vector<Variant> &values, const std::vector<bool> &nulls) const
+    {
+        if (m_columns.empty() || values.size() != m_columns.size() || (!nulls.empty() && nulls.size() != values.size()))
         {
-            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ DataType") << "Couldn't insert the row, insertion failed due to `type mismatch`.");
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ InvalidArgs") << "Invalid number of values are given to insert.");
+            return false;
+        }
+        for (IndexType column_index = 0, column_count = m_columns.size(); column_index < column_count; ++column_index)
+        {
+            if ((nulls.empty() || !nulls[column_index]) && dataTypeOf(values[column_index]) != m_columns[column_index]->getDataType())
+            {
+                err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ DataType") << "Value for column `" << m_columns[column_index]->getName() << "` has wrong data type.");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Table::updateRow(IndexType row_index, const std::vector<Variant> &values, const std::vector<bool> &nulls)
+    {
+        const IndexType index = m_indices[row_index];
+        auto is_null = [&nulls](IndexType column_index)
+        { return !nulls.empty() && nulls[column_index]; };
+        auto differs = [&](IndexType column_index)
+        {
+            const AbstractColumn *column = m_columns[column_index];
+            if (column->isNull(index) || is_null(column_index))
+                return column->isNull(index) != is_null(column_index);
+            return !isEqualComparatorFor(column->getDataType())(column->getData(index), values[column_index]);
+        };
+        if (std::any_of(m_sort_keys.begin(), m_sort_keys.end(), [&differs](const std::pair<IndexType, SortingOrder> &key)
+                        { return differs(key.first); }))
+            return false;
+
+        for (IndexType column_index = 1, column_count = m_columns.size(); column_index < column_count; ++column_index)
+        {
+            if (!differs(column_index))
+                continue;
+            AbstractColumn *column = m_columns[column_index];
+            Variant old_data = column->getData(index);
+            SecondaryIndex *secondary_index = indexOf(column_index);
+            if (secondary_index)
+                secondary_index->erase(*column, index);
+            if (is_null(column_index))
+                column->setNull(index);
+            else
+            {
+                column->setData(values[column_index], index);
+                column->setNull(index, false);
+                if (secondary_index)
+                    secondary_index->insert(*column, index);
+            }
+            KM_EMIT dataUpdateEvent(row_index, column_index, old_data);
+        }
+        return true;
+    }
+
+    bool Table::mergeRows(const std::vector<std::vector<Variant>> &rows, const std::vector<std::vector<bool>> &nulls) noexcept
+    {
+        if (isSortingPaused())
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ SortingPaused") << "Rows can't be merged while sorting is paused.");
+            return false;
+        }
+        static const std::vector<bool> k_no_nulls;
+        auto nulls_of = [&nulls](IndexType r) -> const std::vector<bool> &
+        { return nulls.empty() ? k_no_nulls : nulls[r]; };
+        for (IndexType r = 0, size = rows.size(); r < size; ++r)
+        {
+            if (!isValidRow(rows[r], nulls_of(r)))
+                return false;
+        }
+        if (rows.empty())
+            return true;
+
+        // sort the rows by key in the order of the table, rows with equal keys keep their order.
+        const bool ascending = (m_sorder == SortingOrder::ASCENDING);
+        const bool nulls_first = (getNullOrder() == NullOrder::FIRST);
+        const VariantComparator is_less = isLessComparatorFor(m_base_column->getDataType());
+        const VariantComparator is_equal = isEqualComparatorFor(m_base_column->getDataType());
+        auto is_null_key = [&nulls_of](IndexType r)
+        { return !nulls_of(r).empty() && nulls_of(r).front(); };
+        std::vector<IndexType> order(rows.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](IndexType r1, IndexType r2)
+                         {
+                             const bool null1 = is_null_key(r1), null2 = is_null_key(r2);
+                             if (null1 || null2)
+                                 return nulls_first ? (null1 && !null2) : (!null1 && null2);
+                             return ascending ? is_less(rows[r1].front(), rows[r2].front()) : is_less(rows[r2].front(), rows[r1].front()); });
+
+        // walk the table and the sorted rows together, a row with null key never matches.
+        auto precedes = [this, ascending, nulls_first](IndexType index, const Variant &key)
+        { return m_base_column->isNull(index) ? nulls_first : (ascending ? m_base_column->isLessV(index, key) : m_base_column->isGreaterV(index, key)); };
+        const std::vector<IndexType> &indices = m_indices.flat();
+        const SizeType row_count = indices.size();
+        std::vector<IndexType> dropped_rows; // matched rows whose sort key is changed
+        std::vector<IndexType> new_rows;     // rows of @a rows to insert
+        try
+        {
+            for (IndexType k = 0, size = order.size(), row_index = 0; k < size; ++k)
+            {
+                const IndexType r = order[k];
+                if (is_null_key(r))
+                {
+                    new_rows.push_back(r);
+                    continue;
+                }
+                const Variant &key = rows[r].front();
+                if (k + 1 < size && !is_null_key(order[k + 1]) && is_equal(key, rows[order[k + 1]].front()))
+                    continue; // the last row with this key wins
+                while (row_index < row_count && precedes(indices[row_index], key))
+                    ++row_index;
+                const bool matched = (row_index < row_count && !m_base_column->isNull(indices[row_index]) && m_base_column->isEqualV(indices[row_index], key));
+                if (!matched)
+                    new_rows.push_back(r);
+                else if (!updateRow(row_index, rows[r], nulls_of(r)))
+                {
+                    dropped_rows.push_back(row_index);
+                    new_rows.push_back(r);
+                }
+            }
         }
         catch (const std::exception &e)
         {
             err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ UnknownException") << "Unknown excepton caught `" << e.what() << "`.");
+            return false;
         }
-        return INVALID_INDEX;
+
+        if (!dropped_rows.empty() && !dropRows(dropped_rows))
+            return false;
+        // new rows, with their nulls, are inserted in one batch.
+        std::vector<std::vector<Variant>> batch;
+        std::vector<std::vector<bool>> batch_nulls;
+        batch.reserve(new_rows.size());
+        if (!nulls.empty())
+            batch_nulls.reserve(new_rows.size());
+        for (IndexType r : new_rows)
+        {
+            batch.push_back(rows[r]);
+            if (!nulls.empty())
+                batch_nulls.push_back(nulls[r]);
+        }
+        return insertRows_(batch, DataLayout::ROW_MAJOR, batch_nulls);
     }
 
     bool Table::dropRow(IndexType row_index)
@@ -189,21 +565,65 @@ namespace km
         const IndexType row_count = rowCount();
         if (row_index >= row_count)
             return false;
+        unindexRow(m_indices[row_index]);
         m_free_space.push_back(m_indices[row_index]);
-        m_indices.erase(m_indices.begin() + row_index);
+        m_indices.erase(row_index);
         KM_EMIT rowDropEvent(row_index);
-        if (m_mfst <= m_free_space.size())
-            freeSpace();
+        reclaimSpace();
+        return true;
+    }
+
+    bool Table::dropRows(std::vector<IndexType> row_indices)
+    {
+        std::sort(row_indices.begin(), row_indices.end());
+        row_indices.erase(std::unique(row_indices.begin(), row_indices.end()), row_indices.end());
+        const SizeType row_count = rowCount();
+        if (!row_indices.empty() && row_indices.back() >= row_count)
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ InvalidArgs") << "Row index " << KInt64(row_indices.back())
+                                                                              << " is out of range, no row is dropped.");
+            return false;
+        }
+        if (row_indices.empty())
+            return true;
+
+        // single stable pass, dropped rows are moved to free space.
+        m_free_space.reserve(m_free_space.size() + row_indices.size());
+        m_indices.update([this, &row_indices, row_count](std::vector<IndexType> &indices)
+                         {
+                             IndexType kept = 0;
+                             for (IndexType row_index = 0, k = 0; row_index < row_count; ++row_index)
+                             {
+                                 if (k < row_indices.size() && row_indices[k] == row_index)
+                                 {
+                                     unindexRow(indices[row_index]);
+                                     m_free_space.push_back(indices[row_index]);
+                                     ++k;
+                                 }
+                                 else
+                                     indices[kept++] = indices[row_index];
+                             }
+                             indices.resize(kept); });
+        KM_EMIT rowsDropEvent(row_indices);
+        reclaimSpace();
         return true;
     }
 
+    bool Table::dropWhere(const std::string &formula)
+    {
+        std::vector<IndexType> row_indices;
+        if (!parse::filter(formula, row_indices, this))
+            return false;
+        return dropRows(std::move(row_indices));
+    }
+
     bool Table::addColumnE(const ColumnMetaData &column, const std::string &formula)
     {
         if (!validateForNewColumn(column.column_name, column.data_type))
             return false;
 
         AbstractColumnPtr_ column_ptr = nullptr;
-        createColumn(column_ptr, column.column_name, column.display_name, column.data_type);
+        createColumn(column_ptr, column.column_name, column.display_name, column.data_type, column.storage, m_resource);
         // store it in advance, like if it doesn't enter the if block, it will be still part of the column
         m_columns.push_back(column_ptr);
         IndexType row_count = rowCount();
@@ -221,7 +641,8 @@ namespace km
                 m_columns.pop_back();
                 return false;
             }
-            parse::evaluateFormula(tokens, this, m_columns.size() - 1, 0, row_count - 1);
+            evaluateColumn(m_columns.size() - 1, tokens);
+            propagateNulls(m_columns.size() - 1, tokens);
         }
         if (m_columns.size() == 1)
         {
@@ -246,10 +667,10 @@ namespace km
         }
 
         AbstractColumnPtr_ column_ptr = nullptr;
-        createColumn(column_ptr, column.column_name, column.display_name, column.data_type);
+        createColumn(column_ptr, column.column_name, column.display_name, column.data_type, column.storage, m_resource);
         IndexType row_count = rowCount();
         column_ptr->resize(row_count + m_free_space.size());
-        for (IndexType i : m_indices)
+        for (IndexType i : m_indices.flat())
         {
             column_ptr->setData(fill_with, i);
         }
@@ -281,8 +702,11 @@ namespace km
                            << "Given formula `" << formula << "` to transform column `" << column_name << "` is invalid.");
             return false;
         }
-        parse::evaluateFormula(token_vec, this, column_index, 0, rowCount() - 1);
-        if (column_index == 0)
+        evaluateColumn(column_index, token_vec);
+        propagateNulls(column_index, token_vec);
+        if (SecondaryIndex *index = indexOf(column_index))
+            index->rebuild(*m_columns[column_index], m_indices.flat());
+        if (isSortColumn(column_index))
             sort();
         else
             KM_EMIT columnTransformedEvent(column_index);
@@ -303,18 +727,128 @@ namespace km
         {
             return searchInKeyColumn(data);
         }
+        else if (const SecondaryIndex *index = indexOf(column_index); index && !isSortingPaused() && !isFloatType(found_column.value().second))
+        {
+            // float columns are compared with epsilon, an ordered index on them is used only by searchRange().
+            std::vector<IndexType> indices;
+            index->findEqual(*m_columns[column_index], data, indices);
+            return rowsOf(indices);
+        }
         else
         {
             std::vector<IndexType> result_indices;
-            const SizeType row_count = rowCount();
-            AbstractColumnPtr_ column_ptr = m_columns[column_index];
-            for (IndexType index = 0; index < row_count; ++index)
+            const AbstractColumn *column = m_columns[column_index];
+            column->findEqualV(data, m_indices.flat(), result_indices);
+            if (column->hasValidity())
+                result_indices.erase(std::remove_if(result_indices.begin(), result_indices.end(), [this, column](IndexType row_index)
+                                                    { return column->isNull(m_indices[row_index]); }),
+                                     result_indices.end());
+            return result_indices;
+        }
+    }
+
+    bool Table::createIndex(const std::string &column_name, IndexKind kind)
+    {
+        const auto found_column = findColumn(column_name);
+        if (!found_column)
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ Name") << "Column `" << column_name << "` to create index doesn't exist in this table.");
+            return false;
+        }
+        const auto &[column_index, data_type] = found_column.value();
+        if (column_index == 0)
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ InvalidArgs") << "Column `" << column_name
+                                                                              << "` is the key column, it is already sorted and doesn't need an index.");
+            return false;
+        }
+        if (kind == IndexKind::HASH && isFloatType(data_type))
+        {
+            err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ InvalidArgs") << "Column `" << column_name << "` has type `" << data_type
+                                                                              << "`, it is compared with epsilon so it can't have a hash index.");
+            return false;
+        }
+
+        std::unique_ptr<SecondaryIndex> index;
+        switch (kind)
+        {
+        case IndexKind::HASH:
+            index.reset(new HashIndex());
+            break;
+        case IndexKind::ORDERED:
+            index.reset(new OrderedIndex());
+            break;
+        }
+        index->rebuild(*m_columns[column_index], m_indices.flat());
+        if (m_secondary_indices.size() <= column_index)
+            m_secondary_indices.resize(column_index + 1);
+        m_secondary_indices[column_index] = std::move(index);
+        return true;
+    }
+
+    bool Table::dropIndex(const std::string &column_name)
+    {
+        const auto found_column = findColumn(column_name);
+        if (!found_column || !indexOf(found_column.value().first))
+            return false;
+        m_secondary_indices[found_column.value().first].reset();
+        return true;
+    }
+
+    bool Table::hasIndex(const std::string &column_name) const
+    {
+        const auto found_column = findColumn(column_name);
+        return found_column && indexOf(found_column.value().first);
+    }
+
+    std::vector<IndexType> Table::searchRange(const std::string &column_name, const Variant &low, const Variant &high, bool low_inclusive, bool high_inclusive) const
+    {
+        if (!rowCount())
+            return {};
+        const auto found_column = findColumn(column_name);
+        if (!found_column || low.index() != indexForDataType(found_column.value().second) || high.index() != low.index())
+            return {};
+        const IndexType column_index = found_column.value().first;
+        const AbstractColumn *column = m_columns[column_index];
+        std::vector<IndexType> result_indices;
+
+        if (column_index == 0 && !isSortingPaused())
+        {
+            // rows in the range are adjacent, find the first and the last one.
+            const bool ascending = (m_sorder == SortingOrder::ASCENDING);
+            const bool nulls_first = (getNullOrder() == NullOrder::FIRST);
+            auto precedes = [column, ascending, nulls_first](IndexType index, const Variant &bound, bool or_equal)
             {
-                if (column_ptr->isEqualV(m_indices[index], data))
-                    result_indices.push_back(index);
-            }
+                if (column->isNull(index))
+                    return nulls_first;
+                const bool is_less = column->isLessV(index, bound), is_greater = column->isGreaterV(index, bound);
+                return (ascending ? is_less : is_greater) || (or_equal && !is_less && !is_greater);
+            };
+            const IndexType first = m_indices.partitionPoint([&](IndexType index)
+                                                             { return ascending ? precedes(index, low, !low_inclusive) : precedes(index, high, !high_inclusive); });
+            const IndexType last = m_indices.partitionPoint([&](IndexType index)
+                                                            { return ascending ? precedes(index, high, high_inclusive) : precedes(index, low, low_inclusive); });
+            for (IndexType row_index = first; row_index < last; ++row_index)
+                result_indices.push_back(row_index);
             return result_indices;
         }
+
+        std::vector<IndexType> indices;
+        if (const SecondaryIndex *index = indexOf(column_index);
+            index && !isSortingPaused() && index->findRange(*column, low, low_inclusive, high, high_inclusive, indices))
+            return rowsOf(indices);
+
+        for (IndexType row_index = 0, row_count = rowCount(); row_index < row_count; ++row_index)
+        {
+            const IndexType index = m_indices[row_index];
+            if (column->isNull(index))
+                continue;
+            const bool above_low = column->isGreaterV(index, low) || (low_inclusive && !column->isLessV(index, low));
+            const bool below_high = column->isLessV(index, high) || (high_inclusive && !column->isGreaterV(index, high));
+            if (above_low && below_high)
+                result_indices.push_back(row_index);
+        }
+        return result_indices;
     }
 
     std::vector<IndexType> Table::searchInKeyColumn(const Variant &data) const
@@ -324,15 +858,17 @@ namespace km
         std::vector<IndexType> result_indices;
         // search in key column
         auto comparator = (m_sorder == SortingOrder::ASCENDING) ? &AbstractColumn::isLessV : &AbstractColumn::isGreaterV;
-        auto itr = std::lower_bound(m_indices.begin(), m_indices.end(), data, [this, comparator](IndexType index, const Variant &data)
-                                    { return (m_base_column->*comparator)(index, data); });
-        IndexType index = std::distance(m_indices.begin(), itr);
-        if (index == rowCount() && !m_base_column->isEqualV(m_indices[--index], data)) // index points the last possible index
+        const bool nulls_first = (getNullOrder() == NullOrder::FIRST);
+        IndexType index = m_indices.partitionPoint([this, comparator, nulls_first, &data](IndexType index)
+                                                   { return m_base_column->isNull(index) ? nulls_first : (m_base_column->*comparator)(index, data); });
+        auto is_equal = [this, &data](IndexType index)
+        { return !m_base_column->isNull(index) && m_base_column->isEqualV(index, data); };
+        if (index == rowCount() && !is_equal(m_indices[--index])) // index points the last possible index
             return {};
         IndexType start_index = index - 1, end_index = index;
-        while (start_index != INVALID_INDEX && m_base_column->isEqualV(m_indices[start_index], data))
+        while (start_index != INVALID_INDEX && is_equal(m_indices[start_index]))
             --start_index;
-        while (end_index < rowCount() && m_base_column->isEqualV(m_indices[end_index], data))
+        while (end_index < rowCount() && is_equal(m_indices[end_index]))
             ++end_index;
         for (; ++start_index != end_index;)
             result_indices.push_back(start_index);
@@ -374,14 +910,91 @@ namespace km
 
     bool Table::setData(IndexType row_index, IndexType column_index, const Variant &data)
     {
-        if (column_index == 0 || row_index >= rowCount() || column_index >= columnCount() || DataType(1U << data.index()) != m_columns[column_index]->getDataType())
+        if (isSortColumn(column_index) || row_index >= rowCount() || column_index >= columnCount() || DataType(1U << data.index()) != m_columns[column_index]->getDataType())
             return false;
         Variant old_data = m_columns[column_index]->getData(m_indices[row_index]);
+        SecondaryIndex *index = indexOf(column_index);
+        if (index)
+            index->erase(*m_columns[column_index], m_indices[row_index]);
         m_columns[column_index]->setData(data, m_indices[row_index]);
+        m_columns[column_index]->setNull(m_indices[row_index], false);
+        if (index)
+            index->insert(*m_columns[column_index], m_indices[row_index]);
+        KM_EMIT dataUpdateEvent(row_index, column_index, old_data);
+        return true;
+    }
+
+    bool Table::setNull(IndexType row_index, IndexType column_index)
+    {
+        if (isSortColumn(column_index) || row_index >= rowCount() || column_index >= columnCount())
+            return false;
+        Variant old_data = m_columns[column_index]->getData(m_indices[row_index]);
+        if (SecondaryIndex *index = indexOf(column_index))
+            index->erase(*m_columns[column_index], m_indices[row_index]);
+        m_columns[column_index]->setNull(m_indices[row_index]);
         KM_EMIT dataUpdateEvent(row_index, column_index, old_data);
         return true;
     }
 
+    bool Table::isNull(IndexType row_index, IndexType column_index) const
+    {
+        return m_columns[column_index]->isNull(m_indices[row_index]);
+    }
+
+    bool Table::getValidityMask(IndexType column_index, BitVector &mask) const
+    {
+        const AbstractColumn *column = m_columns[column_index];
+        if (!column->hasValidity())
+            return false;
+        const std::vector<IndexType> &indices = m_indices.flat();
+        const SizeType row_count = rowCount();
+        mask.resize(row_count);
+        for (IndexType row_index = 0; row_index < row_count; ++row_index)
+            mask.set(row_index, !column->isNull(indices[row_index]));
+        return true;
+    }
+
+    bool Table::getCandidateMask(IndexType column_index, CompareOp op, const Variant &data, BitVector &mask) const
+    {
+        BitVector blocks;
+        if (!m_columns[column_index]->getZoneCandidates(op, data, blocks) || blocks.count() == blocks.size())
+            return false;
+        // zone maps are kept for physical blocks, map them to rows.
+        const std::vector<IndexType> &indices = m_indices.flat();
+        const SizeType row_count = rowCount();
+        mask.clear();
+        mask.resize(row_count);
+        for (IndexType row_index = 0; row_index < row_count; ++row_index)
+        {
+            if (blocks.test(indices[row_index] >> ZoneMapBase::k_block_shift))
+                mask.set(row_index, true);
+        }
+        return true;
+    }
+
+    SizeType Table::getRadixKeys(IndexType column_index, const std::vector<IndexType> &row_indices, std::vector<uint64_t> &keys) const
+    {
+        const std::vector<IndexType> &indices = m_indices.flat();
+        std::vector<IndexType> physical_indices(row_indices.size());
+        for (IndexType k = 0, size = row_indices.size(); k < size; ++k)
+            physical_indices[k] = indices[row_indices[k]];
+        return m_columns[column_index]->getRadixKeys(physical_indices, keys);
+    }
+
+    const AbstractColumn *Table::getPhysicalColumn(IndexType column_index, const std::vector<IndexType> *&indices) const
+    {
+        indices = &m_indices.flat();
+        return m_columns[column_index];
+    }
+
+    void Table::setNullOrder(NullOrder null_order)
+    {
+        if (null_order == getNullOrder())
+            return;
+        AbstractTable::setNullOrder(null_order);
+        sort();
+    }
+
     void Table::setEpsilon(const std::string &column_name, const Variant &epsilon)
     {
         const auto found_column = findColumn(column_name);
@@ -398,11 +1011,109 @@ namespace km
 
     void Table::sort()
     {
-        std::stable_sort(m_indices.begin(), m_indices.end(), [this](IndexType index1, IndexType index2)
-                         { return (m_base_column->*m_comparator)(index1, index2); });
+        if (m_sort_keys.empty())
+            m_indices.update([this](std::vector<IndexType> &indices)
+                             {
+                                 if (!radixSortByKey(indices))
+                                     parallelStableSort(indices.begin(), indices.end(), [this](IndexType index1, IndexType index2)
+                                                        { return isKeyLess(index1, index2); }); });
+        else
+        {
+            // composite key, encode it once per row so a comparison is a single memcmp.
+            const NullOrder null_order = getNullOrder();
+            std::vector<std::string> keys(m_indices.size() + m_free_space.size());
+            auto append = [null_order](std::string &key, const AbstractColumn *column, IndexType index, SortingOrder sorting_order)
+            {
+                if (column->isNull(index))
+                    appendKeyNull(key, null_order);
+                else
+                    appendKeyValue(key, column->getData(index), sorting_order);
+            };
+            const std::vector<IndexType> &indices = m_indices.flat();
+            const SizeType row_count = indices.size();
+            const SizeType chunk_count = (row_count < k_parallel_sort_threshold) ? 1 : ThreadPool::instance().getThreadCount();
+            ThreadPool::instance().parallelFor(chunk_count, [&](IndexType chunk)
+                                               {
+                                                   for (IndexType k = row_count * chunk / chunk_count, end = row_count * (chunk + 1) / chunk_count; k < end; ++k)
+                                                   {
+                                                       const IndexType index = indices[k];
+                                                       append(keys[index], m_base_column, index, m_sorder);
+                                                       for (const auto &[column_index, sorting_order] : m_sort_keys)
+                                                           append(keys[index], m_columns[column_index], index, sorting_order);
+                                                   } });
+            m_indices.update([&keys](std::vector<IndexType> &indices)
+                             { parallelStableSort(indices.begin(), indices.end(), [&keys](IndexType index1, IndexType index2)
+                                                  { return compareKeys(keys[index1], keys[index2]) < 0; }); });
+        }
+        if (m_clustered_mode)
+            cluster();
         KM_EMIT refreshEvent();
     }
 
+    void Table::sortingPaused()
+    {
+        m_paused_row_count = rowCount();
+    }
+
+    void Table::sortPausedRows()
+    {
+        const SizeType old_row_count = m_paused_row_count;
+        if (hasMissedEvent() || old_row_count > rowCount())
+        {
+            sort();
+            return;
+        }
+        if (old_row_count == rowCount())
+            return;
+
+        std::vector<IndexType> row_indices;
+        m_indices.update([&](std::vector<IndexType> &indices)
+                         {
+                             // only the appended run is sorted, then both runs are merged. Equal keys are kept after
+                             // existing rows like insertRows().
+                             auto is_key_less = [this](IndexType index1, IndexType index2)
+                             { return isKeyLess(index1, index2); };
+                             std::vector<IndexType> run(indices.begin() + old_row_count, indices.end());
+                             if (!radixSortByKey(run))
+                                 parallelStableSort(run.begin(), run.end(), is_key_less);
+
+                             std::vector<IndexType> merged;
+                             merged.reserve(indices.size());
+                             row_indices.reserve(run.size());
+                             auto old_it = indices.begin(), old_end = indices.begin() + old_row_count;
+                             for (IndexType index : run)
+                             {
+                                 for (; old_it != old_end && !is_key_less(index, *old_it); ++old_it)
+                                     merged.push_back(*old_it);
+                                 if (!merged.empty() && merged.back() > index)
+                                     ++m_unclustered_count;
+                                 row_indices.push_back(merged.size());
+                                 merged.push_back(index);
+                             }
+                             merged.insert(merged.end(), old_it, old_end);
+                             indices = std::move(merged); });
+        KM_EMIT rowsInsertionEvent(row_indices);
+        if (m_clustered_mode) // like sort()
+            cluster();
+    }
+
+    bool Table::radixSortByKey(std::vector<IndexType> &indices) const
+    {
+        if (!m_sort_keys.empty() || indices.size() < k_radix_sort_threshold)
+            return false;
+        std::vector<uint64_t> keys;
+        const SizeType key_bytes = m_base_column->getRadixKeys(indices, keys);
+        if (key_bytes == 0)
+            return false;
+        const bool descending = (m_sorder == SortingOrder::DESCENDING);
+        if (m_base_column->hasValidity())
+            radixSort(indices, keys, key_bytes, descending, getNullOrder() == NullOrder::FIRST, [this](IndexType index)
+                      { return m_base_column->isNull(index); });
+        else
+            radixSort(indices, keys, key_bytes, descending);
+        return true;
+    }
+
     void Table::setDisplayName(const std::string &display_name, IndexType column_index)
     {
         m_columns[column_index]->setDisplayName(display_name);
@@ -418,28 +1129,342 @@ namespace km
         m_columns[column_index]->setData(data, m_indices[row_index]);
     }
 
+    void Table::getBooleanMask(IndexType column_index, BitVector &mask) const
+    {
+        const BitVector &bits = static_cast<const Column<KBoolean> *>(m_columns[column_index])->getBits();
+        const std::vector<IndexType> &indices = m_indices.flat();
+        const SizeType row_count = rowCount();
+        mask.resize(row_count);
+        for (IndexType row_index = 0; row_index < row_count; ++row_index)
+            mask.set(row_index, bits.test(indices[row_index]));
+    }
+
+    void Table::cluster()
+    {
+        if (m_free_space.empty())
+        {
+            const std::vector<IndexType> &indices = m_indices.flat();
+            bool is_identity = true;
+            for (IndexType i = 0, size = indices.size(); i < size && is_identity; ++i)
+                is_identity = (indices[i] == i);
+            if (is_identity) // already clustered
+            {
+                m_unclustered_count = 0;
+                return;
+            }
+        }
+        freeSpace();
+    }
+
+    bool Table::setSortKeys(const std::vector<SortKey> &keys)
+    {
+        std::vector<std::pair<IndexType, SortingOrder>> sort_keys;
+        for (const SortKey &key : keys)
+        {
+            const auto found_column = findColumn(key.column_name);
+            if (!found_column || found_column.value().first == 0)
+            {
+                err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ InvalidArgs") << "Column `" << key.column_name
+                                                                                  << "` passed as sort key doesn't exist or is the key column.");
+                return false;
+            }
+            const IndexType column_index = found_column.value().first;
+            if (std::any_of(sort_keys.begin(), sort_keys.end(), [column_index](const auto &sort_key)
+                            { return sort_key.first == column_index; }))
+            {
+                err::addLogMsg(err::LogMsg(getDecoratedName() + " ~ InvalidArgs") << "Column `" << key.column_name << "` is repeated in sort keys.");
+                return false;
+            }
+            sort_keys.emplace_back(column_index, key.sorting_order);
+        }
+        m_sort_keys = std::move(sort_keys);
+        sort();
+        return true;
+    }
+
+    std::vector<SortKey> Table::getSortKeys() const
+    {
+        std::vector<SortKey> keys;
+        for (const auto &[column_index, sorting_order] : m_sort_keys)
+            keys.push_back({m_columns[column_index]->getName(), sorting_order});
+        return keys;
+    }
+
+    bool Table::isTieLess(IndexType index1, IndexType index2) const
+    {
+        const bool nulls_first = (getNullOrder() == NullOrder::FIRST);
+        for (const auto &[column_index, sorting_order] : m_sort_keys)
+        {
+            const AbstractColumn *column = m_columns[column_index];
+            const bool null1 = column->isNull(index1), null2 = column->isNull(index2);
+            if (null1 != null2)
+                return null1 == nulls_first;
+            if (null1)
+                continue;
+            if (column->isLess(index1, index2))
+                return sorting_order == SortingOrder::ASCENDING;
+            if (column->isLess(index2, index1))
+                return sorting_order == SortingOrder::DESCENDING;
+        }
+        return false;
+    }
+
+    bool Table::isSortColumn(IndexType column_index) const noexcept
+    {
+        return column_index == 0 || std::any_of(m_sort_keys.begin(), m_sort_keys.end(), [column_index](const auto &sort_key)
+                                                { return sort_key.first == column_index; });
+    }
+
+    void Table::setRowIndexKind(RowIndexKind kind)
+    {
+        m_indices.setKind(kind);
+    }
+
+    void Table::setClusteredMode(bool clustered, SizeType threshold)
+    {
+        m_clustered_mode = clustered;
+        m_cluster_threshold = threshold;
+        if (m_clustered_mode)
+            cluster();
+    }
+
     void Table::freeSpace()
     {
         SizeType row_count = rowCount();
         SizeType column_count = columnCount();
+        const std::vector<IndexType> &indices = m_indices.flat();
 
         for (IndexType column_index = 0; column_index < column_count; ++column_index)
         {
-            AbstractColumnPtr_ column_ptr = m_columns[column_index];
-            // create clone of type (it doesn't hold any data, it holds only column name)
-            AbstractColumnPtr_ tmp_column = column_ptr->getSameTypeColumn(column_ptr->getName());
-            tmp_column->reserve(row_count);
-            for (IndexType i = 0; i < row_count; ++i)
-            {
-                tmp_column->pushData(column_ptr->getData(m_indices[i]));
-            }
+            // copy of the column with non deleted rows only, it also compacts the column's own storage
+            // like unused strings of dictionary or unused bytes of arena.
+            AbstractColumnPtr_ tmp_column = m_columns[column_index]->getCompactedColumn(indices);
+            tmp_column->copyNulls(*m_columns[column_index], indices);
             delete m_columns[column_index];
             m_columns[column_index] = tmp_column;
         }
         m_base_column = m_columns.front();
-        for (IndexType i = 0; i < row_count; ++i)
-            m_indices[i] = i;
+        std::vector<IndexType> identity(row_count);
+        std::iota(identity.begin(), identity.end(), 0);
+        m_indices.assign(std::move(identity));
         m_free_space.clear();
+        m_unclustered_count = 0;
+        rebuildIndexes(); // physical indices are changed
+    }
+
+    void Table::rebuildIndexes()
+    {
+        const std::vector<IndexType> &indices = m_indices.flat();
+        for (IndexType column_index = 0, size = m_secondary_indices.size(); column_index < size; ++column_index)
+        {
+            if (m_secondary_indices[column_index])
+                m_secondary_indices[column_index]->rebuild(*m_columns[column_index], indices);
+        }
+    }
+
+    void Table::indexRow(IndexType index)
+    {
+        for (IndexType column_index = 0, size = m_secondary_indices.size(); column_index < size; ++column_index)
+        {
+            if (m_secondary_indices[column_index])
+                m_secondary_indices[column_index]->insert(*m_columns[column_index], index);
+        }
+    }
+
+    void Table::unindexRow(IndexType index)
+    {
+        for (IndexType column_index = 0, size = m_secondary_indices.size(); column_index < size; ++column_index)
+        {
+            if (m_secondary_indices[column_index])
+                m_secondary_indices[column_index]->erase(*m_columns[column_index], index);
+        }
+    }
+
+    std::vector<IndexType> Table::rowsOf(const std::vector<IndexType> &indices) const
+    {
+        std::vector<IndexType> row_indices;
+        findRows(indices, row_indices);
+        std::sort(row_indices.begin(), row_indices.end());
+        return row_indices;
+    }
+
+    void Table::findRows(const std::vector<IndexType> &indices, std::vector<IndexType> &row_indices) const
+    {
+        row_indices.resize(indices.size());
+        const SizeType row_count = rowCount();
+        if (!m_indices.hasPositions() && !isSortingPaused() && indices.size() * 64 < row_count)
+        {
+            // rows with equal key are adjacent, a few indices are searched among the rows having their keys, unless
+            // that is a large part of the table.
+            std::vector<std::pair<IndexType, IndexType>> runs;
+            runs.reserve(indices.size());
+            SizeType run_rows = 0;
+            for (IndexType index : indices)
+            {
+                const IndexType first = m_indices.partitionPoint([this, index](IndexType mid)
+                                                                 { return isKeyLess(mid, index); });
+                const IndexType last = m_indices.partitionPoint([this, index](IndexType mid)
+                                                                { return !isKeyLess(index, mid); });
+                runs.emplace_back(first, last);
+                run_rows += last - first;
+            }
+            if (run_rows * 8 < row_count)
+            {
+                for (IndexType k = 0, size = indices.size(); k < size; ++k)
+                {
+                    IndexType row_index = runs[k].first;
+                    while (m_indices[row_index] != indices[k])
+                        ++row_index;
+                    row_indices[k] = row_index;
+                }
+                return;
+            }
+        }
+        // positions of all the rows are found in one pass and kept until the order of rows changes.
+        for (IndexType k = 0, size = indices.size(); k < size; ++k)
+            row_indices[k] = m_indices.positionOf(indices[k]);
+    }
+
+    void Table::setCompactionMode(CompactionMode mode, SizeType slice_size)
+    {
+        m_compaction_mode = mode;
+        m_compaction_slice = std::max<SizeType>(slice_size, 1);
+        m_compacting = false;
+        reclaimSpace();
+    }
+
+    void Table::reclaimSpace()
+    {
+        switch (m_compaction_mode)
+        {
+        case CompactionMode::IMMEDIATE:
+            if (m_mfst <= m_free_space.size())
+                freeSpace();
+            break;
+        case CompactionMode::INCREMENTAL:
+            if (m_mfst <= m_free_space.size())
+                m_compacting = true;
+            if (m_compacting && compact(m_compaction_slice))
+                m_compacting = false;
+            break;
+        case CompactionMode::DEFERRED:
+            break;
+        }
+    }
+
+    bool Table::compact(SizeType max_rows)
+    {
+        if (m_free_space.empty())
+            return true;
+        // largest first, free indices at the end of the columns are removed from the front and the last rows are
+        // moved into the smallest ones at the back.
+        std::sort(m_free_space.begin(), m_free_space.end(), std::greater<IndexType>());
+        IndexType tail_end = 0, hole_end = m_free_space.size();
+        SizeType size = m_indices.size() + m_free_space.size();
+        SizeType step_count = 0;
+        std::vector<IndexType> lasts, holes; // data at lasts[k] is moved to holes[k]
+        for (; step_count < max_rows && tail_end < hole_end; ++step_count, --size)
+        {
+            const IndexType last = size - 1;
+            if (m_free_space[tail_end] == last)
+                ++tail_end;
+            else
+            {
+                lasts.push_back(last);
+                holes.push_back(m_free_space[--hole_end]);
+            }
+        }
+        // holes are below all the moved data, so moving doesn't overwrite data which is moved later.
+        std::vector<IndexType> row_indices;
+        findRows(lasts, row_indices);
+        for (IndexType k = 0, moved_count = lasts.size(); k < moved_count; ++k)
+        {
+            unindexRow(lasts[k]);
+            for (AbstractColumnPtr_ column : m_columns)
+            {
+                column->moveData(lasts[k], holes[k]);
+                if (column->hasValidity())
+                    column->setNull(holes[k], column->isNull(lasts[k]));
+            }
+            m_indices.set(row_indices[k], holes[k]);
+            indexRow(holes[k]);
+        }
+        for (AbstractColumnPtr_ column : m_columns)
+        {
+            for (SizeType step = 0; step < step_count; ++step)
+                column->popData();
+        }
+        m_free_space.erase(m_free_space.begin() + hole_end, m_free_space.end());
+        m_free_space.erase(m_free_space.begin(), m_free_space.begin() + tail_end);
+
+        m_unclustered_count += lasts.size();
+        if (m_clustered_mode && m_cluster_threshold && m_unclustered_count >= m_cluster_threshold)
+            cluster();
+        return m_free_space.empty();
+    }
+
+    FragmentationStats Table::getFragmentationStats() const
+    {
+        FragmentationStats stats{rowCount(), m_free_space.size(), 0, 0.0};
+        for (const AbstractColumnPtr_ column : m_columns)
+        {
+            if (const ArenaStringColumn *arena_column = dynamic_cast<const ArenaStringColumn *>(column))
+                stats.unused_bytes += arena_column->getUnusedSize();
+        }
+        if (const SizeType total = stats.row_count + stats.free_row_count)
+            stats.fragmentation = double(stats.free_row_count) / total;
+        return stats;
+    }
+
+    void Table::evaluateColumn(IndexType column_index, const std::vector<parse::Token> &tokens)
+    {
+        const SizeType row_count = rowCount();
+        if (!row_count)
+            return;
+        ThreadPool &pool = ThreadPool::instance();
+        AbstractColumn *column = m_columns[column_index];
+        if (row_count < k_parallel_evaluation_threshold || pool.getThreadCount() < 2 || !column->beginConcurrentWrites())
+        {
+            parse::evaluateFormula(tokens, this, column_index, 0, row_count - 1);
+            return;
+        }
+        m_indices.flat(); // builds the flat indices of a tree once, compiled formulas of the ranges read it
+        // a few ranges per thread balance the load when some rows are costlier (e.g. long strings).
+        const SizeType chunk_count = std::min(pool.getThreadCount() * 4, row_count / (k_parallel_evaluation_threshold / 4));
+        try
+        {
+            pool.parallelFor(chunk_count, [&](IndexType chunk)
+                             { parse::evaluateFormula(tokens, this, column_index, row_count * chunk / chunk_count, row_count * (chunk + 1) / chunk_count - 1); });
+        }
+        catch (...)
+        {
+            column->endConcurrentWrites();
+            throw;
+        }
+        column->endConcurrentWrites();
+    }
+
+    void Table::propagateNulls(IndexType column_index, const std::vector<parse::Token> &tokens)
+    {
+        // builtin functions return null if any argument is null, so result is null wherever any referred
+        // column is null. Validity of all columns share the physical indices so they are ANDed word by word.
+        const SizeType size = m_indices.size() + m_free_space.size();
+        BitVector validity;
+        for (const parse::Token &token : tokens)
+        {
+            if (!(token.token_type & parse::COLUMN))
+                continue;
+            const AbstractColumn *column = m_columns[token.element.asColInfo().index];
+            if (!column->hasValidity())
+                continue;
+            BitVector column_validity = column->getValidity();
+            column_validity.resize(size, true);
+            if (validity.empty())
+                validity = std::move(column_validity);
+            else
+                validity &= column_validity;
+        }
+        m_columns[column_index]->setValidity(std::move(validity));
     }
 
     bool Table::validateForNewColumn(const std::string &column, DataType data_type)
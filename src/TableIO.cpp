@@ -29,6 +29,18 @@ namespace km
             return file_name;
         }
 
+        // writes validity of column after its data as [word count][words], bit i is 0 if row i is null.
+        // nothing is written if column doesn't have any null.
+        void writeValidity(const Table *table, IndexType column_index, std::ofstream &c_ofs)
+        {
+            BitVector validity;
+            if (!table->getValidityMask(column_index, validity))
+                return;
+            const SizeType word_count = validity.words().size();
+            c_ofs.write(MAKE_W(&word_count), sizeof(SizeType));
+            c_ofs.write(MAKE_W(validity.words().data()), word_count * sizeof(BitVector::WordType));
+        }
+
         // writes table to path/column_name.clm
 
         template <typename Type_>
@@ -40,11 +52,24 @@ namespace km
             c_ofs.open(column_file_name, std::ios_base::out | std::ios_base::binary);
             if (!c_ofs.is_open())
                 return false;
-            for (IndexType row_index = 0, row_count = table->rowCount(); row_index < row_count; ++row_index)
+            if (table->getColumnMetaData(column_index).storage == ColumnStorage::DEFAULT)
             {
-                Variant data = table->getDataWC(row_index, column_index);
-                c_ofs.write(MAKE_W(&data.as<Type_>()), sizeof(Type_));
+                const ColumnHandle<Type_> column = table->columnAs<Type_>(column_name);
+                for (IndexType row_index = 0, row_count = table->rowCount(); row_index < row_count; ++row_index)
+                {
+                    const Type_ data = column[row_index];
+                    c_ofs.write(MAKE_W(&data), sizeof(Type_));
+                }
             }
+            else
+            {
+                for (IndexType row_index = 0, row_count = table->rowCount(); row_index < row_count; ++row_index)
+                {
+                    const Type_ data = table->getDataWC(row_index, column_index).as<Type_>();
+                    c_ofs.write(MAKE_W(&data), sizeof(Type_));
+                }
+            }
+            writeValidity(table, column_index, c_ofs);
             c_ofs.close();
             return true;
         }
@@ -59,12 +84,26 @@ namespace km
             c_ofs.open(column_file_name, std::ios_base::out | std::ios_base::binary);
             if (!c_ofs.is_open())
                 return false;
-            for (IndexType row_index = 0, row_count = table->rowCount(); row_index < row_count; ++row_index)
+            if (table->getColumnMetaData(column_index).storage == ColumnStorage::DEFAULT)
+            {
+                const ColumnHandle<KString> column = table->columnAs<KString>(column_name);
+                for (IndexType row_index = 0, row_count = table->rowCount(); row_index < row_count; ++row_index)
+                {
+                    const std::string_view str = column[row_index];
+                    c_ofs.write(str.data(), str.length());
+                    c_ofs.put('\0');
+                }
+            }
+            else
             {
-                Variant data = table->getDataWC(row_index, column_index);
-                const KString &str = data.asString();
-                c_ofs.write(str.c_str(), str.length() + 1);
+                for (IndexType row_index = 0, row_count = table->rowCount(); row_index < row_count; ++row_index)
+                {
+                    Variant data = table->getDataWC(row_index, column_index);
+                    const KString &str = data.asString();
+                    c_ofs.write(str.c_str(), str.length() + 1);
+                }
             }
+            writeValidity(table, column_index, c_ofs);
             c_ofs.close();
             return true;
         }
@@ -103,7 +142,7 @@ namespace km
             // writes below information column times
             for (SizeType column_index = 0; column_index < column_count; ++column_index)
             {
-                const auto [column_name, display_name, column_type] = table->getColumnMetaData(column_index);
+                const auto &[column_name, display_name, column_type, storage] = table->getColumnMetaData(column_index);
                 IndexType cn_length = column_name.length(), dn_length = display_name.length();
                 ofs.write(MAKE_W(&column_type), sizeof(DataType)); // data type
                 ofs.write(MAKE_W(&cn_length), sizeof(IndexType));  // length of the column name
@@ -111,6 +150,14 @@ namespace km
                 ofs.write(MAKE_W(&dn_length), sizeof(IndexType));  // length of the column name
                 ofs.write(display_name.c_str(), dn_length);        // column name
             }
+            // storages are written after all the columns, so files written without them are still read (as DEFAULT).
+            for (SizeType column_index = 0; column_index < column_count; ++column_index)
+            {
+                const ColumnStorage storage = table->getColumnMetaData(column_index).storage;
+                ofs.write(MAKE_W(&storage), sizeof(ColumnStorage)); // storage
+            }
+            const NullOrder null_order = table->getNullOrder();
+            ofs.write(MAKE_W(&null_order), sizeof(NullOrder)); // null order
         }
 
         template <class T>
@@ -147,6 +194,23 @@ namespace km
             return ifs;
         }
 
+        // reads validity written by writeValidity(), @a validity is left empty if column doesn't have any null.
+        bool readValidity(std::ifstream &ifs, SizeType row_count, BitVector &validity)
+        {
+            SizeType word_count = 0;
+            if (!ifs.read(MAKE_R(&word_count), sizeof(SizeType)))
+                return true; // optional, no nulls
+            validity.resize(row_count);
+            if (word_count != validity.words().size())
+                return false;
+            std::vector<BitVector::WordType> words(word_count);
+            if (!ifs.read(MAKE_R(words.data()), word_count * sizeof(BitVector::WordType)))
+                return false;
+            for (IndexType row_index = 0; row_index < row_count; ++row_index)
+                validity.set(row_index, (words[row_index / BitVector::k_word_bits] >> (row_index % BitVector::k_word_bits)) & 1U);
+            return true;
+        }
+
         using StreamDataReader_ = Variant (*)(IndexType, std::ifstream &);
 
         inline StreamDataReader_ getStreamReader(DataType data_type)
@@ -170,7 +234,6 @@ namespace km
             {
                 const auto &column_name = column_vec[c_index].column_name;
                 const auto &column_type = column_vec[c_index].data_type;
-                const auto &display_name = column_vec[c_index].display_name;
 
                 std::ifstream ifs;
                 const std::string file_name = resolveFileName(column_name, path, "clm");
@@ -182,16 +245,42 @@ namespace km
                     return false;
                 }
                 StreamDataReader_ dataReader = getStreamReader(column_type);
+                BitVector validity;
                 if (c_index == 0) // first column is already added, and needs to be inserted manually
                 {
+                    // nulls of the first column are needed while inserting, so data is read before validity.
+                    std::vector<Variant> keys;
+                    keys.reserve(row_count);
+                    for (IndexType r_index = 0; r_index < row_count; ++r_index)
+                        keys.push_back(dataReader(0, ifs));
+                    if (!readValidity(ifs, row_count, validity))
+                    {
+                        err::addLogMsg(err::LogMsg("ReadTableFromFile ~ IO") << "Invalid nulls in the file `" << file_name << "` of column `"
+                                                                             << column_name << "`.");
+                        return false;
+                    }
                     table->pauseSorting();
                     for (IndexType r_index = 0; r_index < row_count; ++r_index)
-                        table->insertRow({dataReader(0, ifs)});
+                    {
+                        if (!validity.empty() && !validity[r_index])
+                            table->insertRowN({std::nullopt});
+                        else
+                            table->insertRow({std::move(keys[r_index])});
+                    }
                     table->resumeSorting();
                 }
                 else
                 {
-                    table->addColumnF<StreamDataReader_, std::ifstream &>({column_name, display_name, column_type}, dataReader, ifs);
+                    table->addColumnF<StreamDataReader_, std::ifstream &>(column_vec[c_index], dataReader, ifs);
+                    if (!readValidity(ifs, row_count, validity))
+                    {
+                        err::addLogMsg(err::LogMsg("ReadTableFromFile ~ IO") << "Invalid nulls in the file `" << file_name << "` of column `"
+                                                                             << column_name << "`.");
+                        return false;
+                    }
+                    if (!validity.empty())
+                        validity.flip().forEachSetBit([table, c_index](IndexType r_index)
+                                                      { table->setNull(r_index, c_index); });
                 }
                 ifs.close();
             }
@@ -267,19 +356,39 @@ namespace km
             }
             column_vec.push_back({column_name, display_name, column_type});
         }
+        // optional, older files don't have storages.
+        for (ColumnMetaData &column : column_vec)
+        {
+            ColumnStorage storage = ColumnStorage::DEFAULT;
+            if (!ifs.read(MAKE_R(&storage), sizeof(ColumnStorage)))
+                break;
+            if (storage > ColumnStorage::CHUNKED)
+            {
+                err::addLogMsg(err::LogMsg("ReadTableFrom ~ IO") << "Reading failed `" << file_name << "`, invalid storage of column `"
+                                                                 << column.column_name << "`.");
+                return nullptr;
+            }
+            column.storage = storage;
+        }
+        NullOrder null_order = NullOrder::FIRST; // optional, like storages.
+        if (!ifs.read(MAKE_R(&null_order), sizeof(NullOrder)) || null_order > NullOrder::LAST)
+            null_order = NullOrder::FIRST;
 
         try
         {
             err::LockLogFileHandler lock;
             (void)lock;
-            if (!column_count) // no columns, empty table
-                return new Table(table_name, {}, s_order);
-            if (!row_count) // no rows but columns exist
-                return new Table(table_name, column_vec, s_order);
+            if (!column_count || !row_count) // empty table, with or without columns
+            {
+                Table *table = new Table(table_name, column_vec, s_order);
+                table->setNullOrder(null_order);
+                return table;
+            }
 
             // else have both columns and rows
             // create table with single column.
             Table *table = new Table(table_name, {column_vec.front()}, s_order);
+            table->setNullOrder(null_order);
             if (!insertData(table, row_count, column_vec, path))
             {
                 delete table;
@@ -306,5 +415,12 @@ namespace km
         columnType
         columnName.length
         columnName.data
+        displayName.length
+        displayName.data
+    storage (columnCount times, optional)
+    nullOrder (optional)
     data_vec
+        data (rowCount times)
+        validity.wordCount (optional, only if column has a null)
+        validity.words
   **/
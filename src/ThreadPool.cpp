@@ -0,0 +1,149 @@
+#include "ThreadPool.hpp"
+
+namespace km
+{
+    namespace
+    {
+        // true on the workers and while the calling thread runs tasks, so nested jobs run inline.
+        thread_local bool in_task_ = false;
+    } // namespace
+
+    ThreadPool &ThreadPool::instance()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    ThreadPool::ThreadPool()
+        : m_job(nullptr),
+          m_job_size(0),
+          m_next_task(0),
+          m_pending_tasks(0),
+          m_thread_count(std::max(1U, std::thread::hardware_concurrency())),
+          m_stop(false)
+    {
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        stop();
+    }
+
+    void ThreadPool::setThreadCount(SizeType thread_count)
+    {
+        if (thread_count == 0)
+            thread_count = std::max(1U, std::thread::hardware_concurrency());
+        std::lock_guard<std::mutex> job_lock(m_job_mutex);
+        if (thread_count == m_thread_count)
+            return;
+        stop();
+        m_thread_count = thread_count;
+    }
+
+    SizeType ThreadPool::getThreadCount() const noexcept
+    {
+        return m_thread_count;
+    }
+
+    void ThreadPool::parallelFor(SizeType count, const std::function<void(IndexType)> &fnc)
+    {
+        if (count == 0)
+            return;
+        if (count == 1 || m_thread_count < 2 || in_task_)
+        {
+            for (IndexType i = 0; i < count; ++i)
+                fnc(i);
+            return;
+        }
+
+        std::lock_guard<std::mutex> job_lock(m_job_mutex); // one job at a time
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_workers.empty())
+            start();
+        m_job = &fnc;
+        m_job_size = count;
+        m_next_task = 0;
+        m_pending_tasks = count;
+        m_exception = nullptr;
+        m_job_cv.notify_all();
+
+        // the calling thread works too.
+        in_task_ = true;
+        while (m_next_task < m_job_size)
+        {
+            const IndexType task = m_next_task++;
+            lock.unlock();
+            std::exception_ptr exception;
+            try
+            {
+                fnc(task);
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+            lock.lock();
+            if (exception && !m_exception)
+                m_exception = exception;
+            --m_pending_tasks;
+        }
+        in_task_ = false;
+        m_done_cv.wait(lock, [this]
+                       { return m_pending_tasks == 0; });
+        m_job = nullptr;
+        if (m_exception)
+            std::rethrow_exception(m_exception);
+    }
+
+    void ThreadPool::start()
+    {
+        m_stop = false;
+        for (SizeType i = 1; i < m_thread_count; ++i)
+            m_workers.emplace_back(&ThreadPool::work, this);
+    }
+
+    void ThreadPool::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_job_cv.notify_all();
+        for (std::thread &worker : m_workers)
+            worker.join();
+        m_workers.clear();
+    }
+
+    void ThreadPool::work()
+    {
+        in_task_ = true;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_job_cv.wait(lock, [this]
+                          { return m_stop || (m_job && m_next_task < m_job_size); });
+            if (m_stop)
+                return;
+            while (m_job && m_next_task < m_job_size)
+            {
+                const IndexType task = m_next_task++;
+                const std::function<void(IndexType)> &job = *m_job;
+                lock.unlock();
+                std::exception_ptr exception;
+                try
+                {
+                    job(task);
+                }
+                catch (...)
+                {
+                    exception = std::current_exception();
+                }
+                lock.lock();
+                if (exception && !m_exception)
+                    m_exception = exception;
+                if (--m_pending_tasks == 0)
+                    m_done_cv.notify_all();
+            }
+        }
+    }
+} // namespace km
@@ -0,0 +1,36 @@
+#ifndef KMTABLE_SRC_TOKENTYPE_H
+#define KMTABLE_SRC_TOKENTYPE_H
+
+#include <cstdint>
+
+namespace km
+{
+    namespace parse
+    {
+        /**
+         * @brief Type of a Token, stored in Token::token_type . Data types and COLUMN can be combined as masks.
+         */
+        enum TType : uint16_t
+        {
+            INT32 = 0x0001,
+            INT64 = 0x0002,
+            FLOAT32 = 0x0004,
+            FLOAT64 = 0x0008,
+            STRING = 0x0010,
+            BOOLEAN = 0x0020,
+
+            COLUMN = 0x0040,
+            FUNCTION = 0x080,
+
+            COMMA = 0x0100,
+            P_OPEN = 0x0200,
+            P_CLOSE = 0x0400,
+            INVALID = 0x0800,
+        };
+
+        constexpr uint16_t TT_DATA = (INT32 | INT64 | FLOAT32 | FLOAT64 | STRING | BOOLEAN);
+        constexpr uint16_t TT_DATAC = (TT_DATA | COLUMN);
+    }
+}
+
+#endif // KMTABLE_SRC_TOKENTYPE_H
@@ -1,6 +1,7 @@
 #include <cmath>
 #include "Core.hpp"
 #include "FunctionStore.hpp"
+#include "NativeOps.h"
 
 namespace km
 {
@@ -189,5 +190,15 @@ namespace km
                 {"isInRange_ddd", {inRange_<KDate>, dt::BOOLEAN, 3}},
                 {"isInRange_DDD", {inRange_<KDateTime>, dt::BOOLEAN, 3}},
             });
+
+        // compiled formulas do these on unboxed numbers.
+        setNativeOp({add_<KInt32>, add_<KInt64>, add_<KFloat32>, add_<KFloat64>}, NativeOp::ADD);
+        setNativeOp({subtract_<KInt32>, subtract_<KInt64>, subtract_<KFloat32>, subtract_<KFloat64>}, NativeOp::SUBTRACT);
+        setNativeOp({multiply_<KInt32>, multiply_<KInt64>, multiply_<KFloat32>, multiply_<KFloat64>}, NativeOp::MULTIPLY);
+        setNativeOp({divide_<KInt32, KFloat32>, divide_<KInt64, KFloat64>, divide_<KFloat32>, divide_<KFloat64>,
+                     divide_<KInt32>, divide_<KInt64>},
+                    NativeOp::DIVIDE);
+        setNativeOp({modulous_ii, modulous_II, modulous_ff, modulous_FF}, NativeOp::MODULO);
+        setNativeOp({inRange_<KInt32>, inRange_<KInt64>, inRange_<KFloat32>, inRange_<KFloat64>}, NativeOp::IN_RANGE);
     }
 }
@@ -1,5 +1,6 @@
 #include "Core.hpp"
 #include "FunctionStore.hpp"
+#include "NativeOps.h"
 
 namespace km
 {
@@ -87,6 +88,14 @@ namespace km
              {"isGreater_DD", {isGreater_<KDateTime>, dt::BOOLEAN, 2}},
              {"isLessOrEqual_DD", {isLessOrEqual_<KDateTime>, dt::BOOLEAN, 2}},
              {"isGreaterOrEqual_DD", {isGreaterOrEqual_<KDateTime>, dt::BOOLEAN, 2}}});
+
+        // compiled formulas compare unboxed numbers.
+        setNativeOp({isLess_<KInt32>, isLess_<KInt64>, isLess_<KFloat32>, isLess_<KFloat64>}, NativeOp::LESS);
+        setNativeOp({isGreater_<KInt32>, isGreater_<KInt64>, isGreater_<KFloat32>, isGreater_<KFloat64>}, NativeOp::GREATER);
+        setNativeOp({isEqual_<KInt32>, isEqual_<KInt64>, isEqual_<KFloat32>, isEqual_<KFloat64>}, NativeOp::EQUAL);
+        setNativeOp({isLessOrEqual_<KInt32>, isLessOrEqual_<KInt64>, isLessOrEqual_<KFloat32>, isLessOrEqual_<KFloat64>}, NativeOp::LESS_OR_EQUAL);
+        setNativeOp({isGreaterOrEqual_<KInt32>, isGreaterOrEqual_<KInt64>, isGreaterOrEqual_<KFloat32>, isGreaterOrEqual_<KFloat64>},
+                    NativeOp::GREATER_OR_EQUAL);
     }
 
 } // namespace km
@@ -1,5 +1,6 @@
 #include "Core.hpp"
 #include "FunctionStore.hpp"
+#include "NativeOps.h"
 
 namespace km
 {
@@ -54,5 +55,11 @@ namespace km
              {"IF_bbb", {IF_, dt::BOOLEAN, 3}},
              {"IF_bdd", {IF_, dt::DATE, 3}},
              {"IF_bDD", {IF_, dt::DATE_TIME, 3}}});
+
+        setNativeOp({AND_bb}, NativeOp::AND);
+        setNativeOp({OR_bb}, NativeOp::OR);
+        setNativeOp({NOT_b}, NativeOp::NOT);
+        setNativeOp({XOR_bb}, NativeOp::XOR);
+        setNativeOp({IF_}, NativeOp::IF); // only IF of numbers and booleans is compiled
     }
 }
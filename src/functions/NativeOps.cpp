@@ -0,0 +1,28 @@
+#include <map>
+
+#include "NativeOps.h"
+
+namespace km
+{
+    namespace fnc
+    {
+        // functions are registered once by initAllFnc(), before any formula is compiled.
+        static std::map<FunctionPtr, NativeOp> &nativeOps()
+        {
+            static std::map<FunctionPtr, NativeOp> native_ops;
+            return native_ops;
+        }
+
+        void setNativeOp(std::initializer_list<FunctionPtr> functions, NativeOp op)
+        {
+            for (FunctionPtr function : functions)
+                nativeOps()[function] = op;
+        }
+
+        NativeOp nativeOpOf(FunctionPtr function)
+        {
+            const auto it = nativeOps().find(function);
+            return it == nativeOps().end() ? NativeOp::NONE : it->second;
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef KMTABLE_SRC_FUNCTIONS_NATIVEOPS_H
+#define KMTABLE_SRC_FUNCTIONS_NATIVEOPS_H
+
+#include <initializer_list>
+
+#include "Core.hpp"
+
+namespace km
+{
+    namespace fnc
+    {
+        /**
+         * @brief Operation of a built in function which compiled formulas run on unboxed values.
+         *
+         * Types of the operands are the types of the arguments and the result is converted to the return type of the
+         * function, e.g. DIVIDE of two KInt32 returning KFloat32 divides them as KFloat32. Integer division by zero
+         * gives 0, like divide_().
+         */
+        enum class NativeOp : uint8_t
+        {
+            NONE,
+            ADD,
+            SUBTRACT,
+            MULTIPLY,
+            DIVIDE,
+            MODULO,
+            LESS,
+            GREATER,
+            EQUAL,
+            LESS_OR_EQUAL,
+            GREATER_OR_EQUAL,
+            IN_RANGE,
+            AND,
+            OR,
+            NOT,
+            XOR,
+            IF,
+            CAST
+        };
+
+        using FunctionPtr = Variant (*)(const Variant *);
+
+        /**
+         * @brief Marks that each of @a functions does @a op , it is called while registering the built in functions.
+         */
+        void setNativeOp(std::initializer_list<FunctionPtr> functions, NativeOp op);
+
+        /**
+         * @brief Returns the operation of @a function , NativeOp::NONE if it must be called.
+         */
+        NativeOp nativeOpOf(FunctionPtr function);
+    }
+}
+
+#endif // KMTABLE_SRC_FUNCTIONS_NATIVEOPS_H
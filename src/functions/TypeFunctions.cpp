@@ -1,5 +1,6 @@
 #include "Core.hpp"
 #include "FunctionStore.hpp"
+#include "NativeOps.h"
 
 #include <string>
 
@@ -214,5 +215,14 @@ namespace km
                 {"toDateTime_diii", {ToDateTime_1d3i, dt::DATE_TIME, 4}},
 
             });
+
+        // compiled formulas convert unboxed numbers with static_cast.
+        setNativeOp({ArithmeticConverter<KInt32, KInt64>, ArithmeticConverter<KInt32, KFloat32>, ArithmeticConverter<KInt32, KFloat64>,
+                     ArithmeticConverter<KInt64, KInt32>, ArithmeticConverter<KInt64, KFloat32>, ArithmeticConverter<KInt64, KFloat64>,
+                     ArithmeticConverter<KFloat32, KInt32>, ArithmeticConverter<KFloat32, KInt64>, ArithmeticConverter<KFloat32, KFloat64>,
+                     ArithmeticConverter<KFloat64, KInt32>, ArithmeticConverter<KFloat64, KInt64>, ArithmeticConverter<KFloat64, KFloat32>,
+                     booleanConverter<KInt32, KBoolean>, booleanConverter<KInt64, KBoolean>,
+                     booleanConverter<KBoolean, KInt32>, booleanConverter<KBoolean, KInt64>},
+                    NativeOp::CAST);
     }
 }
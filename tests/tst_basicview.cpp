@@ -339,3 +339,152 @@ TEST(BasicView,DanglingView)
     EXPECT_EQ(view.rowCount(),0);
     EXPECT_EQ(view.columnCount(),0);
 }
+
+TEST(BasicView, NullOrder)
+{
+    km::Table table("scores", {{"id", dt::INT32}, {"score", dt::INT32}});
+    table.insertRowN({1, 30});
+    table.insertRowN({2, std::nullopt});
+    table.insertRowN({3, 10});
+    table.insertRowN({4, std::nullopt});
+
+    km::BasicView view("view", &table, {"id", "score"}, "", "score");
+    ASSERT_EQ(view.rowCount(), 4);
+    EXPECT_TRUE(view.isNull(0, 1));
+    EXPECT_TRUE(view.isNull(1, 1));
+    EXPECT_EQ(view.getDataWC(2, 0).asInt32(), 3);
+    EXPECT_EQ(view.getDataWC(3, 0).asInt32(), 1);
+
+    // nulls stay first in descending order too.
+    view.sortBy(km::SortingOrder::DESCENDING);
+    EXPECT_TRUE(view.isNull(0, 1));
+    EXPECT_TRUE(view.isNull(1, 1));
+    EXPECT_EQ(view.getDataWC(2, 0).asInt32(), 1);
+    EXPECT_EQ(view.getDataWC(3, 0).asInt32(), 3);
+
+    view.setNullOrder(km::NullOrder::LAST);
+    EXPECT_EQ(view.getDataWC(0, 0).asInt32(), 1);
+    EXPECT_TRUE(view.isNull(3, 1));
+
+    // insertion and update events place nulls at their end.
+    table.insertRowN({5, std::nullopt});
+    table.insertRowN({6, 20});
+    ASSERT_EQ(view.rowCount(), 6);
+    EXPECT_EQ(view.getDataWC(1, 0).asInt32(), 6);
+    EXPECT_TRUE(view.isNull(5, 1));
+    table.setNull(0, 1); // id 1
+    EXPECT_EQ(view.getDataWC(0, 0).asInt32(), 6);
+    EXPECT_EQ(view.getDataWC(5, 0).asInt32(), 1);
+    table.setData(1, 1, 50); // id 2
+    EXPECT_EQ(view.getDataWC(0, 0).asInt32(), 2);
+
+    km::BitVector validity;
+    ASSERT_TRUE(view.getValidityMask(1, validity));
+    EXPECT_EQ(validity.count(), 3);
+}
+
+TEST(BasicView, InsertRows)
+{
+    km::Table table("table", {{"id", dt::INT32}, {"score", dt::INT32}});
+    for (KInt32 i = 0; i < 20; ++i)
+        table.insertRow({i * 2, (i * 7) % 13});
+    km::BasicView view("view", &table, {"score", "id"}, "isGreater($score, 4)");
+    view.sortBy("score", km::SortingOrder::DESCENDING);
+    km::BasicView nested("nested", &view, {}, "isLess($id, 30)");
+
+    std::vector<std::vector<km::Variant>> rows;
+    for (KInt32 i = 0; i < 20; ++i)
+        rows.push_back({i * 2 + 1, (i * 5) % 11});
+    ASSERT_TRUE(table.insertRows(rows));
+
+    km::BasicView expected("expected", &table, {"score", "id"}, "isGreater($score, 4)");
+    expected.sortBy("score", km::SortingOrder::DESCENDING);
+    ASSERT_EQ(view.rowCount(), expected.rowCount());
+    for (IndexType row = 0; row < view.rowCount(); ++row)
+        EXPECT_EQ(view.getDataWC(row, 0).asInt32(), expected.getDataWC(row, 0).asInt32());
+    EXPECT_TRUE(test_local::isSorted(&view, 0, km::SortingOrder::DESCENDING));
+
+    std::vector<KInt32> nested_ids;
+    for (IndexType row = 0; row < nested.rowCount(); ++row)
+    {
+        EXPECT_LT(nested.getDataWC(row, 1).asInt32(), 30);
+        EXPECT_GT(nested.getDataWC(row, 0).asInt32(), 4);
+        nested_ids.push_back(nested.getDataWC(row, 1).asInt32());
+    }
+    std::vector<IndexType> source_rows;
+    ASSERT_TRUE(km::parse::filter("AND(isGreater($score, 4), isLess($id, 30))", source_rows, &table));
+    EXPECT_EQ(nested_ids.size(), source_rows.size());
+}
+
+TEST(BasicView, DropRows)
+{
+    km::Table table("table", {{"id", dt::INT32}, {"score", dt::INT32}});
+    for (KInt32 i = 0; i < 50; ++i)
+        table.insertRow({i, (i * 7) % 13});
+    km::BasicView view("view", &table, {"score", "id"}, "isGreater($score, 3)");
+    view.sortBy("score", km::SortingOrder::DESCENDING);
+    km::BasicView nested("nested", &view, {}, "isLess($id, 40)");
+
+    ASSERT_TRUE(table.dropWhere("isEqual(mod($id, 3), 0)"));
+    ASSERT_TRUE(table.dropRows({0, 1, 2}));
+
+    km::BasicView expected("expected", &table, {"score", "id"}, "isGreater($score, 3)");
+    expected.sortBy("score", km::SortingOrder::DESCENDING);
+    ASSERT_EQ(view.rowCount(), expected.rowCount());
+    for (IndexType row = 0; row < view.rowCount(); ++row)
+    {
+        EXPECT_EQ(view.getDataWC(row, 0).asInt32(), expected.getDataWC(row, 0).asInt32());
+        EXPECT_NE(view.getDataWC(row, 1).asInt32() % 3, 0);
+    }
+    std::vector<IndexType> source_rows;
+    ASSERT_TRUE(km::parse::filter("AND(isGreater($score, 3), isLess($id, 40))", source_rows, &table));
+    EXPECT_EQ(nested.rowCount(), source_rows.size());
+    for (IndexType row = 0; row < nested.rowCount(); ++row)
+        EXPECT_LT(nested.getDataWC(row, 1).asInt32(), 40);
+}
+
+TEST(BasicView, SortKeys)
+{
+    km::Table table("sales", {{"id", dt::INT32}, {"region", dt::STRING}, {"date", dt::DATE}});
+    for (KInt32 i = 0; i < 200; ++i)
+        table.insertRowN({i, "r" + std::to_string(i * 7 % 4), (i % 11) ? std::optional<km::Variant>(KDate{2022, 1, uint8_t(i * 13 % 9 + 1)}) : std::nullopt});
+    km::BasicView view("view", &table, {"region", "date", "id"}, "isGreater($id, 10)");
+
+    auto is_ordered = [&view]()
+    {
+        auto key_of = [&view](IndexType row)
+        {
+            return std::make_tuple(view.getDataWC(row, 0).asString(), !view.isNull(row, 1),
+                                   view.isNull(row, 1) ? 0 : -km::integralRepresentationOf(view.getDataWC(row, 1).asDate()), view.getDataWC(row, 2).asInt32());
+        };
+        for (IndexType row = 1; row < view.rowCount(); ++row)
+            if (key_of(row) < key_of(row - 1))
+                return false;
+        return true;
+    };
+    view.sortBy(std::vector<km::SortKey>{{"region"}, {"date", km::SortingOrder::DESCENDING}, {"id"}});
+    ASSERT_EQ(view.getSortKeys().size(), 3);
+    EXPECT_EQ(view.getSortKeys()[1].column_name, "date");
+    EXPECT_TRUE(is_ordered());
+    view.sortBy(std::vector<km::SortKey>{{"region"}, {"unknown"}}); // ignored
+    EXPECT_EQ(view.getSortKeys().size(), 3);
+
+    // updates are placed by the composite key.
+    EXPECT_TRUE(table.setData(50, 1, "r0"));
+    EXPECT_TRUE(table.setData(60, 2, KDate{2022, 1, 30}));
+    EXPECT_TRUE(table.setNull(70, 2));
+    EXPECT_TRUE(table.setData(77, 2, KDate{2022, 1, 2})); // was null
+    EXPECT_TRUE(is_ordered());
+    EXPECT_EQ(view.rowCount(), 189);
+    EXPECT_NE(table.insertRowN({500, "r1", std::nullopt}), km::INVALID_INDEX);
+    EXPECT_NE(table.insertRow({501, "r1", KDate{2022, 1, 5}}), km::INVALID_INDEX);
+    EXPECT_TRUE(table.dropRow(100));
+    EXPECT_EQ(view.rowCount(), 190);
+    EXPECT_TRUE(is_ordered());
+    for (IndexType row = 0; row < view.rowCount(); ++row)
+        EXPECT_EQ(view.mapToLocal(table.search("id", view.getDataWC(row, 2)).front()), row);
+
+    view.sortBy("id"); // single column again
+    EXPECT_EQ(view.getSortKeys().size(), 1);
+    EXPECT_TRUE(test_local::isSorted(&view, 2));
+}
@@ -1,7 +1,17 @@
+#include <random>
+#include <numeric>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock-matchers.h>
 
 #include <kmt/Core.hpp>
+#include <kmt/BitVector.hpp>
+#include <kmt/ChunkedVector.hpp>
+#include <kmt/ZoneMap.hpp>
+#include <kmt/RowIndex.hpp>
+#include <kmt/KeyEncoding.hpp>
+#include <kmt/ThreadPool.hpp>
+#include <kmt/RadixSort.hpp>
 
 using namespace km::tp;
 
@@ -119,4 +129,307 @@ TEST(Core, TypeTraits)
     EXPECT_FALSE(km::k_is_integer<KBoolean>::value);
     EXPECT_TRUE(km::k_is_ktype<KInt32>::value);
     EXPECT_FALSE(km::k_is_ktype<unsigned short>::value);
-}
\ No newline at end of file
+}
+TEST(Core, BitVector)
+{
+    km::BitVector bits(130);
+    EXPECT_EQ(bits.size(), 130);
+    EXPECT_EQ(bits.words().size(), 3);
+    EXPECT_EQ(bits.count(), 0);
+
+    bits.set(0, true);
+    bits.set(64, true);
+    bits.set(129, true);
+    EXPECT_TRUE(bits[64]);
+    EXPECT_FALSE(bits[65]);
+    EXPECT_EQ(bits.count(), 3);
+
+    km::BitVector all(130, true);
+    EXPECT_EQ(all.count(), 130);
+    all.flip();
+    EXPECT_EQ(all.count(), 0); // bits after size() stay zero
+    all.flip();
+
+    all &= bits;
+    EXPECT_EQ(all, bits);
+    all.flip();
+    EXPECT_EQ(all.count(), 127);
+    all |= bits;
+    EXPECT_EQ(all.count(), 130);
+
+    std::vector<km::IndexType> set_bits;
+    bits.forEachSetBit([&set_bits](km::IndexType index)
+                       { set_bits.push_back(index); });
+    EXPECT_THAT(set_bits, testing::ElementsAre(0, 64, 129));
+
+    bits.pop_back();
+    bits.push_back(true);
+    bits.push_back(true);
+    EXPECT_EQ(bits.size(), 131);
+    EXPECT_EQ(bits.count(), 4);
+    bits.resize(64, true);
+    EXPECT_EQ(bits.count(), 1);
+    bits.resize(70, true);
+    EXPECT_EQ(bits.count(), 7);
+}
+
+TEST(Core, ChunkedVector)
+{
+    constexpr km::SizeType segment_size = km::ChunkedVector<KInt32>::k_segment_size;
+    km::ChunkedVector<KInt32> vec;
+    EXPECT_TRUE(vec.empty());
+
+    vec.push_back(7);
+    const KInt32 *first = &vec[0];
+    for (KInt32 i = 1; i < KInt32(segment_size) + 10; ++i)
+        vec.push_back(i);
+    EXPECT_EQ(&vec[0], first); // existing data is never moved
+    EXPECT_EQ(vec.size(), segment_size + 10);
+    EXPECT_EQ(vec.segmentCount(), 2);
+    EXPECT_EQ(vec.segmentSize(0), segment_size);
+    EXPECT_EQ(vec.segmentSize(1), 10);
+    EXPECT_EQ(vec[segment_size], KInt32(segment_size));
+    EXPECT_EQ(vec.segment(1)[9], KInt32(segment_size) + 9);
+
+    vec.reserve(3 * segment_size);
+    EXPECT_EQ(vec.capacity(), 3 * segment_size);
+    vec.resize(5);
+    EXPECT_EQ(vec.size(), 5);
+    vec.resize(segment_size + 1);
+    EXPECT_EQ(vec[segment_size], 0); // removed elements are reset
+    vec.pop_back();
+    vec.shrink_to_fit();
+    EXPECT_EQ(vec.segmentCount(), 1);
+    EXPECT_EQ(vec[0], 7);
+}
+
+TEST(Core, EpochDateTime)
+{
+    EXPECT_EQ(km::toEpochDays(KDate{1970, 1, 1}), 0);
+    EXPECT_EQ(km::toEpochDays(KDate{1969, 12, 31}), -1);
+    EXPECT_EQ(km::toEpochDays(KDate{2000, 3, 1}), 11017);
+    EXPECT_EQ(km::toEpochDays(KDate{2022, 3, 16}) + 1, km::toEpochDays(KDate{2022, 3, 17}));
+    EXPECT_EQ(km::toEpochDays(KDate{2024, 3, 1}) - km::toEpochDays(KDate{2024, 2, 28}), 2); // leap year
+
+    for (KInt32 days = -719162; days < 2932897; days += 97) // 01/01/0001 to 31/12/9999
+        ASSERT_EQ(km::toEpochDays(km::fromEpochDays(days)), days);
+    EXPECT_TRUE(km::fromEpochDays(19000) == (KDate{2022, 1, 8}));
+
+    const KDateTime date_time{{2022, 3, 15}, {20, 33, 33}};
+    EXPECT_EQ(km::toEpochSeconds(date_time), 1647376413);
+    EXPECT_TRUE(km::fromEpochSeconds(1647376413) == date_time);
+    EXPECT_TRUE(km::fromEpochSeconds(-1) == (KDateTime{{1969, 12, 31}, {23, 59, 59}}));
+
+    EXPECT_TRUE((KDateTime{{2022, 3, 15}, {20, 33, 33}}) < (KDateTime{{2022, 3, 15}, {20, 33, 34}}));
+    EXPECT_TRUE((KDateTime{{2022, 3, 16}, {0, 0, 0}}) > (KDateTime{{2022, 3, 15}, {23, 59, 59}}));
+
+    // keys keep every date, valid or not.
+    for (const KDate date : {KDate{2022, 2, 30}, KDate{2022, 13, 1}, KDate{0, 0, 0}, KDate{65535, 255, 255}, KDate{1969, 12, 31}})
+    {
+        EXPECT_TRUE(km::fromDateKey(km::toDateKey(date)) == date);
+        const KDateTime date_time{date, {25, 0, 59}};
+        EXPECT_TRUE(km::fromDateTimeKey(km::toDateTimeKey(date_time)) == date_time);
+    }
+    EXPECT_LT(km::toDateKey(KDate{2022, 2, 28}), km::toDateKey(KDate{2022, 2, 30}));
+    EXPECT_LT(km::toDateKey(KDate{2022, 2, 30}), km::toDateKey(KDate{2022, 3, 1}));
+    EXPECT_LT(km::toDateTimeKey(KDateTime{{1969, 12, 31}, {23, 59, 59}}), km::toDateTimeKey(KDateTime{{1970, 1, 1}, {0, 0, 0}}));
+}
+
+TEST(Core, ZoneMap)
+{
+    using km::CompareOp;
+    km::ZoneMap<KFloat64> zones;
+    const SizeType block_size = km::ZoneMapBase::k_block_size;
+    for (SizeType i = 0; i < 2 * block_size + 10; ++i)
+        zones.push_back(static_cast<KFloat64>(i));
+    ASSERT_EQ(zones.blockCount(), 3);
+    EXPECT_EQ(zones.min(1), block_size);
+    EXPECT_EQ(zones.max(1), 2 * block_size - 1);
+
+    EXPECT_FALSE(zones.mayMatch(0, CompareOp::GREATER, block_size - 1.0));
+    EXPECT_TRUE(zones.mayMatch(0, CompareOp::GREATER_OR_EQUAL, block_size - 1.0));
+    EXPECT_FALSE(zones.mayMatch(1, CompareOp::LESS, block_size));
+    EXPECT_TRUE(zones.mayMatch(1, CompareOp::LESS_OR_EQUAL, block_size));
+    EXPECT_TRUE(zones.mayMatch(2, CompareOp::EQUAL, 2 * block_size + 5.0));
+    EXPECT_FALSE(zones.mayMatch(2, CompareOp::EQUAL, 2 * block_size + 10.0));
+    EXPECT_TRUE(km::swapOperands(CompareOp::LESS) == CompareOp::GREATER);
+    EXPECT_TRUE(km::swapOperands(CompareOp::EQUAL) == CompareOp::EQUAL);
+
+    zones.update(5, -1.0); // ranges are only widened
+    EXPECT_EQ(zones.min(0), -1.0);
+    zones.update(6, std::nan(""));
+    EXPECT_EQ(zones.max(0), block_size - 1);
+
+    km::BitVector blocks;
+    zones.getCandidates(CompareOp::LESS, 10.0, blocks);
+    EXPECT_EQ(blocks.count(), 1);
+    EXPECT_TRUE(blocks.test(0));
+
+    for (int i = 0; i < 10; ++i)
+        zones.pop_back();
+    EXPECT_EQ(zones.blockCount(), 2);
+}
+
+TEST(Core, RowIndexTree)
+{
+    km::RowIndexTree tree;
+    std::vector<IndexType> expected;
+    std::mt19937 rng(7);
+    for (IndexType i = 0; i < 20000; ++i)
+    {
+        const IndexType pos = rng() % (expected.size() + 1);
+        tree.insert(pos, i);
+        expected.insert(expected.begin() + pos, i);
+    }
+    ASSERT_EQ(tree.size(), expected.size());
+    for (IndexType i = 0; i < 15000; ++i)
+    {
+        const IndexType pos = rng() % expected.size();
+        tree.erase(pos);
+        expected.erase(expected.begin() + pos);
+    }
+    ASSERT_EQ(tree.size(), expected.size());
+    for (IndexType pos = 0; pos < expected.size(); ++pos)
+        ASSERT_EQ(tree.at(pos), expected[pos]);
+
+    std::vector<IndexType> sorted(10000);
+    std::iota(sorted.begin(), sorted.end(), 0);
+    tree.assign(sorted);
+    EXPECT_EQ(tree.partitionPoint([](IndexType v)
+                                  { return v < 7777; }),
+              7777);
+    EXPECT_EQ(tree.partitionPoint([](IndexType)
+                                  { return true; }),
+              10000);
+    tree.insert(tree.partitionPoint([](IndexType v)
+                                    { return v <= 500; }),
+                500);
+    EXPECT_EQ(tree.at(501), 500);
+    std::vector<IndexType> all;
+    tree.forEach([&all](IndexType v)
+                 { all.push_back(v); });
+    EXPECT_EQ(all.size(), 10001);
+    EXPECT_TRUE(std::is_sorted(all.begin(), all.end()));
+
+    while (tree.size())
+        tree.erase(0);
+    tree.insert(0, 3);
+    EXPECT_EQ(tree.at(0), 3);
+}
+
+static std::string keyOf(const km::Variant &data, km::SortingOrder sorting_order = km::SortingOrder::ASCENDING)
+{
+    std::string key;
+    km::appendKeyValue(key, data, sorting_order);
+    return key;
+}
+
+static void expect_ordered(const std::vector<km::Variant> &values)
+{
+    for (std::size_t i = 0; i + 1 < values.size(); ++i)
+    {
+        EXPECT_LT(km::compareKeys(keyOf(values[i]), keyOf(values[i + 1])), 0) << i;
+        EXPECT_GT(km::compareKeys(keyOf(values[i], km::SortingOrder::DESCENDING), keyOf(values[i + 1], km::SortingOrder::DESCENDING)), 0) << i;
+    }
+}
+
+TEST(Core, KeyEncoding)
+{
+    expect_ordered({KInt32(-2147483647 - 1), KInt32(-5), KInt32(0), KInt32(3), KInt32(2147483647)});
+    expect_ordered({KInt64(-1099511627776LL), KInt64(-1), KInt64(0), KInt64(1099511627776LL)});
+    expect_ordered({KFloat32(-1e30f), KFloat32(-2.5f), KFloat32(-0.5f), KFloat32(0.0f), KFloat32(1e-20f), KFloat32(7.0f)});
+    expect_ordered({KFloat64(-1e300), KFloat64(-1.0), KFloat64(0.0), KFloat64(0.25), KFloat64(1e300)});
+    expect_ordered({KString(""), KString(std::string("a\0", 2)), KString("a\x01"), KString("ab"), KString("b"), KString("\xff")});
+    expect_ordered({KBoolean(false), KBoolean(true)});
+    expect_ordered({KDate{0, 1, 1}, KDate{2021, 12, 31}, KDate{2022, 1, 1}, KDate{2022, 2, 1}, KDate{65535, 12, 31}});
+    expect_ordered({KDateTime{{0, 1, 1}, {0, 0, 0}}, KDateTime{{2022, 1, 1}, {23, 59, 59}}, KDateTime{{2022, 1, 2}, {0, 0, 0}}, KDateTime{{65535, 12, 31}, {23, 59, 59}}});
+    EXPECT_EQ(km::compareKeys(keyOf(KFloat64(-0.0)), keyOf(KFloat64(0.0))), 0);
+
+    // composite keys, nulls and second column break the ties.
+    std::string null_first, null_last, a1, a2;
+    km::appendKeyNull(null_first, km::NullOrder::FIRST);
+    km::appendKeyNull(null_last, km::NullOrder::LAST);
+    km::appendKeyValue(a1, KString("a"), km::SortingOrder::ASCENDING);
+    km::appendKeyValue(a1, KInt32(2), km::SortingOrder::DESCENDING);
+    km::appendKeyValue(a2, KString("a"), km::SortingOrder::ASCENDING);
+    km::appendKeyValue(a2, KInt32(1), km::SortingOrder::DESCENDING);
+    EXPECT_LT(km::compareKeys(null_first, a1), 0);
+    EXPECT_GT(km::compareKeys(null_last, a1), 0);
+    EXPECT_LT(km::compareKeys(a1, a2), 0);
+}
+
+TEST(Core, ParallelStableSort)
+{
+    std::mt19937 generator(11);
+    std::vector<std::pair<int, int>> values(200000);
+    for (int i = 0; i < int(values.size()); ++i)
+        values[i] = {int(generator() % 1000), i};
+    auto by_key = [](const std::pair<int, int> &a, const std::pair<int, int> &b)
+    { return a.first < b.first; };
+    std::vector<std::pair<int, int>> expected = values;
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+
+    km::ThreadPool &pool = km::ThreadPool::instance();
+    for (km::SizeType thread_count : {1, 2, 3, 8})
+    {
+        pool.setThreadCount(thread_count);
+        EXPECT_EQ(pool.getThreadCount(), thread_count);
+        std::vector<std::pair<int, int>> sorted = values;
+        km::parallelStableSort(sorted.begin(), sorted.end(), by_key);
+        EXPECT_EQ(sorted, expected) << thread_count;
+    }
+
+    // every task runs once and the first exception reaches the caller.
+    std::vector<int> counts(100);
+    pool.parallelFor(counts.size(), [&counts](km::IndexType i)
+                     { ++counts[i]; });
+    EXPECT_EQ(std::count(counts.begin(), counts.end(), 1), 100);
+    EXPECT_THROW(pool.parallelFor(10, [](km::IndexType i)
+                                  { if (i == 7) throw std::runtime_error("task"); }),
+                 std::runtime_error);
+    pool.setThreadCount(0);
+    EXPECT_GE(pool.getThreadCount(), 1);
+}
+
+TEST(Core, RadixSort)
+{
+    // keys compare like the values.
+    EXPECT_LT(km::toRadixKey(KInt32(-5)), km::toRadixKey(KInt32(-1)));
+    EXPECT_LT(km::toRadixKey(KInt32(-1)), km::toRadixKey(KInt32(0)));
+    EXPECT_LT(km::toRadixKey(KInt64(3)), km::toRadixKey(KInt64(1099511627776)));
+    EXPECT_LT(km::toRadixKey(KFloat64(-2.5)), km::toRadixKey(KFloat64(-0.5)));
+    EXPECT_LT(km::toRadixKey(KFloat64(-0.5)), km::toRadixKey(KFloat64(0.25)));
+    EXPECT_EQ(km::toRadixKey(KFloat32(-0.0f)), km::toRadixKey(KFloat32(0.0f)));
+    EXPECT_LT(km::toRadixKey(KDate{2021, 12, 31}), km::toRadixKey(KDate{2022, 1, 1}));
+    EXPECT_LT(km::toRadixKey(KBoolean(false)), km::toRadixKey(KBoolean(true)));
+
+    std::mt19937 generator(13);
+    std::vector<KInt32> values(5000);
+    for (KInt32 &value : values)
+        value = KInt32(generator() % 2000) - 1000;
+    for (bool descending : {false, true})
+    {
+        std::vector<km::IndexType> expected(values.size());
+        std::iota(expected.begin(), expected.end(), 0);
+        std::stable_sort(expected.begin(), expected.end(), [&values, descending](km::IndexType a, km::IndexType b)
+                         { return descending ? values[a] > values[b] : values[a] < values[b]; });
+        std::vector<km::IndexType> sorted(values.size());
+        std::iota(sorted.begin(), sorted.end(), 0);
+        std::vector<uint64_t> keys(values.size());
+        for (km::IndexType i = 0; i < values.size(); ++i)
+            keys[i] = km::toRadixKey(values[i]);
+        km::radixSort(sorted, keys, km::radixKeyBytes<KInt32>(), descending);
+        EXPECT_EQ(sorted, expected) << descending;
+
+        // multiples of 7 are nulls, they keep their order at the end.
+        std::iota(sorted.begin(), sorted.end(), 0);
+        for (km::IndexType i = 0; i < values.size(); ++i)
+            keys[i] = km::toRadixKey(values[i]);
+        km::radixSort(sorted, keys, km::radixKeyBytes<KInt32>(), descending, false, [](km::IndexType i)
+                      { return i % 7 == 0; });
+        auto nulls = std::stable_partition(expected.begin(), expected.end(), [](km::IndexType i)
+                                           { return i % 7 != 0; });
+        std::sort(nulls, expected.end());
+        EXPECT_EQ(sorted, expected) << descending;
+    }
+}
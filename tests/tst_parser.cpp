@@ -0,0 +1,156 @@
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kmt/Parser2.hpp>
+#include <kmt/ErrorHandler.hpp>
+
+namespace
+{
+    // token types, same values as parse::TType.
+    enum : uint16_t
+    {
+        INT32 = 0x0001,
+        INT64 = 0x0002,
+        FLOAT32 = 0x0004,
+        FLOAT64 = 0x0008,
+        STRING = 0x0010,
+        BOOLEAN = 0x0020,
+        COLUMN = 0x0040,
+        FUNCTION = 0x0080,
+        COMMA = 0x0100,
+        P_OPEN = 0x0200,
+        P_CLOSE = 0x0400,
+        INVALID = 0x0800,
+    };
+
+    using Tokens = std::vector<std::pair<std::string, uint16_t>>;
+
+    // the regex based tokenizer which parse::parseToTokens() replaced, the lexer must give the same tokens.
+    bool referenceTokens(std::string formula, Tokens &tokens)
+    {
+        static const std::vector<std::pair<uint16_t, std::regex>> regex_map{
+            {INT32, std::regex("\\-?\\d+")},
+            {INT64, std::regex("\\-?\\d+(l|L)?")},
+            {FLOAT32, std::regex("\\-?\\d+\\.(\\d+)?f")},
+            {FLOAT64, std::regex("\\-?\\d+\\.(\\d+)?")},
+            {STRING, std::regex("\".*\"")},
+            {BOOLEAN, std::regex("(True)|(False)")},
+            {COLUMN, std::regex("\\$[A-Za-z_]\\w*")},
+            {FUNCTION, std::regex("[A-Za-z]\\w*")},
+            {P_OPEN, std::regex("\\(")},
+            {P_CLOSE, std::regex("\\)")},
+            {COMMA, std::regex(",")},
+            {INVALID, std::regex(".*")}};
+        tokens.clear();
+        std::string current_token;
+        bool is_string = false;
+        auto push = [&tokens](const std::string &text)
+        { tokens.push_back({text, INVALID}); };
+        formula += ' ';
+        for (char c : formula)
+        {
+            if (is_string)
+            {
+                current_token.push_back(c);
+                if (c == '\"')
+                {
+                    push(current_token);
+                    current_token.clear();
+                    is_string = false;
+                }
+            }
+            else if (c == '\"')
+            {
+                if (!current_token.empty())
+                    push(current_token);
+                current_token = "\"";
+                is_string = true;
+            }
+            else if (c == ' ' || c == ',' || c == '(' || c == ')')
+            {
+                if (!current_token.empty())
+                    push(current_token);
+                current_token.clear();
+                if (c != ' ')
+                    push(std::string(1, c));
+            }
+            else
+                current_token.push_back(c);
+        }
+        if (is_string)
+            return false;
+        for (auto &[text, type] : tokens)
+        {
+            for (const auto &[regex_type, regex] : regex_map)
+            {
+                if (std::regex_match(text, regex))
+                {
+                    type = regex_type;
+                    break;
+                }
+            }
+            if (type == INVALID)
+                return false;
+        }
+        return true;
+    }
+
+    bool lexerTokens(const std::string &formula, Tokens &tokens)
+    {
+        km::parse::TokenContainer token_vec;
+        const bool parsed = km::parse::parseToTokens(formula, token_vec);
+        tokens.clear();
+        for (const km::parse::Token &token : token_vec)
+            tokens.push_back({std::string(token.source), token.token_type});
+        return parsed;
+    }
+}
+
+TEST(Parser, Lexer)
+{
+    Tokens tokens;
+    ASSERT_TRUE(lexerTokens("add($per, 5.0f)", tokens));
+    EXPECT_EQ(tokens, (Tokens{{"add", FUNCTION}, {"(", P_OPEN}, {"$per", COLUMN}, {",", COMMA}, {"5.0f", FLOAT32}, {")", P_CLOSE}}));
+    ASSERT_TRUE(lexerTokens("IF(True,-12L,\"a (b), c\")3. -7 False_", tokens));
+    EXPECT_EQ(tokens, (Tokens{{"IF", FUNCTION}, {"(", P_OPEN}, {"True", BOOLEAN}, {",", COMMA}, {"-12L", INT64}, {",", COMMA},
+                              {"\"a (b), c\"", STRING}, {")", P_CLOSE}, {"3.", FLOAT64}, {"-7", INT32}, {"False_", FUNCTION}}));
+    ASSERT_TRUE(lexerTokens("  ", tokens));
+    EXPECT_TRUE(tokens.empty());
+
+    km::err::LockLogFileHandler locker;
+    EXPECT_FALSE(lexerTokens("add(1, \"open)", tokens));
+    EXPECT_FALSE(lexerTokens("add(.5, 1)", tokens));
+    EXPECT_FALSE(lexerTokens("add($1a, 1)", tokens));
+    EXPECT_FALSE(lexerTokens("add(5Lx, 1)", tokens));
+    EXPECT_FALSE(lexerTokens("add(\"a\nb\", 1)", tokens));
+    EXPECT_FALSE(lexerTokens("add(5,\t1)", tokens));
+}
+
+TEST(Parser, LexerMatchesRegexTokenizer)
+{
+    // random formulas built from pieces which are on the edges of the token patterns.
+    const std::vector<std::string> pieces{"0", "7", "42", "-", ".", "f", "l", "L", "$", "_", "a", "Z", "x9", "True", "False",
+                                          "Tru", "add", " ", " ", ",", "(", ")", "\"", "\t", "\n", "#", "\xC3\xA9", "e+"};
+    std::mt19937 generator(24);
+    km::err::LockLogFileHandler locker;
+    Tokens expected, actual;
+    km::SizeType valid_count = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        std::string formula;
+        for (km::SizeType length = generator() % 12; length > 0; --length)
+            formula += pieces[generator() % pieces.size()];
+        const bool expected_result = referenceTokens(formula, expected);
+        ASSERT_EQ(lexerTokens(formula, actual), expected_result) << '`' << formula << '`';
+        if (expected_result)
+        {
+            ASSERT_EQ(actual, expected) << '`' << formula << '`';
+            ++valid_count;
+        }
+    }
+    EXPECT_GT(valid_count, 1000); // valid formulas are compared token by token
+}
@@ -1,9 +1,11 @@
+#include <random>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock-matchers.h>
 
 #include <kmt/Table.hpp>
 #include <kmt/BasicView.hpp>
+#include <kmt/ThreadPool.hpp>
 
 #include "test_helper.hpp"
 
@@ -234,3 +236,1171 @@ TEST(Table, AddColumn)
     EXPECT_EQ(table.columnCount(), 3);
 }
 
+
+TEST(Table, TypedColumnAccess)
+{
+    km::Table &table = *test_local::getStaticStudentTable(); // see table_helper.cpp
+
+    auto name = table.columnAs<KString>("name");
+    auto id = table.columnAs<KInt32>("id");
+    ASSERT_TRUE(name.isValid());
+    ASSERT_TRUE(id.isValid());
+    ASSERT_EQ(name.size(), table.rowCount());
+
+    for (IndexType row = 0, row_count = table.rowCount(); row < row_count; ++row)
+    {
+        EXPECT_EQ(name[row], table.getDataWC(row, 0).asString());
+        EXPECT_EQ(id[row], table.getDataWC(row, 1).asInt32());
+    }
+
+    // span follows the physical order (order of insertion)
+    km::ColumnSpan<KInt32> span = id.column().getSpan();
+    ASSERT_EQ(span.size(), table.rowCount());
+    EXPECT_EQ(span[0], 1);
+    EXPECT_EQ(span[9], 10);
+
+    EXPECT_FALSE(table.columnAs<KInt64>("id").isValid());     // type mismatch
+    EXPECT_FALSE(table.columnAs<KInt32>("no_column"));        // column doesn't exist
+}
+
+TEST(Table, DictionaryColumn)
+{
+    km::Table table("orders", {{"status", "Status", dt::STRING, km::ColumnStorage::DICTIONARY},
+                               {"id", dt::INT32},
+                               {"region", "Region", dt::STRING, km::ColumnStorage::DICTIONARY}});
+    EXPECT_EQ(table.getColumnMetaData(0).storage, km::ColumnStorage::DICTIONARY);
+    EXPECT_EQ(table.getColumnMetaData(1).storage, km::ColumnStorage::DEFAULT);
+
+    const char *statuses[] = {"shipped", "pending", "cancelled", "delivered"};
+    const char *regions[] = {"north", "south", "east", "west", "central"};
+    for (KInt32 i = 0; i < 40; ++i)
+        ASSERT_NE(table.insertRow({statuses[i % 4], i, regions[i % 5]}), km::INVALID_INDEX);
+
+    ASSERT_EQ(table.rowCount(), 40);
+    EXPECT_TRUE(test_local::isSorted(&table, 0));
+    EXPECT_EQ(table.getDataWC(0, 0).asString(), "cancelled");
+    EXPECT_EQ(table.getDataWC(39, 0).asString(), "shipped");
+
+    EXPECT_EQ(table.searchInKeyColumn("pending").size(), 10);
+    EXPECT_EQ(table.search("region", "east").size(), 8);
+    EXPECT_TRUE(table.search("region", "nowhere").empty());
+
+    // a new string in between the existing strings gets the next code and only moves the ranks.
+    IndexType row = table.search("region", "east").back();
+    EXPECT_TRUE(table.setData(row, 2, "middle"));
+    EXPECT_EQ(table.getDataWC(row, 2).asString(), "middle");
+    EXPECT_EQ(table.search("region", "east").size(), 7);
+    EXPECT_EQ(table.search("region", "west").size(), 8);
+
+    // freeing space recreates the columns with same storage.
+    table.setMaxFreeSpaceTolerance(4);
+    for (int i = 0; i < 4; ++i)
+        table.dropRow(0);
+    EXPECT_EQ(table.getColumnMetaData(2).storage, km::ColumnStorage::DICTIONARY);
+    EXPECT_EQ(table.rowCount(), 36);
+    EXPECT_EQ(table.searchInKeyColumn("cancelled").size(), 6);
+    EXPECT_EQ(table.search("region", "middle").size(), 1);
+
+    km::DictionaryColumn column("city", "City");
+    for (const char *city : {"paris", "berlin", "rome", "berlin", "athens"})
+        column.pushData(KString(city));
+    EXPECT_EQ(column.getDictionary().size(), 4);
+    EXPECT_EQ(column.getCode(0), 0); // codes in the order strings are first seen
+    EXPECT_EQ(column.getCode(3), 1);
+    EXPECT_EQ(column.getCode(4), 3);
+    EXPECT_EQ(column.getRank(4), 0); // ranks in the order of the strings
+    EXPECT_EQ(column.getRank(0), 2);
+    EXPECT_TRUE(column.isLess(4, 1) && column.isGreater(2, 0) && column.isEqual(1, 3));
+    EXPECT_EQ(column.findCode("rome"), 2);
+    EXPECT_EQ(column.findCode("oslo"), km::INVALID_INDEX);
+}
+
+TEST(Table, ArenaStringColumn)
+{
+    km::Table table("users", {{"email", "Email", dt::STRING, km::ColumnStorage::ARENA},
+                              {"id", dt::INT32},
+                              {"note", "Note", dt::STRING, km::ColumnStorage::ARENA}});
+    EXPECT_EQ(table.getColumnMetaData(2).storage, km::ColumnStorage::ARENA);
+
+    table.reserve(50);
+    for (KInt32 i = 0; i < 50; ++i)
+        ASSERT_NE(table.insertRow({"user" + std::to_string(49 - i) + "@mail.com", i, std::string(i % 7, 'x')}), km::INVALID_INDEX);
+
+    EXPECT_TRUE(test_local::isSorted(&table, 0));
+    EXPECT_EQ(table.getDataWC(0, 0).asString(), "user0@mail.com");
+    EXPECT_EQ(table.searchInKeyColumn("user7@mail.com").size(), 1);
+    EXPECT_EQ(table.search("note", "xxx").size(), 7);
+
+    // longer string is appended to the arena, shorter one reuses the old place.
+    const IndexType row = table.searchInKeyColumn("user7@mail.com").front();
+    EXPECT_TRUE(table.setData(row, 2, "a much longer note than before"));
+    EXPECT_EQ(table.getDataWC(row, 2).asString(), "a much longer note than before");
+    EXPECT_TRUE(table.setData(row, 2, "short"));
+    EXPECT_EQ(table.getDataWC(row, 2).asString(), "short");
+
+    // freeing space compacts the arena.
+    table.setMaxFreeSpaceTolerance(5);
+    for (int i = 0; i < 5; ++i)
+        table.dropRow(0);
+    EXPECT_EQ(table.rowCount(), 45);
+    EXPECT_EQ(table.getDataWC(0, 0).asString(), "user14@mail.com");
+    EXPECT_EQ(table.search("note", "short").size(), 1);
+    EXPECT_EQ(table.getColumnMetaData(2).storage, km::ColumnStorage::ARENA);
+    EXPECT_TRUE(test_local::isSorted(&table, 0));
+}
+
+TEST(Table, BooleanColumnMask)
+{
+    km::Table table("flags", {{"id", dt::INT32}, {"even", dt::BOOLEAN}, {"big", dt::BOOLEAN}});
+    for (KInt32 i = 199; i >= 0; --i)
+        table.insertRow({i, i % 2 == 0, i >= 150});
+
+    auto even = table.columnAs<KBoolean>("even");
+    ASSERT_TRUE(even);
+    EXPECT_TRUE(even[0]);
+    EXPECT_FALSE(even[1]);
+    EXPECT_EQ(even.column().count(), 100);
+
+    std::vector<IndexType> rows;
+    ASSERT_TRUE(km::parse::filter("$big", rows, &table));
+    ASSERT_EQ(rows.size(), 50);
+    EXPECT_EQ(rows.front(), 150);
+    EXPECT_EQ(rows.back(), 199);
+
+    // same result as evaluating the formula for every row.
+    std::vector<IndexType> expected;
+    ASSERT_TRUE(km::parse::filter("AND($even, isGreaterOrEqual($id, 150))", expected, &table));
+    km::BitVector mask;
+    table.getBooleanMask(1, mask);
+    km::BitVector big;
+    table.getBooleanMask(2, big);
+    mask &= big;
+    rows.clear();
+    km::parse::filter(mask, rows);
+    EXPECT_EQ(rows, expected);
+    EXPECT_EQ(rows.size(), 25);
+
+    km::BasicView view("view", &table, {"id", "big"}, "$even");
+    ASSERT_EQ(view.rowCount(), 100);
+    rows.clear();
+    ASSERT_TRUE(km::parse::filter("$big", rows, &view));
+    EXPECT_EQ(rows.size(), 25);
+}
+
+TEST(Table, NullValues)
+{
+    km::Table table("scores", {{"name", dt::STRING}, {"score", dt::INT32}, {"bonus", dt::INT32}});
+    EXPECT_NE(table.insertRowN({"b", 10, 1}), km::INVALID_INDEX);
+    EXPECT_NE(table.insertRowN({std::nullopt, 20, 2}), km::INVALID_INDEX);
+    EXPECT_NE(table.insertRowN({"a", std::nullopt, 3}), km::INVALID_INDEX);
+    EXPECT_NE(table.insertRowN({"c", 40, std::nullopt}), km::INVALID_INDEX);
+
+    // nulls first by default.
+    EXPECT_TRUE(table.isNull(0, 0));
+    EXPECT_EQ(table.getDataWC(1, 0).asString(), "a");
+    EXPECT_EQ(table.getDataWC(3, 0).asString(), "c");
+    EXPECT_TRUE(table.isNull(1, 1));
+    EXPECT_FALSE(table.isNull(1, 2));
+
+    table.setNullOrder(km::NullOrder::LAST);
+    EXPECT_EQ(table.getDataWC(0, 0).asString(), "a");
+    EXPECT_TRUE(table.isNull(3, 0));
+    EXPECT_EQ(table.searchInKeyColumn("c").size(), 1);
+    EXPECT_EQ(table.searchInKeyColumn("").size(), 0);
+
+    // result is null wherever any referred column is null.
+    ASSERT_TRUE(table.addColumnE({"total", dt::INT32}, "add($score, $bonus)"));
+    EXPECT_TRUE(table.isNull(0, 3));                // score of "a" is null
+    EXPECT_EQ(table.getDataWC(1, 3).asInt32(), 11); // "b"
+    EXPECT_TRUE(table.isNull(2, 3));                // bonus of "c" is null
+    EXPECT_EQ(table.getDataWC(3, 3).asInt32(), 22);
+
+    std::vector<IndexType> rows;
+    ASSERT_TRUE(km::parse::filter("isGreater($total, 0)", rows, &table));
+    EXPECT_THAT(rows, testing::ElementsAre(1, 3));
+    EXPECT_TRUE(table.search("bonus", 0).empty()); // null bonus holds 0 but is not found
+
+    EXPECT_TRUE(table.setData(0, 1, 5));
+    EXPECT_FALSE(table.isNull(0, 1));
+    EXPECT_TRUE(table.setNull(1, 2));
+    EXPECT_FALSE(table.setNull(1, 0));
+    EXPECT_TRUE(table.transformColumn("total", "add($score, $bonus)"));
+    EXPECT_EQ(table.getDataWC(0, 3).asInt32(), 8);
+    EXPECT_TRUE(table.isNull(1, 3));
+
+    // nulls survive freeing the space and reused rows don't keep old nulls.
+    table.setMaxFreeSpaceTolerance(2);
+    EXPECT_TRUE(table.dropRow(1));
+    EXPECT_NE(table.insertRowN({"d", 1, 1, 2}), km::INVALID_INDEX);
+    EXPECT_FALSE(table.isNull(2, 2));
+    EXPECT_TRUE(table.dropRow(0));
+    EXPECT_TRUE(table.dropRow(0));
+    ASSERT_EQ(table.rowCount(), 2);
+    EXPECT_EQ(table.getDataWC(0, 0).asString(), "d");
+    EXPECT_TRUE(table.isNull(1, 0));
+    EXPECT_TRUE(table.getNullOrder() == km::NullOrder::LAST);
+}
+
+TEST(Table, ChunkedColumn)
+{
+    km::Table table("readings", {{"time", dt::INT64, km::ColumnStorage::CHUNKED},
+                                 {"value", dt::FLOAT64, km::ColumnStorage::CHUNKED},
+                                 {"sensor", dt::STRING, km::ColumnStorage::CHUNKED},
+                                 {"ok", dt::BOOLEAN, km::ColumnStorage::CHUNKED}});
+    EXPECT_EQ(table.getColumnMetaData(1).storage, km::ColumnStorage::CHUNKED);
+    EXPECT_EQ(table.getColumnMetaData(3).storage, km::ColumnStorage::DEFAULT); // booleans are bit packed already
+
+    const KInt64 row_count = 70000; // more than a segment
+    table.reserve(row_count);
+    for (KInt64 i = 0; i < row_count; ++i)
+        ASSERT_NE(table.insertRow({i, i * 0.5, "s" + std::to_string(i % 10), i % 2 == 0}), km::INVALID_INDEX);
+
+    EXPECT_EQ(table.getDataWC(69999, 0).asInt64(), 69999);
+    EXPECT_EQ(table.searchInKeyColumn(KInt64(65536)).size(), 1);
+    EXPECT_EQ(table.search("sensor", "s3").size(), 7000);
+    table.setEpsilon("value", 0.1);
+    EXPECT_EQ(table.search("value", 10.05).size(), 1);
+    EXPECT_TRUE(table.addColumnE({"double", dt::FLOAT64, km::ColumnStorage::CHUNKED}, "mul($value, 2.0)"));
+    EXPECT_DOUBLE_EQ(table.getDataWC(65537, 4).asFloat64(), 65537.0);
+
+    table.setMaxFreeSpaceTolerance(10);
+    for (int i = 0; i < 10; ++i)
+        EXPECT_TRUE(table.dropRow(0));
+    EXPECT_EQ(table.rowCount(), row_count - 10);
+    EXPECT_EQ(table.getDataWC(0, 0).asInt64(), 10);
+    EXPECT_EQ(table.search("value", 10.05).size(), 1); // epsilon is kept after freeing space
+}
+
+TEST(Table, EpochDateColumns)
+{
+    km::Table table("events", {{"when", dt::DATE_TIME}, {"day", dt::DATE}});
+    table.insertRow({KDateTime{{2022, 3, 15}, {20, 33, 33}}, KDate{2022, 3, 15}});
+    table.insertRow({KDateTime{{1969, 7, 20}, {20, 17, 40}}, KDate{1969, 7, 20}});
+    table.insertRow({KDateTime{{2022, 3, 15}, {8, 0, 0}}, KDate{2022, 3, 15}});
+
+    EXPECT_TRUE(table.getDataWC(0, 0).asDateTime() == (KDateTime{{1969, 7, 20}, {20, 17, 40}}));
+    EXPECT_TRUE(table.getDataWC(2, 0).asDateTime() == (KDateTime{{2022, 3, 15}, {20, 33, 33}}));
+    EXPECT_EQ(table.search("day", KDate{2022, 3, 15}).size(), 2);
+    EXPECT_EQ(table.searchInKeyColumn(KDateTime{{2022, 3, 15}, {8, 0, 0}}).size(), 1);
+
+    auto day = table.columnAs<KDate>("day");
+    ASSERT_TRUE(day);
+    EXPECT_TRUE(day[0] == (KDate{1969, 7, 20}));
+    EXPECT_EQ(day.column().getKeyValue(0), km::toDateKey(KDate{2022, 3, 15}));
+    EXPECT_EQ(day.column().getKeySpan().size(), 3);
+
+    std::vector<IndexType> rows;
+    ASSERT_TRUE(km::parse::filter("isLess($day, $day)", rows, &table));
+    EXPECT_TRUE(rows.empty());
+
+    // invalid and default dates are stored as they are, and ordered like the comparisons of Variants.
+    const std::vector<KDateTime> odd{{{2022, 2, 30}, {8, 0, 0}}, {{2022, 13, 1}, {25, 61, 61}}, {{0, 0, 0}, {0, 0, 0}}, {}};
+    for (const KDateTime &date_time : odd)
+        table.insertRow({date_time, date_time.date});
+    ASSERT_NE(table.insertRowN({KDateTime{{2030, 1, 1}, {0, 0, 0}}, std::nullopt}), km::INVALID_INDEX);
+    EXPECT_TRUE(day.column().getValue(day.column().getKeySpan().size() - 1) == KDate{}); // null is default date
+    for (const KDateTime &date_time : odd)
+    {
+        const auto found = table.search("day", date_time.date);
+        ASSERT_FALSE(found.empty());
+        EXPECT_TRUE(table.getDataWC(found.front(), 1).asDate() == date_time.date);
+        const auto found_key = table.searchInKeyColumn(date_time);
+        ASSERT_EQ(found_key.size(), (date_time.date == KDate{} ? 2 : 1));
+        EXPECT_TRUE(table.getDataWC(found_key.front(), 0).asDateTime() == date_time);
+    }
+    for (IndexType row = 1; row < table.rowCount(); ++row)
+        EXPECT_FALSE(table.getDataWC(row, 0).asDateTime() < table.getDataWC(row - 1, 0).asDateTime()) << row;
+}
+
+TEST(Table, ClusteredMode)
+{
+    km::Table table("numbers", {{"key", dt::INT32}, {"value", dt::STRING}});
+    for (KInt32 key : {5, 3, 9, 1, 7})
+        table.insertRow({key, std::to_string(key)});
+    EXPECT_FALSE(table.isClusteredMode());
+    auto physical = [&table]()
+    {
+        auto span = table.columnAs<KInt32>("key").column().getSpan();
+        return std::vector<KInt32>(span.begin(), span.end());
+    };
+    EXPECT_EQ(physical(), (std::vector<KInt32>{5, 3, 9, 1, 7}));
+
+    table.setClusteredMode(true, 2);
+    EXPECT_TRUE(table.isClusteredMode());
+    EXPECT_EQ(physical(), (std::vector<KInt32>{1, 3, 5, 7, 9}));
+    EXPECT_EQ(table.getDataWC(2, 1).asString(), "5");
+
+    table.insertRow({KInt32(11), "11"}); // appended in order, no clustering needed
+    table.insertRow({KInt32(4), "4"});
+    EXPECT_EQ(physical(), (std::vector<KInt32>{1, 3, 5, 7, 9, 11, 4}));
+    table.insertRow({KInt32(2), "2"}); // threshold reached
+    EXPECT_EQ(physical(), (std::vector<KInt32>{1, 2, 3, 4, 5, 7, 9, 11}));
+    EXPECT_TRUE(test_local::isSorted(&table, 0));
+
+    table.pauseSorting();
+    table.insertRow({KInt32(0), "0"});
+    table.insertRow({KInt32(6), "6"});
+    table.resumeSorting(); // sorts and clusters
+    EXPECT_EQ(physical(), (std::vector<KInt32>{0, 1, 2, 3, 4, 5, 6, 7, 9, 11}));
+    EXPECT_EQ(table.getDataWC(6, 1).asString(), "6");
+}
+
+TEST(Table, ParallelEvaluation)
+{
+    km::Table table("readings", {{"id", dt::INT32}, {"value", dt::FLOAT64}, {"name", dt::STRING}});
+    std::vector<std::vector<km::Variant>> rows;
+    std::mt19937 generator(9);
+    for (KInt32 i = 0; i < 60000; ++i)
+        rows.push_back({KInt32(generator() % 100000), (generator() % 1000) * 0.25, "n" + std::to_string(i % 13)});
+    ASSERT_TRUE(table.insertRows(rows));
+
+    // same results with one and with many threads, for every kind of target column.
+    auto evaluate = [&table](const std::string &suffix)
+    {
+        EXPECT_TRUE(table.addColumnE({"scaled" + suffix, dt::FLOAT64}, "mul($value, 3.0)"));
+        EXPECT_TRUE(table.addColumnE({"sum" + suffix, dt::INT64, km::ColumnStorage::CHUNKED}, "add(toInt64($id), 7L)"));
+        EXPECT_TRUE(table.addColumnE({"label" + suffix, dt::STRING, km::ColumnStorage::DICTIONARY}, "add($name, \"!\")"));
+        EXPECT_TRUE(table.addColumnE({"big" + suffix, dt::BOOLEAN}, "isGreater($value, 100.0)"));
+    };
+    km::ThreadPool::instance().setThreadCount(1);
+    evaluate("_1");
+    km::ThreadPool::instance().setThreadCount(4);
+    evaluate("_4");
+    EXPECT_TRUE(table.transformColumn("scaled_4", "sub($scaled_4, 1.0)"));
+    km::ThreadPool::instance().setThreadCount(0);
+
+    for (IndexType row = 0; row < table.rowCount(); ++row)
+    {
+        ASSERT_EQ(table.getDataWC(row, 3).asFloat64() - 1.0, table.getDataWC(row, 7).asFloat64());
+        for (IndexType column = 4; column < 7; ++column)
+        {
+            const km::Variant single = table.getDataWC(row, column), parallel = table.getDataWC(row, column + 4);
+            ASSERT_TRUE(km::isEqualComparatorFor(km::dataTypeOf(single))(single, parallel)) << row << ", " << column;
+        }
+    }
+
+    // zone map of the target column is rebuilt after the concurrent writes.
+    std::vector<IndexType> found;
+    ASSERT_TRUE(km::parse::filter("isLess($scaled_4, 10.0)", found, &table));
+    SizeType expected = 0;
+    for (IndexType row = 0; row < table.rowCount(); ++row)
+        expected += (table.getDataWC(row, 7).asFloat64() < 10.0);
+    EXPECT_EQ(found.size(), expected);
+    EXPECT_GT(expected, 0);
+}
+
+TEST(Table, ZoneMapFilter)
+{
+    km::Table table("prices", {{"time", dt::INT64}, {"price", dt::FLOAT64}, {"day", dt::DATE}});
+    const KInt64 row_count = 20000;
+    for (KInt64 i = 0; i < row_count; ++i)
+        table.insertRow({i, i * 0.5, km::fromEpochDays(static_cast<KInt32>(i / 100))});
+
+    auto brute_force = [&table](auto predicate)
+    {
+        std::vector<IndexType> rows;
+        for (IndexType row = 0; row < table.rowCount(); ++row)
+            if (!table.isNull(row, 1) && predicate(table.getDataWC(row, 1).asFloat64()))
+                rows.push_back(row);
+        return rows;
+    };
+
+    km::BitVector mask;
+    ASSERT_TRUE(table.getCandidateMask(1, km::CompareOp::GREATER, KFloat64(9000.0), mask));
+    EXPECT_LT(mask.count(), row_count / 2); // blocks before 9000.0 are skipped
+    EXPECT_FALSE(table.getCandidateMask(1, km::CompareOp::GREATER, KFloat64(-1.0), mask));
+
+    std::vector<IndexType> rows;
+    ASSERT_TRUE(km::parse::filter("isGreater($price, 9000.0)", rows, &table));
+    EXPECT_EQ(rows, brute_force([](KFloat64 v)
+                                { return v > 9000.0; }));
+    rows.clear();
+    ASSERT_TRUE(km::parse::filter("isLessOrEqual(100.0, $price)", rows, &table)); // swapped operands
+    EXPECT_EQ(rows, brute_force([](KFloat64 v)
+                                { return v >= 100.0; }));
+    rows.clear();
+    ASSERT_TRUE(km::parse::filter("AND(isGreaterOrEqual($price, 3000.0), isLess($time, 6010L))", rows, &table));
+    EXPECT_EQ(rows, brute_force([](KFloat64 v)
+                                { return v >= 3000.0 && v < 3005.0; }));
+    rows.clear();
+    ASSERT_TRUE(km::parse::filter("OR(isLess($price, 1.0), isEqual($day, toDate(2, 1, 1970)))", rows, &table));
+    EXPECT_EQ(rows.size(), 102);
+
+    // updated value widens the range of its block
+    ASSERT_TRUE(table.setData(0, 1, KFloat64(50000.0)));
+    rows.clear();
+    ASSERT_TRUE(km::parse::filter("isGreater($price, 40000.0)", rows, &table));
+    EXPECT_EQ(rows, std::vector<IndexType>{0});
+
+    // blocks which are entirely null are skipped
+    for (IndexType row = 0; row < km::ZoneMapBase::k_block_size; ++row)
+        table.setNull(row, 1);
+    EXPECT_TRUE(table.getCandidateMask(1, km::CompareOp::GREATER, KFloat64(-1.0), mask));
+    EXPECT_FALSE(mask.test(0));
+    rows.clear();
+    ASSERT_TRUE(km::parse::filter("isGreater($price, 40000.0)", rows, &table));
+    EXPECT_TRUE(rows.empty());
+
+    // zone maps are rebuilt when space is freed
+    table.setMaxFreeSpaceTolerance(1);
+    EXPECT_TRUE(table.dropRow(row_count - 1));
+    rows.clear();
+    ASSERT_TRUE(km::parse::filter("isGreaterOrEqual($price, 9990.0)", rows, &table));
+    EXPECT_EQ(rows, brute_force([](KFloat64 v)
+                                { return v >= 9990.0; }));
+}
+
+TEST(Table, MemoryResource)
+{
+    std::byte buffer[1 << 14];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    {
+        km::Table table("scratch", {{"id", dt::INT32}, {"total", dt::FLOAT64}, {"day", dt::DATE}}, km::SortingOrder::ASCENDING, &arena);
+        EXPECT_EQ(table.getMemoryResource(), &arena);
+        table.reserve(100);
+        for (KInt32 i = 0; i < 100; ++i)
+            ASSERT_NE(table.insertRow({100 - i, i * 1.5, KDate{2022, 5, 1}}), km::INVALID_INDEX);
+        ASSERT_TRUE(table.addColumnE({"twice", dt::FLOAT64}, "mul($total, 2.0)"));
+        table.setMaxFreeSpaceTolerance(1);
+        EXPECT_TRUE(table.dropRow(0)); // compacted columns keep the resource
+        EXPECT_EQ(table.getDataWC(0, 0).asInt32(), 2);
+        EXPECT_DOUBLE_EQ(table.getDataWC(0, 3).asFloat64(), 294.0);
+        EXPECT_EQ(table.columnAs<KInt32>("id").column().getMemoryResource(), &arena);
+        EXPECT_EQ(table.columnAs<KDate>("day").column().getMemoryResource(), &arena);
+    }
+    // default resource is used when none is given
+    km::Table table("default", {{"id", dt::INT32}});
+    EXPECT_EQ(table.getMemoryResource(), std::pmr::get_default_resource());
+}
+
+namespace
+{
+    // forwards allocations to the global heap and counts the allocated bytes.
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        std::size_t allocated = 0;
+
+    private:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            allocated += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+}
+
+TEST(Table, MemoryResourceStrings)
+{
+    const std::string long_string(100000, 'x'); // far longer than any small string buffer
+    for (km::ColumnStorage storage : {km::ColumnStorage::DEFAULT, km::ColumnStorage::DICTIONARY, km::ColumnStorage::ARENA, km::ColumnStorage::CHUNKED})
+    {
+        CountingResource resource;
+        km::Table table("scratch", {{"id", dt::INT32}, {"text", "Text", dt::STRING, storage}, {"flag", dt::BOOLEAN}}, km::SortingOrder::ASCENDING, &resource);
+        for (KInt32 i = 0; i < 100; ++i)
+            ASSERT_NE(table.insertRow({i, "a", i % 2 == 0}), km::INVALID_INDEX);
+
+        // characters of the string are allocated from the resource.
+        std::size_t allocated = resource.allocated;
+        ASSERT_TRUE(table.setData(50, 1, long_string));
+        EXPECT_GE(resource.allocated - allocated, long_string.size()) << "storage " << static_cast<int>(storage);
+        EXPECT_EQ(table.getDataWC(50, 1).asString(), long_string);
+
+        // so are the nulls and the compacted columns.
+        allocated = resource.allocated;
+        ASSERT_TRUE(table.setNull(10, 2));
+        EXPECT_GT(resource.allocated, allocated);
+        table.setMaxFreeSpaceTolerance(1);
+        allocated = resource.allocated;
+        EXPECT_TRUE(table.dropRow(0));
+        EXPECT_GE(resource.allocated - allocated, long_string.size()) << "storage " << static_cast<int>(storage);
+        EXPECT_EQ(table.getDataWC(49, 1).asString(), long_string);
+        EXPECT_TRUE(table.isNull(9, 2));
+    }
+}
+
+TEST(Table, InsertRows)
+{
+    km::Table table("batch", {{"id", dt::INT32}, {"name", dt::STRING}});
+    table.insertRow({KInt32(10), "ten"});
+    table.insertRow({KInt32(30), "thirty"});
+
+    ASSERT_TRUE(table.insertRows({{KInt32(25), "a"}, {KInt32(5), "b"}, {KInt32(30), "c"}, {KInt32(40), "d"}}));
+    ASSERT_TRUE(table.insertRows({{KInt32(1), KInt32(20)}, {"e", "f"}}, km::DataLayout::COLUMN_MAJOR));
+    EXPECT_EQ(table.rowCount(), 8);
+    EXPECT_TRUE(test_local::isSorted(&table, 0));
+    EXPECT_EQ(table.getDataWC(0, 1).asString(), "e");
+    EXPECT_EQ(table.getDataWC(5, 1).asString(), "thirty"); // equal keys are placed after existing rows
+    EXPECT_EQ(table.getDataWC(6, 1).asString(), "c");
+
+    // nothing is inserted if any value is invalid
+    EXPECT_FALSE(table.insertRows({{KInt32(2), "x"}, {KInt32(3), KInt32(3)}}));
+    EXPECT_FALSE(table.insertRows({{KInt32(2), "x"}, {KInt32(3)}}));
+    EXPECT_FALSE(table.insertRows({{KInt32(2)}, {"x", "y"}}, km::DataLayout::COLUMN_MAJOR));
+    EXPECT_EQ(table.rowCount(), 8);
+    EXPECT_NE(table.insertRow({KInt32(2), "two"}), km::INVALID_INDEX);
+    EXPECT_EQ(table.getDataWC(1, 1).asString(), "two");
+}
+
+TEST(Table, DropRows)
+{
+    km::Table table("expiry", {{"id", dt::INT32}, {"age", dt::INT32}});
+    std::vector<std::vector<km::Variant>> rows;
+    for (KInt32 i = 0; i < 100; ++i)
+        rows.push_back({i, i % 10});
+    ASSERT_TRUE(table.insertRows(rows));
+    table.setMaxFreeSpaceTolerance(1000);
+
+    EXPECT_FALSE(table.dropRows({1, 100})); // out of range, nothing dropped
+    EXPECT_EQ(table.rowCount(), 100);
+    EXPECT_TRUE(table.dropRows({5, 0, 5, 99}));
+    ASSERT_EQ(table.rowCount(), 97);
+    EXPECT_EQ(table.getDataWC(0, 0).asInt32(), 1);
+    EXPECT_EQ(table.getDataWC(3, 0).asInt32(), 4);
+    EXPECT_EQ(table.getDataWC(4, 0).asInt32(), 6);
+    EXPECT_EQ(table.getDataWC(96, 0).asInt32(), 98);
+
+    EXPECT_FALSE(table.dropWhere("isGreater($unknown, 1)"));
+    table.setMaxFreeSpaceTolerance(10);
+    EXPECT_TRUE(table.dropWhere("isGreaterOrEqual($age, 7)"));
+    EXPECT_EQ(table.rowCount(), 68);
+    EXPECT_TRUE(test_local::isSorted(&table, 0));
+    for (IndexType row = 0; row < table.rowCount(); ++row)
+        EXPECT_LT(table.getDataWC(row, 1).asInt32(), 7);
+    EXPECT_NE(table.insertRow({KInt32(7), KInt32(0)}), km::INVALID_INDEX); // after free space
+    EXPECT_EQ(table.rowCount(), 69);
+}
+
+TEST(Table, RowIndexTree)
+{
+    km::Table flat("flat", {{"key", dt::INT32}, {"value", dt::INT64}});
+    km::Table tree("tree", {{"key", dt::INT32}, {"value", dt::INT64}});
+    tree.setRowIndexKind(km::RowIndexKind::TREE);
+    EXPECT_TRUE(tree.getRowIndexKind() == km::RowIndexKind::TREE);
+
+    std::mt19937 rng(11);
+    for (KInt64 i = 0; i < 5000; ++i)
+    {
+        const KInt32 key = static_cast<KInt32>(rng() % 1000);
+        ASSERT_EQ(tree.insertRow({key, i}), flat.insertRow({key, i}));
+        if (i % 3 == 0)
+        {
+            const IndexType row = rng() % flat.rowCount();
+            ASSERT_TRUE(tree.dropRow(row));
+            ASSERT_TRUE(flat.dropRow(row));
+        }
+    }
+    ASSERT_TRUE(tree.insertRows({{KInt32(5), KInt64(-1)}, {KInt32(999), KInt64(-2)}}));
+    ASSERT_TRUE(flat.insertRows({{KInt32(5), KInt64(-1)}, {KInt32(999), KInt64(-2)}}));
+    ASSERT_TRUE(tree.dropWhere("isLess($key, 10)"));
+    ASSERT_TRUE(flat.dropWhere("isLess($key, 10)"));
+
+    ASSERT_EQ(tree.rowCount(), flat.rowCount());
+    for (IndexType row = 0; row < flat.rowCount(); ++row)
+        ASSERT_EQ(tree.getDataWC(row, 1).asInt64(), flat.getDataWC(row, 1).asInt64());
+    EXPECT_EQ(tree.searchInKeyColumn(KInt32(500)), flat.searchInKeyColumn(KInt32(500)));
+    EXPECT_EQ(tree.search("value", KInt64(-2)), flat.search("value", KInt64(-2)));
+
+    tree.setRowIndexKind(km::RowIndexKind::VECTOR);
+    EXPECT_TRUE(test_local::isSorted(&tree, 0));
+    EXPECT_EQ(tree.getDataWC(0, 1).asInt64(), flat.getDataWC(0, 1).asInt64());
+}
+
+TEST(Table, HashIndex)
+{
+    km::Table table("orders", {{"id", dt::INT32}, {"customer", dt::STRING}, {"qty", dt::INT32}, {"price", dt::FLOAT64}});
+    std::vector<std::vector<km::Variant>> rows;
+    for (KInt32 i = 0; i < 300; ++i)
+        rows.push_back({i % 50, "c" + std::to_string(i % 17), i % 7, 1.5});
+    ASSERT_TRUE(table.insertRows(rows));
+    table.setMaxFreeSpaceTolerance(20);
+
+    EXPECT_FALSE(table.createIndex("unknown"));
+    EXPECT_FALSE(table.createIndex("id"));    // key column
+    EXPECT_FALSE(table.createIndex("price")); // float
+    ASSERT_TRUE(table.createIndex("customer", km::IndexKind::HASH));
+    ASSERT_TRUE(table.createIndex("qty"));
+    EXPECT_TRUE(table.hasIndex("customer"));
+
+    auto linear_search = [&table](IndexType column_index, const km::Variant &data)
+    {
+        std::vector<IndexType> result;
+        for (IndexType row = 0; row < table.rowCount(); ++row)
+            if (!table.isNull(row, column_index) && table.getDataWC(row, column_index).data() == data.data())
+                result.push_back(row);
+        return result;
+    };
+    auto check = [&]()
+    {
+        for (KInt32 c = 0; c < 18; ++c)
+            EXPECT_EQ(table.search("customer", "c" + std::to_string(c)), linear_search(1, "c" + std::to_string(c)));
+        for (KInt32 q = 0; q < 8; ++q)
+            EXPECT_EQ(table.search("qty", q), linear_search(2, q));
+    };
+    check();
+
+    EXPECT_NE(table.insertRow({KInt32(25), "c17", KInt32(3), 2.0}), km::INVALID_INDEX);
+    EXPECT_TRUE(table.dropRow(10));
+    EXPECT_TRUE(table.dropRows({0, 5, 6, 200}));
+    check();
+    EXPECT_NE(table.insertRow({KInt32(3), "c2", KInt32(1), 2.0}), km::INVALID_INDEX); // reuses free space
+    EXPECT_TRUE(table.setData(7, 1, "c5"));
+    EXPECT_TRUE(table.setNull(8, 2));
+    check();
+    EXPECT_TRUE(table.transformColumn("qty", "add($qty, 1)"));
+    check();
+    EXPECT_TRUE(table.dropWhere("isEqual($qty, 3)")); // frees space, physical indices change
+    check();
+
+    EXPECT_TRUE(table.dropIndex("qty"));
+    EXPECT_FALSE(table.hasIndex("qty"));
+    check();
+}
+
+TEST(Table, IndexOnDuplicateKeys)
+{
+    // key column has only a few distinct values, rows of index hits are found without scanning equal keys.
+    for (const km::RowIndexKind kind : {km::RowIndexKind::VECTOR, km::RowIndexKind::TREE})
+    {
+        km::Table table("events", {{"group", dt::INT32}, {"id", dt::INT32}});
+        table.setRowIndexKind(kind);
+        std::vector<std::vector<km::Variant>> rows;
+        for (KInt32 i = 0; i < 5000; ++i)
+            rows.push_back({i % 3, i});
+        ASSERT_TRUE(table.insertRows(rows));
+        ASSERT_TRUE(table.createIndex("id", km::IndexKind::HASH));
+
+        auto check = [&table](KInt32 id)
+        {
+            std::vector<IndexType> expected;
+            for (IndexType row = 0; row < table.rowCount(); ++row)
+                if (table.getDataWC(row, 1).asInt32() == id)
+                    expected.push_back(row);
+            EXPECT_EQ(table.search("id", id), expected) << id;
+        };
+        for (KInt32 id = 0; id < 5000; id += 7)
+            check(id);
+        EXPECT_TRUE(table.dropRows({0, 1, 2, 100, 2500}));
+        EXPECT_NE(table.insertRow({KInt32(1), KInt32(9999)}), km::INVALID_INDEX);
+        check(9999);
+        for (KInt32 id = 3; id < 5000; id += 11)
+            check(id);
+        table.pauseSorting();
+        EXPECT_NE(table.insertRow({KInt32(0), KInt32(7777)}), km::INVALID_INDEX);
+        check(7777);
+        table.resumeSorting();
+        check(7777);
+        check(9999);
+    }
+}
+
+TEST(Table, SearchRange)
+{
+    km::Table table("readings", {{"id", dt::INT32}, {"temp", dt::FLOAT64}, {"day", dt::DATE}});
+    for (KInt32 i = 0; i < 400; ++i)
+        table.insertRowN({i % 100, (i % 9 == 0) ? std::nullopt : std::optional<km::Variant>((i * 37 % 101) / 2.0), KDate{2022, 2, uint8_t(i % 28 + 1)}});
+    table.insertRowN({std::nullopt, 10.0, KDate{2022, 2, 1}});
+    table.setMaxFreeSpaceTolerance(30);
+
+    auto linear_range = [&table](IndexType column_index, double low, double high, bool low_inclusive, bool high_inclusive)
+    {
+        std::vector<IndexType> result;
+        for (IndexType row = 0; row < table.rowCount(); ++row)
+        {
+            if (table.isNull(row, column_index))
+                continue;
+            const double value = column_index ? table.getDataWC(row, column_index).asFloat64() : table.getDataWC(row, column_index).asInt32();
+            if ((low < value || (low_inclusive && low == value)) && (value < high || (high_inclusive && value == high)))
+                result.push_back(row);
+        }
+        return result;
+    };
+    auto check = [&]()
+    {
+        for (KInt32 low = -5; low < 110; low += 13)
+            for (bool low_inclusive : {true, false})
+                for (bool high_inclusive : {true, false})
+                {
+                    EXPECT_EQ(table.searchRange("id", low, low + 20, low_inclusive, high_inclusive), linear_range(0, low, low + 20, low_inclusive, high_inclusive));
+                    EXPECT_EQ(table.searchRange("temp", low / 2.0, low / 2.0 + 10, low_inclusive, high_inclusive),
+                              linear_range(1, low / 2.0, low / 2.0 + 10, low_inclusive, high_inclusive));
+                }
+    };
+    check(); // without index
+    EXPECT_TRUE(table.searchRange("id", 5, 1).empty());
+    EXPECT_TRUE(table.searchRange("id", 1.0, 5.0).empty()); // type mismatch
+    EXPECT_EQ(table.searchRange("day", KDate{2022, 2, 3}, KDate{2022, 2, 4}).size(), 30);
+
+    ASSERT_TRUE(table.createIndex("temp", km::IndexKind::ORDERED));
+    check();
+    EXPECT_TRUE(table.createIndex("day", km::IndexKind::ORDERED));
+    EXPECT_EQ(table.searchRange("day", KDate{2022, 2, 3}, KDate{2022, 2, 4}).size(), 30);
+    EXPECT_EQ(table.search("day", KDate{2022, 2, 3}).size(), 15);
+
+    EXPECT_TRUE(table.setData(3, 1, 20.0));
+    EXPECT_TRUE(table.setNull(4, 1));
+    EXPECT_NE(table.insertRow({KInt32(50), 21.0, KDate{2022, 3, 1}}), km::INVALID_INDEX);
+    EXPECT_TRUE(table.dropRows({0, 1, 2, 100}));
+    check();
+    EXPECT_TRUE(table.transformColumn("temp", "sub($temp, 3.0)"));
+    check();
+    EXPECT_TRUE(table.dropWhere("isLess($temp, 10.0)")); // frees space
+    check();
+
+    table.setNullOrder(km::NullOrder::LAST);
+    check();
+    km::Table descending("desc", {{"id", dt::INT32}}, km::SortingOrder::DESCENDING);
+    for (KInt32 i = 0; i < 50; ++i)
+        descending.insertRowN({(i % 7) ? std::optional<km::Variant>(i % 20) : std::nullopt});
+    EXPECT_EQ(descending.searchRange("id", 5, 8, true, false).size(), 8);
+    EXPECT_EQ(descending.searchRange("id", 5, 8, false, true).size(), 7);
+}
+
+TEST(Table, SortKeys)
+{
+    km::Table table("sales", {{"region", dt::STRING}, {"date", dt::DATE}, {"id", dt::INT32}});
+    std::mt19937 generator(7);
+    for (KInt32 i = 0; i < 500; ++i)
+        table.insertRow({"r" + std::to_string(generator() % 5), KDate{2022, 1, uint8_t(generator() % 10 + 1)}, KInt32(generator() % 1000)});
+
+    EXPECT_FALSE(table.setSortKeys({{"region"}}));
+    EXPECT_FALSE(table.setSortKeys({{"date"}, {"date"}}));
+    EXPECT_FALSE(table.setSortKeys({{"unknown"}}));
+    ASSERT_TRUE(table.setSortKeys({{"date", km::SortingOrder::DESCENDING}, {"id"}}));
+    ASSERT_EQ(table.getSortKeys().size(), 2);
+    EXPECT_EQ(table.getSortKeys()[0].column_name, "date");
+
+    auto is_ordered = [&table]()
+    {
+        for (IndexType row = 1; row < table.rowCount(); ++row)
+        {
+            auto previous = std::make_tuple(table.getDataWC(row - 1, 0).asString(), -km::integralRepresentationOf(table.getDataWC(row - 1, 1).asDate()),
+                                            table.getDataWC(row - 1, 2).asInt32());
+            auto current = std::make_tuple(table.getDataWC(row, 0).asString(), -km::integralRepresentationOf(table.getDataWC(row, 1).asDate()),
+                                           table.getDataWC(row, 2).asInt32());
+            if (current < previous)
+                return false;
+        }
+        return true;
+    };
+    EXPECT_TRUE(is_ordered());
+    for (KInt32 i = 0; i < 50; ++i)
+        table.insertRow({"r" + std::to_string(generator() % 5), KDate{2022, 1, uint8_t(generator() % 10 + 1)}, KInt32(generator() % 1000)});
+    EXPECT_TRUE(is_ordered());
+    EXPECT_EQ(table.search("region", "r3"), table.searchRange("region", "r3", "r3"));
+
+    EXPECT_FALSE(table.setData(0, 1, KDate{2022, 1, 1})); // sort key is not editable
+    EXPECT_FALSE(table.setNull(0, 2));
+    EXPECT_TRUE(table.transformColumn("id", "sub(0, $id)"));
+    EXPECT_TRUE(is_ordered());
+
+    EXPECT_TRUE(table.setSortKeys({}));
+    EXPECT_TRUE(table.setData(0, 2, KInt32(5)));
+}
+
+TEST(Table, ParallelSort)
+{
+    km::Table table("events", {{"time", dt::INT64}, {"seq", dt::INT32}}, km::SortingOrder::DESCENDING);
+    std::vector<std::vector<km::Variant>> rows;
+    std::mt19937 generator(5);
+    for (KInt32 i = 0; i < 100000; ++i)
+        rows.push_back({KInt64(generator() % 5000), i});
+    table.pauseSorting();
+    ASSERT_TRUE(table.insertRows(rows));
+    km::ThreadPool::instance().setThreadCount(4);
+    table.resumeSorting();
+
+    for (IndexType row = 1; row < table.rowCount(); ++row)
+    {
+        const KInt64 previous = table.getDataWC(row - 1, 0).asInt64(), current = table.getDataWC(row, 0).asInt64();
+        ASSERT_GE(previous, current);
+        if (previous == current) // stable
+        {
+            ASSERT_LT(table.getDataWC(row - 1, 1).asInt32(), table.getDataWC(row, 1).asInt32());
+        }
+    }
+    km::BasicView view("by_seq", &table, {"seq", "time"});
+    EXPECT_TRUE(test_local::isSorted(&view, 0));
+    km::ThreadPool::instance().setThreadCount(0);
+}
+
+TEST(Table, RadixSort)
+{
+    // radix sort must give the same order as the comparison sort, including nulls and ties.
+    std::mt19937 generator(21);
+    std::vector<std::vector<std::optional<km::Variant>>> rows;
+    for (KInt32 i = 0; i < 20000; ++i)
+    {
+        std::optional<km::Variant> price;
+        if (i % 11 != 0)
+            price = KFloat64(int(generator() % 4000) - 2000) / 8;
+        rows.push_back({price, KDate{uint16_t(2000 + generator() % 30), uint8_t(1 + generator() % 12), uint8_t(1 + generator() % 28)}, i});
+    }
+    auto expect_sorted = [](const km::AbstractTable *table, IndexType column, bool descending, bool nulls_first)
+    {
+        for (IndexType row = 1; row < table->rowCount(); ++row)
+        {
+            const bool null1 = table->isNull(row - 1, column), null2 = table->isNull(row, column);
+            if (null1 != null2)
+            {
+                ASSERT_EQ(null1, nulls_first) << row;
+                continue;
+            }
+            const bool tie = null1 || !(table->isLess(row - 1, row, column) || table->isLess(row, row - 1, column));
+            if (tie) // stable
+                ASSERT_LT(table->getDataWC(row - 1, 2).asInt32(), table->getDataWC(row, 2).asInt32()) << row;
+            else
+                ASSERT_EQ(table->isLess(row - 1, row, column), !descending) << row;
+        }
+    };
+
+    km::Table table("orders", {{"price", dt::FLOAT64}, {"date", dt::DATE}, {"id", dt::INT32}}, km::SortingOrder::DESCENDING);
+    table.pauseSorting();
+    for (const auto &row : rows)
+        ASSERT_NE(table.insertRowN(row), km::INVALID_INDEX);
+    table.resumeSorting();
+    expect_sorted(&table, 0, true, true);
+    table.setNullOrder(km::NullOrder::LAST);
+    expect_sorted(&table, 0, true, false);
+
+    // view over a date column, ties keep the order of the table.
+    std::vector<IndexType> position_of(rows.size());
+    for (IndexType row = 0; row < table.rowCount(); ++row)
+        position_of[table.getDataWC(row, 2).asInt32()] = row;
+    km::BasicView view("by_date", &table, {"date", "price", "id"}, "", "date");
+    for (IndexType row = 1; row < view.rowCount(); ++row)
+    {
+        ASSERT_FALSE(view.isLess(row, row - 1, 0)) << row;
+        if (!view.isLess(row - 1, row, 0))
+        {
+            ASSERT_LT(position_of[view.getDataWC(row - 1, 2).asInt32()], position_of[view.getDataWC(row, 2).asInt32()]) << row;
+        }
+    }
+}
+
+TEST(Table, MergeOnResume)
+{
+    km::Table table("trades", {{"price", dt::INT32}, {"id", dt::INT32}});
+    std::mt19937 generator(8);
+    KInt32 id = 0;
+    for (; id < 3000; ++id)
+        ASSERT_NE(table.insertRow({KInt32(generator() % 500), id}), km::INVALID_INDEX);
+    km::BasicView cheap("cheap", &table, {"id", "price"}, "isLess($price, 100)", "id");
+
+    auto expect_merged = [&table]()
+    {
+        for (IndexType row = 1; row < table.rowCount(); ++row)
+        {
+            const KInt32 previous = table.getDataWC(row - 1, 0).asInt32(), current = table.getDataWC(row, 0).asInt32();
+            ASSERT_LE(previous, current) << row;
+            if (previous == current) // appended rows come after existing equal rows
+            {
+                ASSERT_LT(table.getDataWC(row - 1, 1).asInt32(), table.getDataWC(row, 1).asInt32()) << row;
+            }
+        }
+    };
+    auto expect_view = [&table, &cheap]()
+    {
+        km::BasicView fresh("fresh", &table, {"id", "price"}, "isLess($price, 100)", "id");
+        ASSERT_EQ(cheap.rowCount(), fresh.rowCount());
+        for (IndexType row = 0; row < fresh.rowCount(); ++row)
+            ASSERT_EQ(cheap.getDataWC(row, 0).asInt32(), fresh.getDataWC(row, 0).asInt32()) << row;
+    };
+
+    // only appended rows, they are merged and the view gets them as insertions.
+    table.pauseSorting();
+    for (KInt32 i = 0; i < 200; ++i, ++id)
+        ASSERT_NE(table.insertRow({KInt32(generator() % 500), id}), km::INVALID_INDEX);
+    std::vector<std::vector<km::Variant>> rows;
+    for (KInt32 i = 0; i < 2000; ++i, ++id)
+        rows.push_back({KInt32(generator() % 500), id});
+    ASSERT_TRUE(table.insertRows(rows));
+    table.resumeSorting();
+    EXPECT_EQ(table.rowCount(), 5200);
+    expect_merged();
+    expect_view();
+
+    // a drop while paused is missed by the view, so everything is sorted and refreshed.
+    table.pauseSorting();
+    ASSERT_TRUE(table.dropRow(10));
+    for (KInt32 i = 0; i < 50; ++i, ++id)
+        ASSERT_NE(table.insertRow({KInt32(generator() % 500), id}), km::INVALID_INDEX);
+    table.resumeSorting();
+    EXPECT_EQ(table.rowCount(), 5249);
+    expect_merged();
+    expect_view();
+
+    // nothing inserted.
+    table.pauseSorting();
+    table.resumeSorting();
+    expect_merged();
+    expect_view();
+}
+
+TEST(Table, TypedInsertion)
+{
+    km::Table table("people", {{"name", dt::STRING},
+                               {"city", dt::STRING, km::ColumnStorage::DICTIONARY},
+                               {"note", dt::STRING, km::ColumnStorage::ARENA},
+                               {"age", dt::INT32, km::ColumnStorage::CHUNKED},
+                               {"born", dt::DATE},
+                               {"active", dt::BOOLEAN},
+                               {"score", dt::FLOAT64}});
+    std::string name = "Keshav";
+    EXPECT_EQ(table.insertRowT(std::move(name), "Delhi", "first", 25, KDate{1997, 3, 12}, true, 84.5), 0);
+    EXPECT_EQ(table.insertRowT("Adil", std::string("Pune"), "", KInt32(18), KDate{2004, 7, 1}, false, 81.25), 0);
+    // type or count mismatch, nothing is inserted.
+    EXPECT_EQ(table.insertRowT("Jack", "Agra", "", KInt64(26), KDate{1996, 1, 1}, true, 80.0), km::INVALID_INDEX);
+    EXPECT_EQ(table.insertRowT("Jack", "Agra"), km::INVALID_INDEX);
+    ASSERT_EQ(table.rowCount(), 2);
+    EXPECT_EQ(table.getDataWC(1, 0).asString(), "Keshav");
+    EXPECT_EQ(table.getDataWC(1, 1).asString(), "Delhi");
+    EXPECT_EQ(table.getDataWC(1, 2).asString(), "first");
+    EXPECT_EQ(table.getDataWC(0, 3).asInt32(), 18);
+    EXPECT_EQ(integralRepresentationOf(table.getDataWC(0, 4).asDate()), 20040701);
+    EXPECT_FALSE(table.getDataWC(0, 5).asBoolean());
+    EXPECT_DOUBLE_EQ(table.getDataWC(1, 6).asFloat64(), 84.5);
+
+    // moved Variants, including into a freed row.
+    std::vector<km::Variant> row{std::string(100, 'z'), "Agra", "moved", 40, KDate{1982, 5, 9}, true, 1.5};
+    EXPECT_EQ(table.insertRow(std::move(row)), 2);
+    EXPECT_EQ(table.getDataWC(2, 0).asString(), std::string(100, 'z'));
+    ASSERT_TRUE(table.dropRow(0));
+    EXPECT_EQ(table.insertRowT("Aarati", "Pune", "", 30, KDate{1992, 2, 2}, true, 90.0), 0);
+    EXPECT_EQ(table.rowCount(), 3);
+    EXPECT_EQ(table.getDataWC(0, 1).asString(), "Pune");
+    EXPECT_EQ(table.getDataWC(0, 3).asInt32(), 30);
+    EXPECT_TRUE(table.search("city", km::Variant("Pune")).size() == 1);
+}
+
+TEST(Table, IncrementalCompaction)
+{
+    km::Table table("log", {{"time", dt::INT64}, {"msg", dt::STRING, km::ColumnStorage::ARENA}, {"level", dt::INT32}});
+    ASSERT_TRUE(table.createIndex("level", km::IndexKind::HASH));
+    table.setMaxFreeSpaceTolerance(50);
+    table.setCompactionMode(km::CompactionMode::INCREMENTAL, 8);
+    EXPECT_EQ(table.getCompactionMode(), km::CompactionMode::INCREMENTAL);
+    for (KInt64 i = 0; i < 1000; ++i)
+        ASSERT_NE(table.insertRow({i, "message " + std::to_string(i), KInt32(i % 7)}), km::INVALID_INDEX);
+    km::BasicView errors("errors", &table, {"time", "msg"}, "isEqual($level, 3)");
+    const SizeType error_count = errors.rowCount();
+
+    // drop every third row, free rows never reach the tolerance as each drop reclaims a slice.
+    SizeType dropped_errors = 0;
+    for (IndexType row = table.rowCount(); row-- > 0;)
+    {
+        if (row % 3 == 0)
+        {
+            dropped_errors += (table.getDataWC(row, 2).asInt32() == 3);
+            ASSERT_TRUE(table.dropRow(row));
+            ASSERT_LT(table.getFragmentationStats().free_row_count, 50);
+        }
+    }
+    EXPECT_EQ(table.rowCount(), 666);
+    EXPECT_EQ(errors.rowCount(), error_count - dropped_errors);
+
+    // rows keep their order and data, the index follows the moved rows.
+    auto expect_consistent = [&table]()
+    {
+        for (IndexType row = 0; row < table.rowCount(); ++row)
+        {
+            const KInt64 time = table.getDataWC(row, 0).asInt64();
+            ASSERT_EQ(table.getDataWC(row, 1).asString(), "message " + std::to_string(time));
+            ASSERT_EQ(table.getDataWC(row, 2).asInt32(), KInt32(time % 7));
+        }
+        for (KInt32 level = 0; level < 7; ++level)
+        {
+            const std::vector<IndexType> rows = table.search("level", level);
+            SizeType expected = 0;
+            for (IndexType row = 0; row < table.rowCount(); ++row)
+                expected += (table.getDataWC(row, 2).asInt32() == level);
+            ASSERT_EQ(rows.size(), expected);
+            for (IndexType row : rows)
+                ASSERT_EQ(table.getDataWC(row, 2).asInt32(), level);
+        }
+    };
+    expect_consistent();
+    EXPECT_TRUE(test_local::isSorted(&table, 0));
+
+    // deferred, only compact() reclaims. Tree row index is updated in place.
+    table.setCompactionMode(km::CompactionMode::DEFERRED);
+    table.setRowIndexKind(km::RowIndexKind::TREE);
+    for (IndexType row = 0; row < 100; ++row)
+        ASSERT_TRUE(table.dropRow(row));
+    km::FragmentationStats stats = table.getFragmentationStats();
+    EXPECT_GE(stats.free_row_count, 100);
+    EXPECT_GT(stats.fragmentation, 0.0);
+    while (!table.compact(16))
+        ;
+    stats = table.getFragmentationStats();
+    EXPECT_EQ(stats.row_count, 566);
+    EXPECT_EQ(stats.free_row_count, 0);
+    EXPECT_EQ(stats.fragmentation, 0.0);
+    expect_consistent();
+    EXPECT_EQ(table.insertRow({KInt64(5000), "late", 3}), 566);
+    EXPECT_EQ(table.search("level", KInt32(3)).size(), errors.rowCount());
+}
+
+TEST(Table, UpsertAndMerge)
+{
+    km::Table table("prices", {{"id", dt::INT32}, {"name", dt::STRING}, {"price", dt::FLOAT64}});
+    for (KInt32 id = 0; id < 100; id += 2)
+        ASSERT_NE(table.insertRow({id, "item " + std::to_string(id), 10.0}), km::INVALID_INDEX);
+    km::BasicView cheap("cheap", &table, {"id", "price"}, "isLess($price, 5.0)");
+    EXPECT_EQ(cheap.rowCount(), 0);
+
+    // update keeps the position, a new key is inserted.
+    EXPECT_EQ(table.upsert({KInt32(10), "item 10", 2.5}), 5);
+    EXPECT_EQ(table.getDataWC(5, 2).asFloat64(), 2.5);
+    EXPECT_EQ(cheap.rowCount(), 1);
+    EXPECT_EQ(table.upsert({KInt32(11), "item 11", 1.0}), 6);
+    EXPECT_EQ(table.rowCount(), 51);
+    EXPECT_EQ(cheap.rowCount(), 2);
+    EXPECT_EQ(table.upsert({KInt32(11), "item 11"}), km::INVALID_INDEX);
+    EXPECT_EQ(table.upsert({KInt64(11), "item 11", 1.0}), km::INVALID_INDEX);
+
+    // batch: unsorted, duplicate keys (last wins), updates and inserts.
+    std::vector<std::vector<km::Variant>> rows;
+    for (KInt32 id = 99; id >= 0; id -= 3)
+        rows.push_back({id, "item " + std::to_string(id), 1.0 * id});
+    rows.push_back({KInt32(0), "zero", 0.5});
+    ASSERT_TRUE(table.mergeFrom(rows));
+    EXPECT_TRUE(test_local::isSorted(&table, 0));
+    EXPECT_EQ(table.search("id", KInt32(0)).size(), 1);
+    EXPECT_EQ(table.getDataWC(0, 1).asString(), "zero");
+    for (KInt32 id = 0; id < 100; ++id)
+    {
+        const std::vector<IndexType> found = table.search("id", id);
+        const bool exists = (id % 2 == 0 || id % 3 == 0 || id == 11);
+        ASSERT_EQ(found.size(), exists ? 1 : 0) << id;
+        if (id % 3 == 0 && id)
+        {
+            EXPECT_EQ(table.getDataWC(found.front(), 2).asFloat64(), 1.0 * id);
+        }
+    }
+    SizeType expected_cheap = 0;
+    for (IndexType row = 0; row < table.rowCount(); ++row)
+        expected_cheap += (table.getDataWC(row, 2).asFloat64() < 5.0);
+    EXPECT_EQ(cheap.rowCount(), expected_cheap);
+
+    // invalid batch changes nothing.
+    const SizeType row_count = table.rowCount();
+    EXPECT_FALSE(table.mergeFrom({{KInt32(1000), "new", 1.0}, {KInt32(1), "bad"}}));
+    EXPECT_EQ(table.rowCount(), row_count);
+
+    // changed sort key moves the row.
+    ASSERT_TRUE(table.setSortKeys({{"price"}}));
+    EXPECT_NE(table.upsert({KInt32(11), "item 11", 7.0}), km::INVALID_INDEX);
+    EXPECT_EQ(table.rowCount(), row_count);
+    EXPECT_EQ(table.getDataWC(table.search("id", KInt32(11)).front(), 2).asFloat64(), 7.0);
+    ASSERT_TRUE(table.setSortKeys({}));
+
+    // merge from a table copies nulls, a null key is always inserted.
+    km::Table delta("delta", {{"id", dt::INT32}, {"name", dt::STRING}, {"price", dt::FLOAT64}});
+    delta.insertRowN({KInt32(4), std::nullopt, 3.0});
+    delta.insertRowN({std::nullopt, "unknown", 1.0});
+    km::Table other("other", {{"id", dt::INT32}, {"name", dt::STRING}});
+    EXPECT_FALSE(table.mergeFrom(other));
+    ASSERT_TRUE(table.mergeFrom(delta));
+    EXPECT_EQ(table.rowCount(), row_count + 1);
+    const IndexType row = table.search("id", KInt32(4)).front();
+    EXPECT_TRUE(table.isNull(row, 1));
+    EXPECT_EQ(table.getDataWC(row, 2).asFloat64(), 3.0);
+
+    // new rows with nulls are inserted in the same batch as the others.
+    km::Table new_rows("new_rows", {{"id", dt::INT32}, {"name", dt::STRING}, {"price", dt::FLOAT64}});
+    new_rows.insertRowN({KInt32(201), std::nullopt, 1.5});
+    new_rows.insertRowN({KInt32(200), "item 200", std::nullopt});
+    new_rows.insertRowN({KInt32(-1), "first", 0.25});
+    new_rows.insertRowN({std::nullopt, std::nullopt, 2.0});
+    ASSERT_TRUE(table.mergeFrom(new_rows));
+    EXPECT_EQ(table.rowCount(), row_count + 5);
+    IndexType first_key = 0; // null keys are first
+    while (first_key < table.rowCount() && table.isNull(first_key, 0))
+        ++first_key;
+    EXPECT_EQ(first_key, 2);
+    for (IndexType row_index = first_key + 1; row_index < table.rowCount(); ++row_index)
+        ASSERT_LE(table.getDataWC(row_index - 1, 0).asInt32(), table.getDataWC(row_index, 0).asInt32());
+    EXPECT_TRUE(table.isNull(table.search("id", KInt32(201)).front(), 1));
+    EXPECT_TRUE(table.isNull(table.search("id", KInt32(200)).front(), 2));
+    EXPECT_EQ(table.getDataWC(table.search("id", KInt32(-1)).front(), 1).asString(), "first");
+    expected_cheap = 0;
+    for (IndexType row_index = 0; row_index < table.rowCount(); ++row_index)
+        expected_cheap += (!table.isNull(row_index, 2) && table.getDataWC(row_index, 2).asFloat64() < 5.0);
+    EXPECT_EQ(cheap.rowCount(), expected_cheap);
+
+    table.pauseSorting();
+    EXPECT_EQ(table.upsert({KInt32(4), "item 4", 3.0}), km::INVALID_INDEX);
+    EXPECT_FALSE(table.mergeFrom(delta));
+    table.resumeSorting();
+}
+
+TEST(Table, CompiledFormula)
+{
+    km::Table table("mixed", {{"a", dt::INT32},
+                              {"b", dt::INT64, km::ColumnStorage::CHUNKED},
+                              {"f", dt::FLOAT32},
+                              {"d", dt::FLOAT64, km::ColumnStorage::CHUNKED},
+                              {"flag", dt::BOOLEAN},
+                              {"name", dt::STRING, km::ColumnStorage::DICTIONARY}});
+    std::vector<std::vector<km::Variant>> rows;
+    std::mt19937 generator(25);
+    for (KInt32 i = 0; i < 20000; ++i)
+        rows.push_back({KInt32(generator() % 1000), KInt64(generator() % 1000) - 200, (generator() % 100) * 0.25f,
+                        0.5 + (generator() % 1000) * 0.125, generator() % 2 == 0, "n" + std::to_string(generator() % 20)});
+    ASSERT_TRUE(table.insertRows(rows));
+    ASSERT_TRUE(table.setSortKeys({{"b"}})); // rows are read through the row index, sorted by a and b
+
+    // bulk evaluation runs compiled formulas, single row evaluation runs the tokens on Variants.
+    const std::vector<std::pair<std::string, dt>> formulas{
+        {"add($a, mul($a, 3))", dt::INT32},
+        {"intDiv($a, sub($a, $a))", dt::INT32},
+        {"divide($a, 7)", dt::FLOAT32},
+        {"div($b, 3L)", dt::FLOAT64},
+        {"mod($d, 3.0)", dt::FLOAT64},
+        {"toInt64(mul($f, $f))", dt::INT64},
+        {"IF($flag, $a, intDiv($a, 2))", dt::INT32},
+        {"IF(isInRange($d, 10.0, 50.0), length($name), toInt32($b))", dt::INT32},
+        {"toBoolean(mod($a, 3))", dt::BOOLEAN},
+        {"add($name, toString($a))", dt::STRING},
+        {"toInt32(toBoolean($b))", dt::INT32},
+        {"add(toFloat32(2.5), $f)", dt::FLOAT32}};
+    for (const auto &[formula, type] : formulas)
+    {
+        km::parse::TokenContainer tokens;
+        ASSERT_TRUE(km::parse::getCheckedToken(formula, tokens, &table, type)) << formula;
+        ASSERT_TRUE(table.addColumnE({"r" + std::to_string(table.columnCount()), type}, formula)) << formula;
+        const IndexType column = table.columnCount() - 1;
+        for (IndexType row = 0; row < table.rowCount(); ++row)
+        {
+            const km::Variant expected = km::parse::evaluateFormula(tokens, &table, row), actual = table.getDataWC(row, column);
+            ASSERT_TRUE(km::isEqualComparatorFor(type)(expected, actual)) << formula << ", " << row;
+        }
+    }
+
+    const std::vector<std::string> conditions{
+        "AND(isLess($a, 500), NOT($flag))",
+        "OR(XOR($flag, isGreaterOrEqual($f, toFloat32(2.5))), isEqual(length($name), 3))",
+        "isInRange($b, 100L, 900L)",
+        "isEqual(toInt64($a), $b)",
+        "isLess($d, 60.0)"};
+    for (const std::string &condition : conditions)
+    {
+        km::parse::TokenContainer tokens;
+        ASSERT_TRUE(km::parse::getCheckedToken(condition, tokens, &table, dt::BOOLEAN)) << condition;
+        std::vector<IndexType> found, expected;
+        ASSERT_TRUE(km::parse::filter(condition, found, &table)) << condition;
+        for (IndexType row = 0; row < table.rowCount(); ++row)
+            if (km::parse::filter(tokens, &table, row))
+                expected.push_back(row);
+        EXPECT_EQ(found, expected) << condition;
+    }
+}
@@ -39,3 +39,76 @@ TEST(TableIO, TableIO)
         }
     }
 }
+
+TEST(TableIO, ColumnStorage)
+{
+    using dt = km::DataType;
+    km::Table table("storages", {{"id", dt::INT32},
+                                 {"status", "Status", dt::STRING, km::ColumnStorage::DICTIONARY},
+                                 {"email", "Email", dt::STRING, km::ColumnStorage::ARENA},
+                                 {"amount", dt::INT64, km::ColumnStorage::CHUNKED},
+                                 {"price", dt::FLOAT64, km::ColumnStorage::CHUNKED},
+                                 {"day", dt::DATE, km::ColumnStorage::CHUNKED}});
+    for (km::tp::KInt32 i = 0; i < 50; ++i)
+        ASSERT_NE(table.insertRow({i, i % 3 ? "open" : "closed", "user" + std::to_string(i) + "@mail.com", km::tp::KInt64(i) * 1000,
+                                   i * 0.5, km::tp::KDate{2022, 2, static_cast<uint8_t>(i % 28 + 1)}}),
+                  km::INVALID_INDEX);
+    std::filesystem::create_directory("table_dir");
+    ASSERT_TRUE(km::writeTableTo(&table, "table_dir"));
+
+    std::unique_ptr<km::Table> tmp_table(km::readTableFrom("storages", "table_dir"));
+    ASSERT_TRUE(static_cast<bool>(tmp_table));
+    ASSERT_EQ(table.rowCount(), tmp_table->rowCount());
+    for (km::IndexType c = 0, c_count = table.columnCount(); c < c_count; ++c)
+    {
+        EXPECT_EQ(table.getColumnMetaData(c).storage, tmp_table->getColumnMetaData(c).storage);
+        auto comp = km::isEqualComparatorFor(table.getColumnMetaData(c).data_type);
+        for (km::IndexType r = 0, r_count = table.rowCount(); r < r_count; ++r)
+            EXPECT_TRUE(comp(table.getDataWC(r, c), tmp_table->getDataWC(r, c)));
+    }
+}
+
+TEST(TableIO, Nulls)
+{
+    using dt = km::DataType;
+    km::Table table("nulls", {{"id", dt::INT32},
+                              {"name", dt::STRING},
+                              {"status", "Status", dt::STRING, km::ColumnStorage::DICTIONARY},
+                              {"amount", dt::INT64, km::ColumnStorage::CHUNKED},
+                              {"day", dt::DATE}});
+    table.setNullOrder(km::NullOrder::LAST);
+    for (km::tp::KInt32 i = 0; i < 100; ++i)
+    {
+        std::vector<std::optional<km::Variant>> row{i, "name" + std::to_string(i), i % 2 ? "open" : "closed",
+                                                    km::tp::KInt64(i) * 10, km::tp::KDate{2022, 3, static_cast<uint8_t>(i % 28 + 1)}};
+        // every column gets nulls, also the key column so they are placed last.
+        for (std::size_t c = 0; c < row.size(); ++c)
+        {
+            if (i % (c + 3) == 0)
+                row[c] = std::nullopt;
+        }
+        ASSERT_NE(table.insertRowN(row), km::INVALID_INDEX);
+    }
+    std::filesystem::create_directory("table_dir");
+    ASSERT_TRUE(km::writeTableTo(&table, "table_dir"));
+
+    std::unique_ptr<km::Table> tmp_table(km::readTableFrom("nulls", "table_dir"));
+    ASSERT_TRUE(static_cast<bool>(tmp_table));
+    EXPECT_EQ(tmp_table->getNullOrder(), km::NullOrder::LAST);
+    ASSERT_EQ(table.rowCount(), tmp_table->rowCount());
+    for (km::IndexType c = 0, c_count = table.columnCount(); c < c_count; ++c)
+    {
+        auto comp = km::isEqualComparatorFor(table.getColumnMetaData(c).data_type);
+        for (km::IndexType r = 0, r_count = table.rowCount(); r < r_count; ++r)
+        {
+            ASSERT_EQ(table.isNull(r, c), tmp_table->isNull(r, c));
+            if (!table.isNull(r, c))
+            {
+                EXPECT_TRUE(comp(table.getDataWC(r, c), tmp_table->getDataWC(r, c)));
+            }
+        }
+    }
+    // rows with null key are last, and the other columns stay with their rows.
+    EXPECT_TRUE(tmp_table->isNull(tmp_table->rowCount() - 1, 0));
+    EXPECT_FALSE(tmp_table->isNull(0, 0));
+}